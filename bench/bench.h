@@ -0,0 +1,52 @@
+/**
+  ******************************************************************************
+  * @file    bench.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Definitions shared by the benchmark firmware (bench_firmware.c) and the
+  *          simavr runner (bench_runner.c)
+  * @note	 The firmware reports the progress by writing a marker to GPIOR0. The
+  *			 runner timestamps every marker with the simulator cycle counter, so the
+  *			 measurements are cycle accurate and cost nothing to the firmware (one out).
+  ******************************************************************************
+  */
+
+#ifndef __BENCH_H
+#define __BENCH_H
+
+/* Defines -------------------------------------------------------------------*/
+#define BENCH_MARKER_ADDRESS		0x3E		// GPIOR0 in the data space
+#define BENCH_STUB_DONE_ADDRESS		0x4A		// GPIOR1, set to 1 by the runner's I2C slave on the stop condition
+
+#define BENCH_USART_BAUDRATE		1000000		// F_CPU / 16, UBRR = 0
+#define BENCH_USART_TX_BYTES		64
+#define BENCH_USART_RX_BYTES		48			// last one is the carriage return, fits the 64 byte input FIFO of simavr
+#define BENCH_PRINT_NUMBERS			16
+#define BENCH_GPIO_TOGGLES			1000
+#define BENCH_I2C_SLAVE_ADDRESS		0x39
+#define BENCH_I2C_DATA				"BENCH"
+
+//Interrupt vector numbers of the atmega644p
+#define BENCH_USART0_RX_VECTOR		20
+#define BENCH_TWI_VECTOR			26
+
+/* Typedefs and structure ----------------------------------------------------*/
+typedef enum
+{
+	eBENCH_START = 0x01,
+	eBENCH_USART_TX_START,
+	eBENCH_USART_TX_END,
+	eBENCH_USART_RX_START,		// runner starts to send the bytes on this marker
+	eBENCH_USART_RX_END,
+	eBENCH_PRINT_START,
+	eBENCH_PRINT_END,
+	eBENCH_I2C_START,
+	eBENCH_I2C_END,
+	eBENCH_GPIO_START,
+	eBENCH_GPIO_END,
+	eBENCH_DONE,
+	eBENCH_MARKER_COUNT
+}BenchMarkerType;
+
+#endif // __BENCH_H
@@ -0,0 +1,102 @@
+/**
+  ******************************************************************************
+  * @file    bench_firmware.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Firmware of the cycle benchmark. It exercises the hot paths of the
+  *			 drivers one after the other, between two markers (see bench.h):
+  *			 + USART_PutChar()    : BENCH_USART_TX_BYTES bytes
+  *			 + USART0RX_IRQHandler: BENCH_USART_RX_BYTES bytes sent by the runner
+  *			 + print()            : BENCH_PRINT_NUMBERS decimal and hex numbers
+  *			 + I2C_IRQHandler     : master transmit of BENCH_I2C_DATA to the runner's slave
+  *			 + GPIO_Write()       : BENCH_GPIO_TOGGLES set/reset pairs
+  * @note	 Only meant to be run by bench_runner under simavr (make bench).
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "atmega644p_gpio.h"
+#include "atmega644p_usart.h"
+#include "atmega644p_i2c.h"
+#include "printf_code.h"
+#include "bench.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define BENCH_MARK(marker)		(GPIOR0 = (marker))
+
+/*---------------------------------- Function and Hooks ----------------------------------*/
+
+int main(void)
+{
+	USART_StructureType usart;
+	I2C_StructureType i2c;
+	uint16_t index;
+
+	BENCH_MARK(eBENCH_START);
+
+	usart.USART_BaudRate = BENCH_USART_BAUDRATE;
+	usart.USART_Communication = BOTH;
+	usart.USART_DataBits = EIGHT;
+	usart.USART_Modes = ASYNCHRONOUS;
+	usart.USART_Parity = NOPARITY;
+	usart.USART_StopBits = ONESTOPBIT;
+	USARTInit(USART0, usart);
+
+	//USART transmit
+	BENCH_MARK(eBENCH_USART_TX_START);
+	for(index = 0; index < BENCH_USART_TX_BYTES; index++)
+		USART_PutChar('A' + (index & 0x0F));
+	while(!(UCSR0A & TRANSMIT_COMPLETE_FLAG))
+		; //Wait for the last stop bit
+	BENCH_MARK(eBENCH_USART_TX_END);
+
+	//USART receive, the runner sends the bytes once the marker is seen
+	USART_EnableInterrupt(RECEIVE);
+	BENCH_MARK(eBENCH_USART_RX_START);
+	while(gReceive_Buffer_Full == 0)
+		;
+	BENCH_MARK(eBENCH_USART_RX_END);
+	USART_FlushReceiveBuffer();
+
+	//Formatted numbers
+	BENCH_MARK(eBENCH_PRINT_START);
+	for(index = 0; index < (BENCH_PRINT_NUMBERS / 2); index++)
+	{
+		print("%d", (int32_t)(-1234567L * (index + 1)));
+		print("%x", (uint32_t)(0x89ABCDEFUL >> index));
+	}
+	while(!(UCSR0A & DATA_REGISTER_EMPTY_FLAG))
+		;
+	BENCH_MARK(eBENCH_PRINT_END);
+
+	//TWI master transmit, the runner's slave acknowledges everything
+	I2C_InitStructureDefault(&i2c);
+	I2CInit(&i2c);
+	I2C_UpdateSlaveAddress(BENCH_I2C_SLAVE_ADDRESS);
+	I2C_TransmitBufferFill(BENCH_I2C_DATA);
+	GPIOR1 = 0;
+	BENCH_MARK(eBENCH_I2C_START);
+	I2C_StartCommunication();
+	while(GPIOR1 == 0)
+		; //The runner's slave sets GPIOR1 once the stop condition is on the bus
+	BENCH_MARK(eBENCH_I2C_END);
+
+	//GPIO toggle rate
+	GPIO_Config(GPIOB, PIN_ZERO, OUTPUT);
+	BENCH_MARK(eBENCH_GPIO_START);
+	for(index = 0; index < BENCH_GPIO_TOGGLES; index++)
+	{
+		GPIO_Write(GPIOB, PIN_ZERO, GPIO_PIN_SET);
+		GPIO_Write(GPIOB, PIN_ZERO, GPIO_PIN_RESET);
+	}
+	BENCH_MARK(eBENCH_GPIO_END);
+
+	BENCH_MARK(eBENCH_DONE);
+	cli();
+	while(1)
+		;
+	return 0;
+}
@@ -0,0 +1,291 @@
+/**
+  ******************************************************************************
+  * @file    bench_runner.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Runs the benchmark firmware in simavr and writes the results as JSON
+  *			 + cycles per byte for USART transmit (USART_PutChar) and receive (RX ISR)
+  *			 + cycles per formatted number (print)
+  *			 + TWI ISR latency (flag to ISR entry) and duration (entry to reti)
+  *			 + GPIO toggle rate (GPIO_Write set + reset)
+  * @note	 Usage: bench_runner <firmware.elf> <results.json>
+  *			 The firmware marks its progress in GPIOR0 (see bench.h). The runner also
+  *			 provides the local peripheral stubs: the sender of the USART0 receive
+  *			 bytes and an I2C slave which acknowledges every byte.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_io.h"
+#include "sim_irq.h"
+#include "sim_interrupts.h"
+#include "avr_uart.h"
+#include "avr_twi.h"
+#include "bench.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define BENCH_MCU				"atmega644p"
+#define BENCH_MAX_CYCLES		200000000ULL	// Stop a firmware which never reaches eBENCH_DONE
+
+/* Typedefs and structure ----------------------------------------------------*/
+typedef struct
+{
+	avr_cycle_count_t	Pending;		// cycle at which the interrupt flag has been raised
+	avr_cycle_count_t	Entry;			// cycle at which the vector has been taken
+	uint32_t			Count;
+	uint64_t			LatencySum;
+	uint64_t			LatencyMax;
+	uint64_t			DurationSum;
+	uint64_t			DurationMax;
+}Bench_VectorType;
+
+/*---------------------------------- Global Variables ----------------------------------*/
+static avr_cycle_count_t gMarker[eBENCH_MARKER_COUNT];
+static Bench_VectorType gUSART_RX;
+static Bench_VectorType gTWI;
+static uint8_t gDone = 0;
+static avr_t *gAVR;
+
+static avr_irq_t *gSlaveIRQ;
+static uint8_t gSlaveSelected = 0;
+static uint32_t gSlaveBytes = 0;
+
+static const char *gStubIRQNames[2] = { "8>bench.twi.out", "32<bench.twi.in" };
+
+/*---------------------------------- Function and Hooks ----------------------------------*/
+
+/*
+ * @name	Bench_MarkerWrite
+ * @brief	Timestamps the markers written to GPIOR0 by the firmware
+ */
+static void Bench_MarkerWrite(struct avr_t *avr, avr_io_addr_t addr, uint8_t value, void *param)
+{
+	avr->data[addr] = value;
+	if(value < eBENCH_MARKER_COUNT)
+		gMarker[value] = avr->cycle;
+
+	if(value == eBENCH_USART_RX_START)
+	{
+		//Play the peer: send the bytes, the last one is the carriage return closing the line
+		avr_irq_t *input = avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT);
+		uint16_t index;
+
+		for(index = 0; index < BENCH_USART_RX_BYTES - 1; index++)
+			avr_raise_irq(input, 'a' + (index % 26));
+		avr_raise_irq(input, 0x0D);
+	}
+	else if(value == eBENCH_DONE)
+	{
+		gDone = 1;
+	}
+}
+
+/*
+ * @name	Bench_VectorPending
+ * @brief	Timestamps the cycle at which the interrupt flag of the vector is raised
+ */
+static void Bench_VectorPending(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+	Bench_VectorType *vector = (Bench_VectorType *)param;
+
+	if(value)
+		vector->Pending = gAVR->cycle;
+}
+
+/*
+ * @name	Bench_VectorRunning
+ * @brief	Raised when the vector is taken and lowered on reti: latency and duration of the ISR
+ */
+static void Bench_VectorRunning(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+	Bench_VectorType *vector = (Bench_VectorType *)param;
+	uint64_t cycles;
+
+	if(value)
+	{
+		vector->Entry = gAVR->cycle;
+		cycles = vector->Entry - vector->Pending;
+		vector->LatencySum += cycles;
+		if(cycles > vector->LatencyMax)
+			vector->LatencyMax = cycles;
+	}
+	else
+	{
+		cycles = gAVR->cycle - vector->Entry;
+		vector->DurationSum += cycles;
+		if(cycles > vector->DurationMax)
+			vector->DurationMax = cycles;
+		vector->Count++;
+	}
+}
+
+/*
+ * @name	Bench_AttachVector
+ * @brief	Hooks the pending and running IRQs of an interrupt vector
+ */
+static void Bench_AttachVector(avr_t *avr, uint8_t number, Bench_VectorType *vector)
+{
+	avr_irq_t *irq = avr_get_interrupt_irq(avr, number);
+
+	avr_irq_register_notify(irq + AVR_INT_IRQ_PENDING, Bench_VectorPending, vector);
+	avr_irq_register_notify(irq + AVR_INT_IRQ_RUNNING, Bench_VectorRunning, vector);
+}
+
+/*
+ * @name	Bench_SlaveHook
+ * @brief	I2C slave stub at BENCH_I2C_SLAVE_ADDRESS: acknowledges the address and every
+ *			byte, signals the stop condition to the firmware through GPIOR1
+ */
+static void Bench_SlaveHook(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+	avr_t *avr = (avr_t *)param;
+	avr_twi_msg_irq_t msg;
+
+	msg.u.v = value;
+
+	if(msg.u.twi.msg & TWI_COND_STOP)
+	{
+		if(gSlaveSelected)
+			avr->data[BENCH_STUB_DONE_ADDRESS] = 1;
+		gSlaveSelected = 0;
+	}
+
+	if(msg.u.twi.msg & TWI_COND_START)
+	{
+		gSlaveSelected = 0;
+		if((msg.u.twi.addr >> 1) == BENCH_I2C_SLAVE_ADDRESS)
+		{
+			gSlaveSelected = msg.u.twi.addr;
+			avr_raise_irq(gSlaveIRQ + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_ACK, gSlaveSelected, 1));
+		}
+	}
+
+	if(gSlaveSelected && (msg.u.twi.msg & TWI_COND_WRITE))
+	{
+		gSlaveBytes++;
+		avr_raise_irq(gSlaveIRQ + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_ACK, gSlaveSelected, 1));
+	}
+}
+
+/*
+ * @name	Bench_Elapsed
+ * @brief	Cycles between two markers, 0 if one of them has not been reached
+ */
+static uint64_t Bench_Elapsed(BenchMarkerType start, BenchMarkerType end)
+{
+	if((gMarker[start] == 0) || (gMarker[end] < gMarker[start]))
+		return 0;
+	return gMarker[end] - gMarker[start];
+}
+
+/*
+ * @name	Bench_WriteResults
+ * @brief	Writes the results as a flat JSON object, one metric per key
+ */
+static int Bench_WriteResults(const char *fileName, uint32_t frequency)
+{
+	FILE *file = fopen(fileName, "w");
+	uint64_t gpio = Bench_Elapsed(eBENCH_GPIO_START, eBENCH_GPIO_END);
+
+	if(file == NULL)
+	{
+		perror(fileName);
+		return 1;
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"mcu\": \"%s\",\n", BENCH_MCU);
+	fprintf(file, "  \"f_cpu\": %u,\n", frequency);
+	fprintf(file, "  \"completed\": %s,\n", gDone ? "true" : "false");
+	fprintf(file, "  \"usart_baudrate\": %u,\n", BENCH_USART_BAUDRATE);
+	fprintf(file, "  \"usart_tx_cycles_per_byte\": %.1f,\n",
+			(double)Bench_Elapsed(eBENCH_USART_TX_START, eBENCH_USART_TX_END) / BENCH_USART_TX_BYTES);
+	fprintf(file, "  \"usart_rx_isr_cycles_per_byte\": %.1f,\n",
+			gUSART_RX.Count ? (double)gUSART_RX.DurationSum / gUSART_RX.Count : 0.0);
+	fprintf(file, "  \"usart_rx_isr_cycles_max\": %llu,\n", (unsigned long long)gUSART_RX.DurationMax);
+	fprintf(file, "  \"usart_rx_bytes\": %u,\n", gUSART_RX.Count);
+	fprintf(file, "  \"print_cycles_per_number\": %.1f,\n",
+			(double)Bench_Elapsed(eBENCH_PRINT_START, eBENCH_PRINT_END) / BENCH_PRINT_NUMBERS);
+	fprintf(file, "  \"twi_isr_latency_cycles_avg\": %.1f,\n",
+			gTWI.Count ? (double)gTWI.LatencySum / gTWI.Count : 0.0);
+	fprintf(file, "  \"twi_isr_latency_cycles_max\": %llu,\n", (unsigned long long)gTWI.LatencyMax);
+	fprintf(file, "  \"twi_isr_cycles_avg\": %.1f,\n", gTWI.Count ? (double)gTWI.DurationSum / gTWI.Count : 0.0);
+	fprintf(file, "  \"twi_isr_cycles_max\": %llu,\n", (unsigned long long)gTWI.DurationMax);
+	fprintf(file, "  \"twi_isr_count\": %u,\n", gTWI.Count);
+	fprintf(file, "  \"twi_transaction_cycles\": %llu,\n",
+			(unsigned long long)Bench_Elapsed(eBENCH_I2C_START, eBENCH_I2C_END));
+	fprintf(file, "  \"gpio_cycles_per_toggle\": %.1f,\n", (double)gpio / (2 * BENCH_GPIO_TOGGLES));
+	fprintf(file, "  \"gpio_toggles_per_second\": %.0f\n",
+			gpio ? (double)frequency * 2 * BENCH_GPIO_TOGGLES / gpio : 0.0);
+	fprintf(file, "}\n");
+
+	fclose(file);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	elf_firmware_t firmware;
+	uint32_t flags = 0;
+	int state = cpu_Running;
+
+	if(argc != 3)
+	{
+		fprintf(stderr, "usage: %s <firmware.elf> <results.json>\n", argv[0]);
+		return 1;
+	}
+
+	memset(&firmware, 0, sizeof(firmware));
+	if(elf_read_firmware(argv[1], &firmware) != 0)
+	{
+		fprintf(stderr, "%s: cannot read %s\n", argv[0], argv[1]);
+		return 1;
+	}
+
+	gAVR = avr_make_mcu_by_name(BENCH_MCU);
+	if(gAVR == NULL)
+	{
+		fprintf(stderr, "%s: simavr has no support for %s\n", argv[0], BENCH_MCU);
+		return 1;
+	}
+	avr_init(gAVR);
+	avr_load_firmware(gAVR, &firmware);
+	gAVR->frequency = F_CPU;
+
+	//Markers
+	avr_register_io_write(gAVR, BENCH_MARKER_ADDRESS, Bench_MarkerWrite, NULL);
+
+	//USART0: keep the output of the firmware away from stdout
+	avr_ioctl(gAVR, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+	flags &= ~AVR_UART_FLAG_STDIO;
+	avr_ioctl(gAVR, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+
+	//I2C slave stub
+	gSlaveIRQ = avr_alloc_irq(&gAVR->irq_pool, 0, 2, gStubIRQNames);
+	avr_irq_register_notify(gSlaveIRQ + TWI_IRQ_OUTPUT, Bench_SlaveHook, gAVR);
+	avr_connect_irq(avr_io_getirq(gAVR, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT), gSlaveIRQ + TWI_IRQ_OUTPUT);
+	avr_connect_irq(gSlaveIRQ + TWI_IRQ_INPUT, avr_io_getirq(gAVR, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT));
+
+	//ISR timing
+	Bench_AttachVector(gAVR, BENCH_USART0_RX_VECTOR, &gUSART_RX);
+	Bench_AttachVector(gAVR, BENCH_TWI_VECTOR, &gTWI);
+
+	while(!gDone && (state != cpu_Done) && (state != cpu_Crashed) && (gAVR->cycle < BENCH_MAX_CYCLES))
+		state = avr_run(gAVR);
+
+	if(!gDone)
+		fprintf(stderr, "%s: firmware stopped before the end of the benchmark (cycle %llu)\n",
+				argv[0], (unsigned long long)gAVR->cycle);
+
+	if(Bench_WriteResults(argv[2], (uint32_t)F_CPU))
+		return 1;
+
+	return gDone ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+/**
+  ******************************************************************************
+  * @file    fifo_bench.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Host throughput benchmark of the FIFO of common/fifo.h
+  *			 + put/get     : one element at a time, fill and drain in turns
+  *			 + write/read  : blocks of FIFO_BENCH_BLOCK elements, copied
+  *			 + peek/commit : blocks filled and checked in place (zero-copy)
+  *			 + threads     : producer and consumer threads, the SPSC case of an ISR
+  *			                 and the main loop, every element is checked for its order
+  * @note	 Built and run with "make fifo_bench". The numbers are host numbers, they
+  *			 compare the APIs with each other, the cycles on the target come from "make bench".
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include "fifo.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define FIFO_BENCH_SIZE			128
+#define FIFO_BENCH_BLOCK		32
+#define FIFO_BENCH_ELEMENTS		(64UL * 1024UL * 1024UL)
+
+FIFO_DEFINE(Bench, uint8_t, FIFO_BENCH_SIZE)
+FIFO_DEFINE(BenchWord, uint32_t, FIFO_BENCH_SIZE)
+
+/* Global Variables ----------------------------------------------------------*/
+static Bench_FifoType gBench;
+static BenchWord_FifoType gBenchWord;
+static volatile uint32_t gBench_Sink;		// keeps the compiler from dropping the reads
+static uint32_t gBench_Errors;
+
+/* Functions -----------------------------------------------------------------*/
+
+/*
+ * @name	Bench_Now
+ * @brief	Monotonic time in seconds
+ */
+static double Bench_Now(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/*
+ * @name	Bench_Report
+ * @brief	Prints the time per element and the throughput
+ */
+static void Bench_Report(const char *name, double seconds, unsigned long elements, unsigned size)
+{
+	printf("%-12s %6.2f ns/element %8.1f MB/s\n", name, seconds * 1e9 / (double)elements,
+		   (double)elements * size / seconds / 1e6);
+}
+
+/*
+ * @name	Bench_PutGet
+ * @brief	Fills the FIFO one element at a time and drains it
+ */
+static void Bench_PutGet(void)
+{
+	unsigned long done;
+	uint8_t i, value;
+	uint32_t sum = 0;
+	double start;
+
+	Bench_Init(&gBench);
+	start = Bench_Now();
+	for(done = 0; done < FIFO_BENCH_ELEMENTS; done += FIFO_BENCH_SIZE)
+	{
+		for(i = 0; Bench_Put(&gBench, i) == 0x00; i++)
+			;
+		while(Bench_Get(&gBench, &value) == 0x00)
+			sum += value;
+	}
+	gBench_Sink = sum;
+	Bench_Report("put/get", Bench_Now() - start, done, sizeof(uint8_t));
+}
+
+/*
+ * @name	Bench_WriteRead
+ * @brief	Copies blocks in and out
+ */
+static void Bench_WriteRead(void)
+{
+	uint8_t block[FIFO_BENCH_BLOCK];
+	unsigned long done;
+	uint8_t i;
+	double start;
+
+	for(i = 0; i < FIFO_BENCH_BLOCK; i++)
+		block[i] = i;
+
+	Bench_Init(&gBench);
+	start = Bench_Now();
+	for(done = 0; done < FIFO_BENCH_ELEMENTS; done += FIFO_BENCH_BLOCK)
+	{
+		Bench_Write(&gBench, block, FIFO_BENCH_BLOCK);
+		Bench_Read(&gBench, block, FIFO_BENCH_BLOCK);
+	}
+	gBench_Sink = block[FIFO_BENCH_BLOCK - 1];
+	Bench_Report("write/read", Bench_Now() - start, done, sizeof(uint8_t));
+}
+
+/*
+ * @name	Bench_PeekCommit
+ * @brief	Fills and reads the contiguous parts in place
+ */
+static void Bench_PeekCommit(void)
+{
+	unsigned long done;
+	uint8_t *block;
+	uint8_t length, i;
+	uint32_t sum = 0;
+	double start;
+
+	Bench_Init(&gBench);
+	start = Bench_Now();
+	for(done = 0; done < FIFO_BENCH_ELEMENTS; )
+	{
+		length = Bench_PeekWrite(&gBench, &block);
+		for(i = 0; i < length; i++)
+			block[i] = i;
+		Bench_CommitWrite(&gBench, length);
+
+		length = Bench_PeekRead(&gBench, &block);
+		for(i = 0; i < length; i++)
+			sum += block[i];
+		Bench_CommitRead(&gBench, length);
+		done += length;
+	}
+	gBench_Sink = sum;
+	Bench_Report("peek/commit", Bench_Now() - start, done, sizeof(uint8_t));
+}
+
+/*
+ * @name	Bench_Producer
+ * @brief	Thread putting the sequence 0, 1, 2 ... into the word FIFO
+ */
+static void* Bench_Producer(void *argument)
+{
+	uint32_t sequence = 0;
+
+	while(sequence < FIFO_BENCH_ELEMENTS)
+	{
+		if(BenchWord_Put(&gBenchWord, sequence) == 0x00)
+			sequence++;
+		else
+			sched_yield();		// full: on a single core host the consumer has to run
+	}
+	return argument;
+}
+
+/*
+ * @name	Bench_Threads
+ * @brief	Consumer side of the two thread test, checks the sequence
+ */
+static void Bench_Threads(void)
+{
+	pthread_t producer;
+	uint32_t expected = 0, value;
+	double start;
+
+	BenchWord_Init(&gBenchWord);
+	start = Bench_Now();
+	pthread_create(&producer, NULL, Bench_Producer, NULL);
+	while(expected < FIFO_BENCH_ELEMENTS)
+	{
+		if(BenchWord_Get(&gBenchWord, &value) != 0x00)
+		{
+			sched_yield();
+			continue;
+		}
+		if(value != expected)
+			gBench_Errors++;
+		expected = value + 1;
+	}
+	pthread_join(producer, NULL);
+	Bench_Report("threads", Bench_Now() - start, expected, sizeof(uint32_t));
+	printf("%-12s %u elements out of order\n", "", gBench_Errors);
+}
+
+int main(void)
+{
+	setvbuf(stdout, NULL, _IONBF, 0);
+	printf("FIFO of %u elements, %lu elements per test\n", FIFO_BENCH_SIZE, FIFO_BENCH_ELEMENTS);
+	Bench_PutGet();
+	Bench_WriteRead();
+	Bench_PeekCommit();
+	Bench_Threads();
+
+	return (gBench_Errors == 0) ? 0 : 1;
+}
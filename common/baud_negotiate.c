@@ -0,0 +1,342 @@
+/**
+  ******************************************************************************
+  * @file    baud_negotiate.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file is having the runtime baud rate negotiation. Both sides start at
+  *			 the same (old) rate, e.g. 19200, and move together to the highest rate both
+  *			 of them support:
+  *			 1. initiator -> PROPOSE(rates)      the standard rates reliable at its F_CPU (upto maxRate)
+  *			 2. responder -> ACCEPT(rate)        highest proposed rate it supports too, or the old rate
+  *			    both switch to the rate (the initiator waits BAUD_NEGOTIATE_SWITCH_DELAY_MS)
+  *			 3. initiator -> VERIFY(pattern)     at the new rate
+  *			 4. responder -> VERIFY(pattern)     echo
+  *			 5. initiator -> COMMIT
+  *			 6. responder -> ACK                 at the new rate, the responder keeps it
+  *			 A side which misses the next step within BAUD_NEGOTIATE_TIMEOUT_MS goes back to the
+  *			 old rate, so a tool without negotiation never sees anything else than the old rate.
+  *			 A lost COMMIT or ACK is repeated upto BAUD_NEGOTIATE_COMMIT_RETRIES times: the initiator
+  *			 sends COMMIT again until the ACK arrives, the responder answers every COMMIT and waits
+  *			 BAUD_NEGOTIATE_TIMEOUT_MS after its last ACK for another one. Only when all the ACKs
+  *			 are lost the initiator goes back while the responder stays at the new rate.
+  * @note	 Message: 'N' type length payload CRC16 (crc16.c, high byte first, over type, length and payload)
+  *			 The negotiation is polled and blocking, the receive interrupt of the USART is disabled
+  *			 meanwhile and restored at the end. Timer1 is the time base of the timeouts.
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Configure the USART with USARTInit() at the old rate
+  * 2. Device side: BaudNegotiate_Respond() waits for a proposal, e.g. for a short time after reset
+  *    Tool side: BaudNegotiate_Propose()
+  * 3. On success config->USART_BaudRate is the new rate, on failure the USART is back at the old rate
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <util/delay.h>
+#include "baud_negotiate.h"
+#include "crc16.h"
+#include "atmega644p_timer.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define BAUD_NEGOTIATE_CYCLES_PER_MS	(F_CPU / 1000UL)
+#define BAUD_NEGOTIATE_PATTERN_SIZE		4
+
+/* Global Variables ----------------------------------------------------------*/
+static const uint8_t gBaudNegotiate_Pattern[BAUD_NEGOTIATE_PATTERN_SIZE] = { 0x55, 0xAA, 0x00, 0xFF };
+
+/* Functions -----------------------------------------------------------------*/
+
+/*
+ * @name	BaudNegotiate_PutRate / BaudNegotiate_GetRate
+ * @brief	Rates are sent LSB first
+ */
+static void BaudNegotiate_PutRate(uint8_t *buffer, uint32_t rate)
+{
+	buffer[0] = rate & 0xFF;
+	buffer[1] = (rate >> 8) & 0xFF;
+	buffer[2] = (rate >> 16) & 0xFF;
+	buffer[3] = (rate >> 24) & 0xFF;
+}
+
+static uint32_t BaudNegotiate_GetRate(const uint8_t *buffer)
+{
+	return (uint32_t)buffer[0] | ((uint32_t)buffer[1] << 8) | ((uint32_t)buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+}
+
+/*
+ * @name	BaudNegotiate_Send
+ * @brief	Sends one message and waits until its last stop bit is sent
+ */
+static void BaudNegotiate_Send(uint8_t port, uint8_t type, const uint8_t *payload, uint8_t length)
+{
+	uint16_t crc;
+	uint8_t i;
+
+	crc = CRC16_Update(CRC16_CCITT_INIT, type);
+	crc = CRC16_Update(crc, length);
+	crc = CRC16_Compute(crc, payload, length);
+
+	USART_WriteChar(port, BAUD_NEGOTIATE_START);
+	USART_WriteChar(port, type);
+	USART_WriteChar(port, length);
+	for(i = 0; i < length; i++)
+		USART_WriteChar(port, payload[i]);
+	USART_WriteChar(port, crc >> 8);
+	USART_WriteChar(port, crc & 0xFF);
+	USART_WaitTransmitComplete(port);
+}
+
+/*
+ * @name	BaudNegotiate_Receive
+ * @brief	Waits for a correct message of the given type, anything else is skipped
+ * @param	port     - USART0 or USART1
+ *			type     - expected message
+ *			payload  - BAUD_NEGOTIATE_MAX_PAYLOAD bytes
+ *			length   - received payload length
+ *			timeout  - in ms
+ * @retval	0x00 - message received, 0x01 - timeout
+ */
+static uint8_t BaudNegotiate_Receive(uint8_t port, uint8_t type, uint8_t *payload, uint8_t *length, uint16_t timeout)
+{
+	TIMER1_StopwatchType time;
+	uint32_t limit = (uint32_t)timeout * BAUD_NEGOTIATE_CYCLES_PER_MS;
+	uint8_t header[2];
+	uint8_t index = 0;		// 0: start, 1..2: header, then payload and CRC
+	uint16_t crc = 0;
+	uint16_t data;
+
+	TIMER1_StartStopwatch(&time);
+	while(TIMER1_ReadStopwatch(&time) < limit)
+	{
+		if(USART_ReadChar(port, &data) != 0x00)
+			continue;
+
+		if(data & (USART_RX_ERRORS | 0x0100))
+		{
+			index = 0;		// garbage, e.g. the other side at another rate
+			continue;
+		}
+		data &= 0xFF;
+
+		if(index == 0)
+		{
+			if(data == BAUD_NEGOTIATE_START)
+				index = 1;
+		}
+		else if(index <= 2)
+		{
+			header[index - 1] = data;
+			index++;
+			if((index == 3) && (header[1] > BAUD_NEGOTIATE_MAX_PAYLOAD))
+				index = 0;
+		}
+		else if(index < 3 + header[1])
+		{
+			payload[index - 3] = data;
+			index++;
+		}
+		else if(index == 3 + header[1])
+		{
+			crc = data << 8;
+			index++;
+		}
+		else
+		{
+			crc |= data;
+			index = 0;
+			if((header[0] == type) &&
+			   (CRC16_Compute(CRC16_Update(CRC16_Update(CRC16_CCITT_INIT, header[0]), header[1]), payload, header[1]) == crc))
+			{
+				*length = header[1];
+				return 0x00;
+			}
+		}
+	}
+	return 0x01;
+}
+
+/*
+ * @name	BaudNegotiate_Verify
+ * @brief	Checks a VERIFY message: pattern followed by the rate
+ */
+static uint8_t BaudNegotiate_Verify(const uint8_t *payload, uint8_t length, uint32_t rate)
+{
+	uint8_t i;
+
+	if(length != BAUD_NEGOTIATE_PATTERN_SIZE + 4)
+		return 0x01;
+	for(i = 0; i < BAUD_NEGOTIATE_PATTERN_SIZE; i++)
+	{
+		if(payload[i] != gBaudNegotiate_Pattern[i])
+			return 0x01;
+	}
+	return (BaudNegotiate_GetRate(&payload[BAUD_NEGOTIATE_PATTERN_SIZE]) == rate) ? 0x00 : 0x01;
+}
+
+/*
+ * @name	BaudNegotiate_Switch
+ * @brief	Changes only the baud rate of the USART
+ */
+static void BaudNegotiate_Switch(uint8_t port, const USART_StructureType *config, uint32_t rate)
+{
+	USART_StructureType newConfig = *config;
+
+	newConfig.USART_BaudRate = rate;
+	USARTInit(port, newConfig);
+}
+
+/*
+ * @name	BaudNegotiate_Propose
+ * @brief	Initiator side of the negotiation
+ * @param	port    - USART0 or USART1, configured at the old rate
+ *			config  - configuration of the USART, USART_BaudRate is updated on success
+ *			maxRate - highest rate to be proposed (e.g. limit of the cable)
+ * @retval	0x00 - both sides are at config->USART_BaudRate (it can be the old rate)
+ *			0x01 - no answer, still at the old rate
+ *			0x02 - new rate did not work or COMMIT was not acknowledged, back at the old rate
+ *			0x03 - no reliable rate upto maxRate at this F_CPU
+ */
+uint8_t BaudNegotiate_Propose(uint8_t port, USART_StructureType *config, uint32_t maxRate)
+{
+	uint32_t rates[BAUD_NEGOTIATE_MAX_RATES + 2];
+	uint8_t payload[BAUD_NEGOTIATE_MAX_PAYLOAD];
+	uint8_t count, used, length, i;
+	uint8_t interrupt;
+	uint8_t result = 0x00;
+	uint32_t rate;
+
+	count = USART_GetReliableBaudRates(rates, BAUD_NEGOTIATE_MAX_RATES + 2);
+	for(i = 0, used = 0; (i < count) && (used < BAUD_NEGOTIATE_MAX_RATES); i++)
+	{
+		if(rates[i] <= maxRate)
+			BaudNegotiate_PutRate(&payload[1 + (4 * used++)], rates[i]);
+	}
+	if(used == 0)
+		return 0x03;
+	payload[0] = used;
+
+	interrupt = USART_SetReceiveInterrupt(port, 0);
+	BaudNegotiate_Send(port, BAUD_NEGOTIATE_PROPOSE, payload, 1 + (4 * used));
+
+	if((BaudNegotiate_Receive(port, BAUD_NEGOTIATE_ACCEPT, payload, &length, BAUD_NEGOTIATE_TIMEOUT_MS) != 0x00) || (length != 4))
+	{
+		result = 0x01;
+	}
+	else if((rate = BaudNegotiate_GetRate(payload)) != config->USART_BaudRate)
+	{
+		BaudNegotiate_Switch(port, config, rate);
+		_delay_ms(BAUD_NEGOTIATE_SWITCH_DELAY_MS);
+
+		for(i = 0; i < BAUD_NEGOTIATE_PATTERN_SIZE; i++)
+			payload[i] = gBaudNegotiate_Pattern[i];
+		BaudNegotiate_PutRate(&payload[BAUD_NEGOTIATE_PATTERN_SIZE], rate);
+		BaudNegotiate_Send(port, BAUD_NEGOTIATE_VERIFY, payload, BAUD_NEGOTIATE_PATTERN_SIZE + 4);
+
+		if((BaudNegotiate_Receive(port, BAUD_NEGOTIATE_VERIFY, payload, &length, BAUD_NEGOTIATE_TIMEOUT_MS) == 0x00) &&
+		   (BaudNegotiate_Verify(payload, length, rate) == 0x00))
+		{
+			//The responder keeps the new rate once it acknowledges, the COMMIT is repeated until then
+			result = 0x02;
+			for(i = 0; (i < BAUD_NEGOTIATE_COMMIT_RETRIES) && (result != 0x00); i++)
+			{
+				BaudNegotiate_Send(port, BAUD_NEGOTIATE_COMMIT, payload, 0);
+				if(BaudNegotiate_Receive(port, BAUD_NEGOTIATE_ACK, payload, &length, BAUD_NEGOTIATE_TIMEOUT_MS) == 0x00)
+					result = 0x00;
+			}
+		}
+		else
+		{
+			result = 0x02;
+		}
+
+		if(result == 0x00)
+			config->USART_BaudRate = rate;
+		else
+			BaudNegotiate_Switch(port, config, config->USART_BaudRate);
+	}
+
+	USART_SetReceiveInterrupt(port, interrupt);
+	return result;
+}
+
+/*
+ * @name	BaudNegotiate_Respond
+ * @brief	Responder side of the negotiation
+ * @param	port    - USART0 or USART1, configured at the old rate
+ *			config  - configuration of the USART, USART_BaudRate is updated on success
+ *			maxRate - highest rate to be accepted
+ *			timeout - time to wait for the proposal in ms
+ * @retval	0x00 - both sides are at config->USART_BaudRate (it can be the old rate)
+ *			0x01 - no proposal, still at the old rate
+ *			0x02 - new rate did not work, back at the old rate
+ * @note	After the ACK it waits BAUD_NEGOTIATE_TIMEOUT_MS for a repeated COMMIT before it returns
+ */
+uint8_t BaudNegotiate_Respond(uint8_t port, USART_StructureType *config, uint32_t maxRate, uint16_t timeout)
+{
+	uint8_t payload[BAUD_NEGOTIATE_MAX_PAYLOAD];
+	USART_BaudType baud;
+	uint8_t length, i;
+	uint8_t interrupt;
+	uint8_t result = 0x00;
+	uint32_t rate = config->USART_BaudRate;
+	uint32_t proposed;
+
+	interrupt = USART_SetReceiveInterrupt(port, 0);
+
+	if((BaudNegotiate_Receive(port, BAUD_NEGOTIATE_PROPOSE, payload, &length, timeout) != 0x00) ||
+	   (length < 1) || (length != 1 + (4 * payload[0])))
+	{
+		USART_SetReceiveInterrupt(port, interrupt);
+		return 0x01;
+	}
+
+	//Highest proposed rate which is reliable here too
+	for(i = 0; i < payload[0]; i++)
+	{
+		proposed = BaudNegotiate_GetRate(&payload[1 + (4 * i)]);
+		if((proposed > rate) && (proposed <= maxRate) &&
+		   (USART_CalculateBaud(proposed, config->USART_Modes, &baud) == 0x00))
+			rate = proposed;
+	}
+
+	BaudNegotiate_PutRate(payload, rate);
+	BaudNegotiate_Send(port, BAUD_NEGOTIATE_ACCEPT, payload, 4);
+
+	if(rate != config->USART_BaudRate)
+	{
+		BaudNegotiate_Switch(port, config, rate);
+
+		if((BaudNegotiate_Receive(port, BAUD_NEGOTIATE_VERIFY, payload, &length, BAUD_NEGOTIATE_TIMEOUT_MS) == 0x00) &&
+		   (BaudNegotiate_Verify(payload, length, rate) == 0x00))
+		{
+			BaudNegotiate_Send(port, BAUD_NEGOTIATE_VERIFY, payload, length);
+		}
+		else
+		{
+			result = 0x02;
+		}
+
+		if((result == 0x00) &&
+		   (BaudNegotiate_Receive(port, BAUD_NEGOTIATE_COMMIT, payload, &length, BAUD_NEGOTIATE_TIMEOUT_MS) == 0x00))
+		{
+			//The ACK can be lost too: answer the repeated COMMITs of the initiator
+			i = 0;
+			do
+			{
+				BaudNegotiate_Send(port, BAUD_NEGOTIATE_ACK, payload, 0);
+			}while((++i < BAUD_NEGOTIATE_COMMIT_RETRIES) &&
+				   (BaudNegotiate_Receive(port, BAUD_NEGOTIATE_COMMIT, payload, &length, BAUD_NEGOTIATE_TIMEOUT_MS) == 0x00));
+			config->USART_BaudRate = rate;
+		}
+		else
+		{
+			BaudNegotiate_Switch(port, config, config->USART_BaudRate);
+			result = 0x02;
+		}
+	}
+
+	USART_SetReceiveInterrupt(port, interrupt);
+	return result;
+}
@@ -0,0 +1,41 @@
+/**
+  ******************************************************************************
+  * @file    baud_negotiate.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Header for baud_negotiate.c, runtime baud rate negotiation on a USART
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BAUD_NEGOTIATE_H
+#define __BAUD_NEGOTIATE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "atmega644p_usart.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define BAUD_NEGOTIATE_START			'N'		// first byte of every message
+#define BAUD_NEGOTIATE_PROPOSE			'P'		// initiator -> responder: count, rates (uint32_t, LSB first)
+#define BAUD_NEGOTIATE_ACCEPT			'A'		// responder -> initiator: selected rate
+#define BAUD_NEGOTIATE_VERIFY			'V'		// both directions at the new rate: pattern and rate
+#define BAUD_NEGOTIATE_COMMIT			'C'		// initiator -> responder: keep the new rate
+#define BAUD_NEGOTIATE_ACK				'K'		// responder -> initiator: COMMIT received, new rate kept
+
+#define BAUD_NEGOTIATE_MAX_RATES		8
+#define BAUD_NEGOTIATE_MAX_PAYLOAD		(1 + (4 * BAUD_NEGOTIATE_MAX_RATES))
+
+#ifndef BAUD_NEGOTIATE_TIMEOUT_MS
+#define BAUD_NEGOTIATE_TIMEOUT_MS		200		// answer time of every step
+#endif
+#define BAUD_NEGOTIATE_COMMIT_RETRIES	3		// COMMITs sent by the initiator without an ACK
+#define BAUD_NEGOTIATE_SWITCH_DELAY_MS	2		// initiator waits for the responder to switch
+
+/* Exported functions ------------------------------------------------------- */
+extern uint8_t BaudNegotiate_Propose(uint8_t port, USART_StructureType *config, uint32_t maxRate);
+extern uint8_t BaudNegotiate_Respond(uint8_t port, USART_StructureType *config, uint32_t maxRate, uint16_t timeout);
+
+#endif // __BAUD_NEGOTIATE_H
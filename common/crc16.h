@@ -0,0 +1,55 @@
+/**
+  ******************************************************************************
+  * @file    crc16.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Header for crc16.c, table driven CRC16/CCITT-FALSE and CRC16/MODBUS
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CRC16_H
+#define __CRC16_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define CRC16_CCITT_INIT		0xFFFF		// initial value, no final XOR
+#define CRC16_CCITT_CHECK		0x29B1		// CRC of "123456789"
+#define CRC16_CCITT_RESIDUE		0x0000		// CRC over data followed by its CRC (high byte first)
+
+#define CRC16_MODBUS_INIT		0xFFFF		// initial value, no final XOR
+#define CRC16_MODBUS_CHECK		0x4B37		// CRC of "123456789"
+#define CRC16_MODBUS_RESIDUE	0x0000		// CRC over data followed by its CRC (low byte first)
+
+extern const uint16_t gCRC16_Table[256] PROGMEM;
+extern const uint16_t gCRC16_ModbusTable[256] PROGMEM;
+
+/* Exported functions ------------------------------------------------------- */
+
+/*
+ * @name	CRC16_Update
+ * @brief	Adds one byte to the CRC, one table lookup (usable per byte in the ISRs)
+ */
+static inline uint16_t CRC16_Update(uint16_t crc, uint8_t data)
+{
+	return (crc << 8) ^ pgm_read_word(&gCRC16_Table[(uint8_t)(crc >> 8) ^ data]);
+}
+
+/*
+ * @name	CRC16_ModbusUpdate
+ * @brief	Adds one byte to the Modbus CRC (reflected, the table is indexed with the low byte)
+ */
+static inline uint16_t CRC16_ModbusUpdate(uint16_t crc, uint8_t data)
+{
+	return (crc >> 8) ^ pgm_read_word(&gCRC16_ModbusTable[(uint8_t)crc ^ data]);
+}
+
+extern uint16_t CRC16_Compute(uint16_t crc, const uint8_t *data, uint16_t length);
+extern uint16_t CRC16_ModbusCompute(uint16_t crc, const uint8_t *data, uint16_t length);
+
+#endif // __CRC16_H
@@ -0,0 +1,184 @@
+/**
+  ******************************************************************************
+  * @file    fifo.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Generic single producer / single consumer FIFO.
+  *			 FIFO_DEFINE(name, type, size) declares name_FifoType holding size elements of
+  *			 type, and its inline functions name_Put(), name_Get() ... The element type and
+  *			 the size are known at compile time, so the index masking is a constant AND.
+  * @note	 + size is a power of 2 from 1 to 128. Head and Tail are 8 bit and run freely,
+  *			   Head - Tail is the number of elements: all the slots are used.
+  *			 + One side (e.g. an ISR) only calls the producer functions (Put, Write,
+  *			   PeekWrite/CommitWrite), the other side only the consumer ones (Get, Read,
+  *			   PeekRead/CommitRead, Flush). Each index is written by one side only and an 8 bit
+  *			   read is atomic on the AVR, so no critical section is needed: the element is
+  *			   stored before Head is moved and read before Tail is moved (FIFO_BARRIER()).
+  *			 + Peek/Commit give the contiguous part of the buffer, up to the wrap around, for
+  *			   zero-copy access: fill or parse it in place, then commit the elements used.
+  *			 + Count/Free are exact for the calling side, the other side can only make them
+  *			   better (more elements for the consumer, more room for the producer).
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. FIFO_DEFINE(Rx, uint16_t, 64); at file scope, then static Rx_FifoType gRx;
+  * 2. Rx_Init(&gRx) before the producer and the consumer are started
+  * 3. Producer: Rx_Put(&gRx, word) returns 0x01 when full, Rx_Write() copies a block
+  * 4. Consumer: Rx_Get(&gRx, &word) returns 0x01 when empty, Rx_Read() copies a block
+  * 5. Zero-copy: n = Rx_PeekRead(&gRx, &block); use block[0 .. n-1]; Rx_CommitRead(&gRx, n);
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FIFO_H
+#define __FIFO_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+/* Exported macro ------------------------------------------------------------*/
+#if defined(__AVR__)
+#define FIFO_BARRIER()			__asm__ __volatile__("" ::: "memory")		// single core: the compiler must not reorder
+#else
+#define FIFO_BARRIER()			__atomic_thread_fence(__ATOMIC_ACQ_REL)		// host threads (fifo_bench)
+#endif // __AVR__
+
+#define FIFO_SIZE_IS_VALID(size)	(((size) >= 1) && ((size) <= 128) && (((size) & ((size) - 1)) == 0))
+
+#define FIFO_DEFINE(name, type, size)																		\
+typedef struct																								\
+{																											\
+	volatile uint8_t	Head;			/* written by the producer only */									\
+	volatile uint8_t	Tail;			/* written by the consumer only */									\
+	type				Buffer[(size)];																		\
+}name##_FifoType;																							\
+																											\
+typedef char name##_FifoSizeCheck[FIFO_SIZE_IS_VALID(size) ? 1 : -1];	/* power of 2 upto 128 */			\
+																											\
+static inline void name##_Init(name##_FifoType *fifo)														\
+{																											\
+	fifo->Head = 0;																							\
+	fifo->Tail = 0;																							\
+}																											\
+																											\
+static inline uint8_t name##_Count(const name##_FifoType *fifo)												\
+{																											\
+	return (uint8_t)(fifo->Head - fifo->Tail);																\
+}																											\
+																											\
+static inline uint8_t name##_Free(const name##_FifoType *fifo)												\
+{																											\
+	return (size) - (uint8_t)(fifo->Head - fifo->Tail);														\
+}																											\
+																											\
+/* Producer: 0x00 - stored, 0x01 - full */																	\
+static inline uint8_t name##_Put(name##_FifoType *fifo, type value)										\
+{																											\
+	uint8_t head = fifo->Head;																				\
+																											\
+	if((uint8_t)(head - fifo->Tail) >= (size))																\
+		return 0x01;																						\
+	fifo->Buffer[head & ((size) - 1)] = value;																\
+	FIFO_BARRIER();																							\
+	fifo->Head = head + 1;																					\
+	return 0x00;																							\
+}																											\
+																											\
+/* Consumer: 0x00 - value read, 0x01 - empty */																\
+static inline uint8_t name##_Get(name##_FifoType *fifo, type *value)										\
+{																											\
+	uint8_t tail = fifo->Tail;																				\
+																											\
+	if(fifo->Head == tail)																					\
+		return 0x01;																						\
+	FIFO_BARRIER();																							\
+	*value = fifo->Buffer[tail & ((size) - 1)];																\
+	FIFO_BARRIER();																							\
+	fifo->Tail = tail + 1;																					\
+	return 0x00;																							\
+}																											\
+																											\
+/* Producer: contiguous free slots from Head, filled in place and then given with CommitWrite() */			\
+static inline uint8_t name##_PeekWrite(name##_FifoType *fifo, type **block)									\
+{																											\
+	uint8_t head = fifo->Head;																				\
+	uint8_t room = (size) - (uint8_t)(head - fifo->Tail);													\
+	uint8_t contiguous = (size) - (head & ((size) - 1));													\
+																											\
+	*block = &fifo->Buffer[head & ((size) - 1)];															\
+	return (room < contiguous) ? room : contiguous;															\
+}																											\
+																											\
+static inline void name##_CommitWrite(name##_FifoType *fifo, uint8_t count)								\
+{																											\
+	FIFO_BARRIER();																							\
+	fifo->Head = fifo->Head + count;																		\
+}																											\
+																											\
+/* Consumer: contiguous elements from Tail, used in place and then released with CommitRead() */			\
+static inline uint8_t name##_PeekRead(name##_FifoType *fifo, type **block)									\
+{																											\
+	uint8_t tail = fifo->Tail;																				\
+	uint8_t count = (uint8_t)(fifo->Head - tail);															\
+	uint8_t contiguous = (size) - (tail & ((size) - 1));													\
+																											\
+	FIFO_BARRIER();																							\
+	*block = &fifo->Buffer[tail & ((size) - 1)];															\
+	return (count < contiguous) ? count : contiguous;														\
+}																											\
+																											\
+static inline void name##_CommitRead(name##_FifoType *fifo, uint8_t count)									\
+{																											\
+	FIFO_BARRIER();																							\
+	fifo->Tail = fifo->Tail + count;																		\
+}																											\
+																											\
+/* Producer: copies upto count elements, returns the number copied */										\
+static inline uint8_t name##_Write(name##_FifoType *fifo, const type *data, uint8_t count)					\
+{																											\
+	type *block;																							\
+	uint8_t done = 0, length;																				\
+																											\
+	while(done < count)																						\
+	{																										\
+		length = name##_PeekWrite(fifo, &block);															\
+		if(length == 0)																						\
+			break;																							\
+		if(length > count - done)																			\
+			length = count - done;																			\
+		memcpy(block, &data[done], length * sizeof(type));													\
+		name##_CommitWrite(fifo, length);																	\
+		done += length;																						\
+	}																										\
+	return done;																							\
+}																											\
+																											\
+/* Consumer: copies upto count elements, returns the number copied */										\
+static inline uint8_t name##_Read(name##_FifoType *fifo, type *data, uint8_t count)						\
+{																											\
+	type *block;																							\
+	uint8_t done = 0, length;																				\
+																											\
+	while(done < count)																						\
+	{																										\
+		length = name##_PeekRead(fifo, &block);																\
+		if(length == 0)																						\
+			break;																							\
+		if(length > count - done)																			\
+			length = count - done;																			\
+		memcpy(&data[done], block, length * sizeof(type));													\
+		name##_CommitRead(fifo, length);																	\
+		done += length;																						\
+	}																										\
+	return done;																							\
+}																											\
+																											\
+/* Consumer: drops everything received so far */															\
+static inline void name##_Flush(name##_FifoType *fifo)														\
+{																											\
+	fifo->Tail = fifo->Head;																				\
+}
+
+#endif // __FIFO_H
@@ -0,0 +1,348 @@
+/**
+  ******************************************************************************
+  * @file    frame.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file is having the packet framing of the USARTs: binary payloads
+  *			 are protected with a CRC16/CCITT (crc16.c) and encoded with COBS, so
+  *			 0x00 never appears inside a frame and is the frame delimiter.
+  *			 Frame on the line: COBS(payload, CRC high byte, CRC low byte) 0x00
+  * @note	 Both directions work one byte at a time in the ISRs:
+  *			 + transmit: the COBS blocks are produced by the UDRE ISR (USART_StartTransmitSource())
+  *			   directly from the payload, there is no encode buffer.
+  *			 + receive: the receive hook decodes and updates the CRC with every byte. At the
+  *			   delimiter the frame is checked and, if correct, given to the application.
+  *			 Received frames are double buffered: the ISR decodes the next frame while the
+  *			 application works on the previous one.
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Configure the USART with USARTInit(), 8 data bits, and enable the receive interrupt
+  * 2. Call Frame_Init() with the USART and optionally a hook called from the ISR when a frame is ready
+  *    (e.g. to post a scheduler task)
+  * 3. Frame_Receive() returns the verified payload (no copy), call Frame_Release() when done with it
+  * 4. Frame_Send() sends a payload, which has to stay valid until the complete hook is called
+  * 5. Frame_GetStatistics() for the CRC errors, overflows and dropped frames
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/interrupt.h>
+#include "frame.h"
+#include "crc16.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define FRAME_BUFFER_SIZE		(FRAME_MAX_PAYLOAD + FRAME_CRC_SIZE)
+#define FRAME_MAX_BLOCK			0xFF		// code of a block of 254 bytes without a zero after it
+
+/* Typedefs ------------------------------------------------------------------*/
+typedef enum
+{
+	eFRAME_CODE = 0,		// next byte is the code of a block
+	eFRAME_DATA,			// data bytes of the block
+	eFRAME_DELIMITER,		// end of the frame
+}Frame_EncodeStateType;
+
+typedef struct
+{
+	const uint8_t	*Payload;
+	uint16_t		Length;			// payload + CRC
+	uint16_t		Index;
+	uint16_t		CRC;
+	uint8_t			Code;
+	uint8_t			Remaining;		// data bytes left in the block
+	uint8_t			State;
+}Frame_EncoderType;
+
+typedef struct
+{
+	uint8_t			Buffer[2][FRAME_BUFFER_SIZE];
+	uint8_t			Length[2];
+	uint8_t			Write;			// buffer of the ISR
+	volatile uint8_t Ready;			// buffer 1 - Write has a verified frame
+	uint16_t		CRC;
+	uint8_t			Code;			// code of the current block, FRAME_MAX_BLOCK before the first block
+	uint8_t			Remaining;
+	uint8_t			Overflow;
+	uint8_t			LineError;		// a byte of the frame had FEn, DORn or UPEn set
+	Frame_ReceivedHookType Hook;
+	Frame_StatisticsType Statistics;
+}Frame_DecoderType;
+
+/* Global Variables ----------------------------------------------------------*/
+static Frame_EncoderType gFrame_Encoder[2];
+static Frame_DecoderType gFrame_Decoder[2];
+
+/* Functions -----------------------------------------------------------------*/
+
+/*
+ * @name	Frame_EncodedByte
+ * @brief	Byte of the payload followed by the CRC (high byte first)
+ */
+static inline uint8_t Frame_EncodedByte(const Frame_EncoderType *encoder, uint16_t index)
+{
+	if(index < encoder->Length - FRAME_CRC_SIZE)
+		return encoder->Payload[index];
+	if(index == encoder->Length - FRAME_CRC_SIZE)
+		return encoder->CRC >> 8;
+	return encoder->CRC & 0xFF;
+}
+
+/*
+ * @name	Frame_EndBlock
+ * @brief	Selects what follows a COBS block: the zero replaced by the block is skipped
+ */
+static inline void Frame_EndBlock(Frame_EncoderType *encoder)
+{
+	if(encoder->Code != FRAME_MAX_BLOCK)
+	{
+		if(encoder->Index < encoder->Length)
+		{
+			encoder->Index++;					// the zero, a block follows even if it was the last byte
+			encoder->State = eFRAME_CODE;
+		}
+		else
+		{
+			encoder->State = eFRAME_DELIMITER;
+		}
+	}
+	else
+	{
+		encoder->State = (encoder->Index < encoder->Length) ? eFRAME_CODE : eFRAME_DELIMITER;
+	}
+}
+
+/*
+ * @name	Frame_TransmitSource
+ * @brief	Transmit source of the USART (UDRE ISR), gives the next byte of the encoded frame
+ * @retval	1 with the delimiter (last byte), 0 otherwise
+ */
+static uint8_t Frame_TransmitSource(uint8_t port, uint8_t *data)
+{
+	Frame_EncoderType *encoder = &gFrame_Encoder[port];
+	uint8_t run;
+
+	switch(encoder->State)
+	{
+		case eFRAME_CODE:
+			//Length of the block: bytes upto the next zero, at most 254
+			for(run = 0; (run < FRAME_MAX_BLOCK - 1) && ((encoder->Index + run) < encoder->Length)
+					&& (Frame_EncodedByte(encoder, encoder->Index + run) != 0x00); run++)
+				;
+			encoder->Code = run + 1;
+			encoder->Remaining = run;
+			*data = encoder->Code;
+			if(run != 0)
+				encoder->State = eFRAME_DATA;
+			else
+				Frame_EndBlock(encoder);
+			return 0;
+
+		case eFRAME_DATA:
+			*data = Frame_EncodedByte(encoder, encoder->Index);
+			encoder->Index++;
+			if(--encoder->Remaining == 0)
+				Frame_EndBlock(encoder);
+			return 0;
+
+		default:
+			*data = FRAME_DELIMITER;
+			return 1;
+	}
+}
+
+/*
+ * @name	Frame_ResetDecoder
+ * @brief	Starts decoding a new frame in the write buffer
+ */
+static inline void Frame_ResetDecoder(Frame_DecoderType *decoder)
+{
+	decoder->Length[decoder->Write] = 0;
+	decoder->CRC = CRC16_CCITT_INIT;
+	decoder->Code = FRAME_MAX_BLOCK;
+	decoder->Remaining = 0;
+	decoder->Overflow = 0;
+	decoder->LineError = 0;
+}
+
+/*
+ * @name	Frame_Store
+ * @brief	Adds a decoded byte to the frame and to its CRC
+ */
+static inline void Frame_Store(Frame_DecoderType *decoder, uint8_t data)
+{
+	uint8_t *length = &decoder->Length[decoder->Write];
+
+	if(*length >= FRAME_BUFFER_SIZE)
+	{
+		decoder->Overflow = 1;
+		return;
+	}
+	decoder->Buffer[decoder->Write][*length] = data;
+	(*length)++;
+	decoder->CRC = CRC16_Update(decoder->CRC, data);
+}
+
+/*
+ * @name	Frame_EndOfFrame
+ * @brief	Verifies the decoded frame and gives it to the application
+ */
+static void Frame_EndOfFrame(uint8_t port, Frame_DecoderType *decoder)
+{
+	uint8_t length = decoder->Length[decoder->Write];
+
+	if(length == 0)
+		return;											// delimiters between the frames
+
+	if(decoder->Overflow)
+	{
+		decoder->Statistics.Overflows++;
+	}
+	else if(decoder->LineError || (decoder->Remaining != 0) || (length < FRAME_CRC_SIZE) || (decoder->CRC != CRC16_CCITT_RESIDUE))
+	{
+		decoder->Statistics.CRCErrors++;
+	}
+	else if(decoder->Ready)
+	{
+		decoder->Statistics.Dropped++;					// previous frame is still used
+	}
+	else
+	{
+		decoder->Length[decoder->Write] = length - FRAME_CRC_SIZE;
+		decoder->Write ^= 0x01;
+		decoder->Ready = 1;
+		decoder->Statistics.Received++;
+		if(decoder->Hook != NULL)
+			decoder->Hook(port);
+	}
+}
+
+/*
+ * @name	Frame_ReceiveHook
+ * @brief	Receive hook of the USART, decodes one byte
+ * @note	The zero replaced by a block is stored when the next block starts, so the zero
+ *			after the last block (which is not part of the data) is never stored.
+ */
+static void Frame_ReceiveHook(uint8_t port, uint16_t data)
+{
+	Frame_DecoderType *decoder = &gFrame_Decoder[port];
+
+	if(data & USART_RX_ERRORS)
+		decoder->LineError = 1;
+
+	if((data & 0xFF) == FRAME_DELIMITER)
+	{
+		Frame_EndOfFrame(port, decoder);
+		Frame_ResetDecoder(decoder);
+	}
+	else if(decoder->Remaining == 0)
+	{
+		if(decoder->Code != FRAME_MAX_BLOCK)
+			Frame_Store(decoder, 0x00);
+		decoder->Code = data & 0xFF;
+		decoder->Remaining = decoder->Code - 1;
+	}
+	else
+	{
+		Frame_Store(decoder, data & 0xFF);
+		decoder->Remaining--;
+	}
+}
+
+/*
+ * @name	Frame_Init
+ * @brief	Starts the framing on a USART
+ * @param	port - USART0 or USART1
+ *			hook - called from the receive ISR when a verified frame is ready, can be NULL
+ * @note	Replaces the receive hook of the USART
+ */
+void Frame_Init(uint8_t port, Frame_ReceivedHookType hook)
+{
+	Frame_DecoderType *decoder = &gFrame_Decoder[port & 0x01];
+	uint8_t sreg = SREG;
+
+	cli();
+	decoder->Write = 0;
+	decoder->Ready = 0;
+	decoder->Hook = hook;
+	decoder->Statistics.Received = 0;
+	decoder->Statistics.CRCErrors = 0;
+	decoder->Statistics.Overflows = 0;
+	decoder->Statistics.Dropped = 0;
+	Frame_ResetDecoder(decoder);
+	SREG = sreg;
+
+	USART_RegisterReceiveHook(port & 0x01, Frame_ReceiveHook);
+}
+
+/*
+ * @name	Frame_Send
+ * @brief	Sends a payload as one frame, interrupt driven
+ * @param	port     - USART0 or USART1
+ *			payload  - data, has to stay valid until complete is called
+ *			length   - 1 to FRAME_MAX_PAYLOAD bytes
+ *			complete - called from the TXC ISR after the delimiter, can be NULL
+ * @retval	0x00 - frame is being sent
+ *			0x01 - previous transmission is still running
+ *			0x02 - wrong length
+ */
+uint8_t Frame_Send(uint8_t port, const uint8_t *payload, uint8_t length, USART_TransmitCompleteHookType complete)
+{
+	Frame_EncoderType *encoder = &gFrame_Encoder[port & 0x01];
+
+	if((payload == NULL) || (length == 0) || (length > FRAME_MAX_PAYLOAD))
+		return 0x02;
+	if(USART_IsTransmitBusy(port))
+		return 0x01;
+
+	encoder->Payload = payload;
+	encoder->Length = length + FRAME_CRC_SIZE;
+	encoder->Index = 0;
+	encoder->CRC = CRC16_Compute(CRC16_CCITT_INIT, payload, length);
+	encoder->State = eFRAME_CODE;
+
+	return USART_StartTransmitSource(port & 0x01, Frame_TransmitSource, complete);
+}
+
+/*
+ * @name	Frame_Receive
+ * @brief	Returns the last verified frame
+ * @param	port   - USART0 or USART1
+ *			length - number of payload bytes
+ * @retval	payload, NULL if there is no frame. It is valid until Frame_Release().
+ */
+const uint8_t* Frame_Receive(uint8_t port, uint8_t *length)
+{
+	Frame_DecoderType *decoder = &gFrame_Decoder[port & 0x01];
+	uint8_t buffer;
+
+	if(!decoder->Ready)
+		return NULL;
+
+	buffer = decoder->Write ^ 0x01;
+	*length = decoder->Length[buffer];
+	return decoder->Buffer[buffer];
+}
+
+/*
+ * @name	Frame_Release
+ * @brief	Gives the buffer of the frame returned by Frame_Receive() back to the ISR
+ */
+void Frame_Release(uint8_t port)
+{
+	gFrame_Decoder[port & 0x01].Ready = 0;
+}
+
+/*
+ * @name	Frame_GetStatistics
+ * @brief	Copies the counters of the port
+ */
+void Frame_GetStatistics(uint8_t port, Frame_StatisticsType *statistics)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	*statistics = gFrame_Decoder[port & 0x01].Statistics;
+	SREG = sreg;
+}
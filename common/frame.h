@@ -0,0 +1,47 @@
+/**
+  ******************************************************************************
+  * @file    frame.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Header for frame.c, COBS packet framing with CRC16 on the USARTs
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FRAME_H
+#define __FRAME_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdlib.h>
+#include "atmega644p_usart.h"
+
+/* Exported constants --------------------------------------------------------*/
+#ifndef FRAME_MAX_PAYLOAD
+#define FRAME_MAX_PAYLOAD		64			// bytes of payload per frame, upto 252
+#endif
+
+#define FRAME_DELIMITER			0x00		// end of every encoded frame
+#define FRAME_CRC_SIZE			2
+
+/* Exported types ------------------------------------------------------------*/
+typedef void (*Frame_ReceivedHookType)(uint8_t);		// USART0/USART1 which has a verified frame ready
+
+typedef struct
+{
+	uint16_t	Received;		// verified frames given to the application
+	uint16_t	CRCErrors;		// frames with a wrong CRC, a line error or a broken COBS block
+	uint16_t	Overflows;		// frames longer than FRAME_MAX_PAYLOAD
+	uint16_t	Dropped;		// verified frames lost because the application did not release the previous one
+}Frame_StatisticsType;
+
+/* Exported functions ------------------------------------------------------- */
+extern void Frame_Init(uint8_t port, Frame_ReceivedHookType hook);
+extern uint8_t Frame_Send(uint8_t port, const uint8_t *payload, uint8_t length, USART_TransmitCompleteHookType complete);
+extern const uint8_t* Frame_Receive(uint8_t port, uint8_t *length);
+extern void Frame_Release(uint8_t port);
+extern void Frame_GetStatistics(uint8_t port, Frame_StatisticsType *statistics);
+
+#endif // __FRAME_H
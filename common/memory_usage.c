@@ -0,0 +1,226 @@
+/**
+  ******************************************************************************
+  * @file    memory_usage.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file is having the SRAM instrumentation: the free SRAM between the heap
+  *			 (__heap_start .. __brkval) and the stack (SP .. RAMEND) is painted with
+  *			 MEMORY_CANARY at startup, the bytes which still hold the paint later on have
+  *			 never been used. This gives the high-water marks of the heap and of the stack
+  *			 (the ISRs and their nesting included) without any code in the hot paths.
+  * @note	 + The paint is done in .init1, before the stack is used at all, with
+  *			   INCLUDE_MEMORY_USAGE=1. It costs about 4 cycles per free byte at the reset.
+  *			 + The heap peak is the first painted byte above the break, the stack peak the
+  *			   last painted byte below the stack. A pushed byte which happens to be
+  *			   MEMORY_CANARY at the edge makes the peak a byte lower, nothing more.
+  *			 + Memory_Check() looks at the MEMORY_GUARD_SIZE bytes above the heap peak (a heap
+  *			   which has shrunk leaves its data behind): once one of them is overwritten the stack
+  *			   has come too close (or the heap has grown into the stack). It is latched, reported
+  *			   once with TRACE() and the collision hook.
+  *			   With MEMORY_CHECK_TIMER=1 it runs from the Timer2 overflow ISR every 2.048ms.
+  *			 + Host build: the SRAM is the array of host_sram_model.c, Memory_Init() paints it.
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Build with INCLUDE_MEMORY_USAGE=1 (and MEMORY_CHECK_TIMER=1 for the periodic check)
+  * 2. Call Memory_Init(hook) at startup, hook may be NULL
+  * 3. Memory_Dump(Print_GetConsole()) prints the usage, Memory_GetUsage() gives the numbers
+  * 4. Memory_Check() can be called from any periodic task or ISR instead of the Timer2 one
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "memory_usage.h"
+#include "atmega644p_timer.h"
+#include "trace.h"
+
+#if defined(HOST_BUILD)
+#include "host_model.h"
+
+#define MEMORY_HEAP_START		HostSRAM_HeapStart()
+#define MEMORY_END				HostSRAM_End()
+#define MEMORY_STACK_POINTER	HostSRAM_StackPointer()
+#define MEMORY_BREAK			HostSRAM_Break()
+#else
+extern uint8_t __heap_start;
+extern char *__brkval;
+
+#define MEMORY_HEAP_START		(&__heap_start)
+#define MEMORY_END				((uint8_t *)RAMEND)
+#define MEMORY_STACK_POINTER	((uint8_t *)SP)
+#define MEMORY_BREAK			((uint8_t *)__brkval)
+#endif // HOST_BUILD
+
+/* Global Variables ----------------------------------------------------------*/
+static Memory_CollisionHookType gMemory_CollisionHook = NULL;
+static volatile uint8_t gMemory_Collided = 0;
+static uint8_t *gMemory_HeapPeak = NULL;		// highest byte the heap has reached, seen by Memory_Check()
+
+/* Functions -----------------------------------------------------------------*/
+
+#if (INCLUDE_MEMORY_USAGE > 0) && !defined(HOST_BUILD)
+/*
+ * @name	Memory_Paint
+ * @brief	Runs in .init1: paints __heap_start .. RAMEND
+ * @note	Before .init2, so r1 is not cleared and there is no stack yet: registers only
+ */
+void Memory_Paint(void) __attribute__((naked, used, section(".init1")));
+void Memory_Paint(void)
+{
+	__asm__ __volatile__(
+		"ldi r30, lo8(__heap_start)		\n\t"
+		"ldi r31, hi8(__heap_start)		\n\t"
+		"ldi r24, %[canary]				\n\t"
+		"ldi r25, %[end_high]			\n\t"
+		"1:								\n\t"
+		"st Z+, r24						\n\t"
+		"cpi r30, %[end_low]			\n\t"
+		"cpc r31, r25					\n\t"
+		"brlo 1b						\n\t"
+		:
+		: [canary] "M" (MEMORY_CANARY), [end_low] "M" ((RAMEND + 1) & 0xFF), [end_high] "M" ((RAMEND + 1) >> 8)
+		: "r24", "r25", "r30", "r31");
+}
+#endif // INCLUDE_MEMORY_USAGE
+
+/*
+ * @name	memory_HeapTop
+ * @brief	First byte above the heap: the break, __heap_start as long as malloc() has not been used
+ */
+static uint8_t* memory_HeapTop(void)
+{
+	uint8_t *top = MEMORY_BREAK;
+
+	return (top != NULL) ? top : MEMORY_HEAP_START;
+}
+
+/*
+ * @name	Memory_Init
+ * @brief	Sets up the collision check
+ * @param	hook - called once, from Memory_Check(), when the guard is overwritten. NULL if not needed
+ * @note	On the host the free SRAM is painted here, on the target it has been painted in .init1
+ */
+void Memory_Init(Memory_CollisionHookType hook)
+{
+#if defined(HOST_BUILD)
+	uint8_t *byte;
+
+	for(byte = memory_HeapTop(); byte <= MEMORY_STACK_POINTER; byte++)
+		*byte = MEMORY_CANARY;
+#endif // HOST_BUILD
+
+	gMemory_CollisionHook = hook;
+	gMemory_Collided = 0;
+	gMemory_HeapPeak = memory_HeapTop();
+
+#if (MEMORY_CHECK_TIMER > 0)
+	TIMER2_StartFreeRunning();
+	REG_WRITE(TIFR2, TIMER2_OVERFLOW_INTERRUPT);	// clear a pending overflow
+	REG_SET(TIMSK2, TIMER2_OVERFLOW_INTERRUPT);
+#endif // MEMORY_CHECK_TIMER
+}
+
+/*
+ * @name	Memory_GetUsage
+ * @brief	Measures the heap and the stack
+ * @param	usage - destination
+ * @note	Walks over the free SRAM (about 6 cycles per byte), the interrupts stay enabled
+ */
+void Memory_GetUsage(Memory_UsageType *usage)
+{
+	uint8_t *start = MEMORY_HEAP_START;
+	uint8_t *end = MEMORY_END;
+	uint8_t *top = memory_HeapTop();
+	uint8_t *sp = MEMORY_STACK_POINTER;
+	uint8_t *heapPeak, *stackPeak;
+
+	for(heapPeak = top; (heapPeak <= sp) && (*heapPeak != MEMORY_CANARY); heapPeak++)
+		;
+	for(stackPeak = heapPeak; (stackPeak <= sp) && (*stackPeak == MEMORY_CANARY); stackPeak++)
+		;
+
+	usage->Break = (uint16_t)(uintptr_t)MEMORY_BREAK;
+	usage->HeapUsed = top - start;
+	usage->HeapPeak = heapPeak - start;
+	usage->StackUsed = end - sp;
+	usage->StackPeak = end - stackPeak + 1;
+	usage->Free = sp - top + 1;
+	usage->Untouched = stackPeak - heapPeak;
+	usage->Collided = gMemory_Collided;
+}
+
+/*
+ * @name	Memory_Check
+ * @brief	Checks that the guard above the heap still holds the paint
+ * @retval	0x00 - Guard is intact
+ *			0x01 - Stack and heap have come closer than MEMORY_GUARD_SIZE bytes (now or before)
+ * @note	Safe to be called from the ISRs, about 10 cycles per guard byte. The heap peak is
+ *			moved up over the bytes the heap has used since the previous call.
+ */
+uint8_t Memory_Check(void)
+{
+	uint8_t *top = memory_HeapTop();
+	uint8_t *sp = MEMORY_STACK_POINTER;
+	uint8_t *guard;
+	uint16_t left;
+
+	if(gMemory_Collided)
+		return 0x01;
+
+	if(gMemory_HeapPeak < top)
+		gMemory_HeapPeak = top;
+	while((gMemory_HeapPeak <= sp) && (*gMemory_HeapPeak != MEMORY_CANARY))
+		gMemory_HeapPeak++;
+
+	if(sp >= gMemory_HeapPeak + MEMORY_GUARD_SIZE)
+	{
+		for(guard = gMemory_HeapPeak; guard < gMemory_HeapPeak + MEMORY_GUARD_SIZE; guard++)
+		{
+			if(*guard != MEMORY_CANARY)
+				break;
+		}
+		if(guard == gMemory_HeapPeak + MEMORY_GUARD_SIZE)
+			return 0x00;
+	}
+
+	left = (sp >= top) ? (uint16_t)(sp - top + 1) : 0;
+	gMemory_Collided = 1;
+	TRACE(eTRACE_MEMORY, 0, left);
+	if(gMemory_CollisionHook != NULL)
+		gMemory_CollisionHook(left);
+
+	return 0x01;
+}
+
+/*
+ * @name	Memory_Dump
+ * @brief	Prints the usage of the SRAM
+ * @param	stream - e.g. Print_GetConsole() or a USART stream
+ */
+void Memory_Dump(Print_StreamType *stream)
+{
+	Memory_UsageType usage;
+
+	Memory_GetUsage(&usage);
+	PRINT_TO(stream, "\n\rSRAM heap ", PRINT_D((int32_t)usage.HeapUsed), PRINT_LIT(" (peak "), PRINT_D((int32_t)usage.HeapPeak),
+			 PRINT_LIT(") stack "), PRINT_D((int32_t)usage.StackUsed), PRINT_LIT(" (peak "), PRINT_D((int32_t)usage.StackPeak),
+			 PRINT_LIT(") free "), PRINT_D((int32_t)usage.Free), PRINT_LIT(" untouched "), PRINT_D((int32_t)usage.Untouched),
+			 PRINT_LIT(" break "), PRINT_X((uint32_t)usage.Break));
+	if(usage.Collided)
+		PRINT_TO(stream, "\n\rSRAM guard has been hit!");
+	PRINT_TO(stream, "\n\r");
+}
+
+#if (MEMORY_CHECK_TIMER > 0)
+/*
+ * @name	TIMER2_OVF_IRQHandler()
+ * @brief	Periodic collision check, every 256 ticks of Timer2
+ */
+TIMER2_OVF_IRQHandler()
+{
+	Memory_Check();
+}
+#endif // MEMORY_CHECK_TIMER
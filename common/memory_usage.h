@@ -0,0 +1,56 @@
+/**
+  ******************************************************************************
+  * @file    memory_usage.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Header for memory_usage.c, stack and heap high-water marks of the SRAM
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MEMORY_USAGE_H
+#define __MEMORY_USAGE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "printf_code.h"
+
+/* Exported constants --------------------------------------------------------*/
+#ifndef INCLUDE_MEMORY_USAGE
+#define INCLUDE_MEMORY_USAGE		0
+#endif // INCLUDE_MEMORY_USAGE
+
+#ifndef MEMORY_CHECK_TIMER
+#define MEMORY_CHECK_TIMER			0			// 1 -> Memory_Check() from the Timer2 overflow ISR
+#endif
+
+#define MEMORY_CANARY				0xC5		// paint of the free SRAM
+
+#ifndef MEMORY_GUARD_SIZE
+#define MEMORY_GUARD_SIZE			32			// painted bytes kept between the heap and the stack
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+typedef void (*Memory_CollisionHookType)(uint16_t);	// free bytes left when the guard was hit
+
+typedef struct
+{
+	uint16_t	Break;			// __brkval, 0 as long as malloc() has not been used
+	uint16_t	HeapUsed;		// bytes from __heap_start upto the break
+	uint16_t	HeapPeak;		// high-water of the heap
+	uint16_t	StackUsed;		// bytes below RAMEND now
+	uint16_t	StackPeak;		// high-water of the stack
+	uint16_t	Free;			// bytes between the heap and the stack now
+	uint16_t	Untouched;		// bytes which have kept their paint since the reset
+	uint8_t		Collided;		// Memory_Check() has found the guard overwritten
+}Memory_UsageType;
+
+/* Exported functions ------------------------------------------------------- */
+extern void Memory_Init(Memory_CollisionHookType hook);
+extern void Memory_GetUsage(Memory_UsageType *usage);
+extern uint8_t Memory_Check(void);
+extern void Memory_Dump(Print_StreamType *stream);
+
+#endif // __MEMORY_USAGE_H
@@ -0,0 +1,447 @@
+/**
+  ******************************************************************************
+  * @file    modbus_rtu.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file is having a Modbus RTU slave: function codes 01, 02, 03, 04, 05, 06,
+  *			 15 and 16 served straight from the coils and registers of the application.
+  * @note	 Everything runs in the ISRs, the main loop is not involved:
+  *			 + receive: idle line framing of the USART (atmega644p_usart_idle.c), a request ends
+  *			   after 3.5 characters of silence (MODBUS_FAST_T35 above 19200 baud).
+  *			 + the Timer2 ISR which closes the request checks the address and the CRC
+  *			   (CRC16/MODBUS, table driven, crc16.c) and builds the response in place, in the
+  *			   buffer of the request, so there is no copy of the frame.
+  *			 + transmit: the response is sent by the UDRE ISR (USART_StartTransmitSource()), its
+  *			   CRC is added byte by byte while sending. The first byte of the response is in UDR
+  *			   right after the request has been decoded, the buffer is given back to the receiver
+  *			   in the TXC ISR.
+  *			 Registers and coils are read/written by the ISR, the application has to update the
+  *			 16 bit registers with the interrupts disabled if a torn value matters.
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Configure the USART with USARTInit() (8 data bits, even parity is the Modbus default) and enable the
+  *    receive interrupt. For RS-485 call USART_EnableRS485() as well.
+  * 2. Fill a Modbus_MapType with the coils, inputs and registers of the application (NULL/0 for the unused ones)
+  * 3. Call Modbus_Init() with the USART, the slave address and the map, then enable the global interrupts
+  * 4. Optionally the Written hook of the map tells the application what the master has changed
+  * 5. Modbus_GetStatistics() for the diagnostic counters
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/interrupt.h>
+#include "modbus_rtu.h"
+#include "crc16.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define MODBUS_MIN_ADU				4			// address, function code and CRC
+#define MODBUS_MAX_READ_BITS		2000
+#define MODBUS_MAX_READ_REGISTERS	125
+#define MODBUS_MAX_WRITE_BITS		1968
+#define MODBUS_MAX_WRITE_REGISTERS	123
+#define MODBUS_COIL_ON				0xFF00
+#define MODBUS_COIL_OFF				0x0000
+
+/* Typedefs ------------------------------------------------------------------*/
+typedef struct
+{
+	uint8_t					Buffer[2][MODBUS_RTU_MAX_ADU];	// double buffer of the idle line framing
+	uint8_t					Port;
+	uint8_t					Address;
+	const Modbus_MapType	*Map;
+	const uint8_t			*Response;		// buffer of the request, the response is built in place
+	uint16_t				Length;			// bytes of the response without the CRC
+	uint16_t				Index;
+	uint16_t				CRC;
+	Modbus_StatisticsType	Statistics;
+}Modbus_SlaveType;
+
+/* Global Variables ----------------------------------------------------------*/
+static Modbus_SlaveType gModbus;
+
+/* Functions -----------------------------------------------------------------*/
+
+/*
+ * @name	Modbus_Word
+ * @brief	16 bit field of the frame, high byte first
+ */
+static inline uint16_t Modbus_Word(const uint8_t *data)
+{
+	return ((uint16_t)data[0] << 8) | data[1];
+}
+
+/*
+ * @name	Modbus_InRange
+ * @brief	Checks that count items from address are within a table of size items
+ */
+static inline uint8_t Modbus_InRange(uint16_t address, uint16_t count, uint16_t size)
+{
+	return ((uint32_t)address + count <= size) ? 0x01 : 0x00;
+}
+
+/*
+ * @name	Modbus_GetBit
+ * @brief	Bit of a bit packed table
+ */
+static inline uint8_t Modbus_GetBit(const uint8_t *bits, uint16_t index)
+{
+	return (bits[index >> 3] >> (index & 0x07)) & 0x01;
+}
+
+/*
+ * @name	Modbus_SetBit
+ * @brief	Writes a bit of a bit packed table
+ */
+static inline void Modbus_SetBit(uint8_t *bits, uint16_t index, uint8_t value)
+{
+	if(value)
+		bits[index >> 3] |= (1 << (index & 0x07));
+	else
+		bits[index >> 3] &= ~(1 << (index & 0x07));
+}
+
+/*
+ * @name	Modbus_ReadBits
+ * @brief	Function codes 01 and 02, the bits are packed into the response from adu[3]
+ * @retval	length of the response, 0 -> exception code in *exception
+ */
+static uint16_t Modbus_ReadBits(uint8_t *adu, const uint8_t *bits, uint16_t size, uint8_t *exception)
+{
+	uint16_t address = Modbus_Word(&adu[2]);
+	uint16_t count = Modbus_Word(&adu[4]);
+	uint8_t bytes = (count + 7) >> 3;
+	uint16_t i;
+
+	if((count == 0) || (count > MODBUS_MAX_READ_BITS))
+	{
+		*exception = MODBUS_ILLEGAL_DATA_VALUE;
+		return 0;
+	}
+	if(!Modbus_InRange(address, count, size))
+	{
+		*exception = MODBUS_ILLEGAL_DATA_ADDRESS;
+		return 0;
+	}
+
+	adu[2] = bytes;
+	for(i = 0; i < bytes; i++)
+		adu[3 + i] = 0x00;
+	for(i = 0; i < count; i++)
+	{
+		if(Modbus_GetBit(bits, address + i))
+			adu[3 + (i >> 3)] |= (1 << (i & 0x07));
+	}
+	return 3 + bytes;
+}
+
+/*
+ * @name	Modbus_ReadRegisters
+ * @brief	Function codes 03 and 04, the registers are copied into the response from adu[3]
+ * @retval	length of the response, 0 -> exception code in *exception
+ */
+static uint16_t Modbus_ReadRegisters(uint8_t *adu, const uint16_t *registers, uint16_t size, uint8_t *exception)
+{
+	uint16_t address = Modbus_Word(&adu[2]);
+	uint16_t count = Modbus_Word(&adu[4]);
+	uint8_t *data = &adu[3];
+	uint16_t i;
+
+	if((count == 0) || (count > MODBUS_MAX_READ_REGISTERS))
+	{
+		*exception = MODBUS_ILLEGAL_DATA_VALUE;
+		return 0;
+	}
+	if(!Modbus_InRange(address, count, size))
+	{
+		*exception = MODBUS_ILLEGAL_DATA_ADDRESS;
+		return 0;
+	}
+
+	adu[2] = count << 1;
+	for(i = 0; i < count; i++)
+	{
+		*data++ = registers[address + i] >> 8;
+		*data++ = registers[address + i] & 0xFF;
+	}
+	return 3 + (count << 1);
+}
+
+/*
+ * @name	Modbus_WriteSingle
+ * @brief	Function codes 05 and 06, the response is the echo of the request
+ * @retval	length of the response, 0 -> exception code in *exception
+ */
+static uint16_t Modbus_WriteSingle(uint8_t *adu, const Modbus_MapType *map, uint8_t *exception)
+{
+	uint16_t address = Modbus_Word(&adu[2]);
+	uint16_t value = Modbus_Word(&adu[4]);
+
+	if(adu[1] == MODBUS_WRITE_SINGLE_COIL)
+	{
+		if((value != MODBUS_COIL_ON) && (value != MODBUS_COIL_OFF))
+		{
+			*exception = MODBUS_ILLEGAL_DATA_VALUE;
+			return 0;
+		}
+		if(address >= map->CoilCount)
+		{
+			*exception = MODBUS_ILLEGAL_DATA_ADDRESS;
+			return 0;
+		}
+		Modbus_SetBit(map->Coils, address, value == MODBUS_COIL_ON);
+	}
+	else
+	{
+		if(address >= map->HoldingRegisterCount)
+		{
+			*exception = MODBUS_ILLEGAL_DATA_ADDRESS;
+			return 0;
+		}
+		map->HoldingRegisters[address] = value;
+	}
+
+	if(map->Written != NULL)
+		map->Written(adu[1], address, 1);
+	return 6;
+}
+
+/*
+ * @name	Modbus_WriteMultiple
+ * @brief	Function codes 15 and 16, the response is the address and the count of the request
+ * @retval	length of the response, 0 -> exception code in *exception
+ */
+static uint16_t Modbus_WriteMultiple(uint8_t *adu, uint16_t length, const Modbus_MapType *map, uint8_t *exception)
+{
+	uint16_t address = Modbus_Word(&adu[2]);
+	uint16_t count = Modbus_Word(&adu[4]);
+	const uint8_t *data = &adu[7];
+	uint16_t bytes, size, maximum, i;
+
+	if(adu[1] == MODBUS_WRITE_MULTIPLE_COILS)
+	{
+		bytes = (count + 7) >> 3;
+		size = map->CoilCount;
+		maximum = MODBUS_MAX_WRITE_BITS;
+	}
+	else
+	{
+		bytes = count << 1;
+		size = map->HoldingRegisterCount;
+		maximum = MODBUS_MAX_WRITE_REGISTERS;
+	}
+
+	if((length < 7) || (count == 0) || (count > maximum) || (adu[6] != bytes) || (length != 7 + bytes))
+	{
+		*exception = MODBUS_ILLEGAL_DATA_VALUE;
+		return 0;
+	}
+	if(!Modbus_InRange(address, count, size))
+	{
+		*exception = MODBUS_ILLEGAL_DATA_ADDRESS;
+		return 0;
+	}
+
+	if(adu[1] == MODBUS_WRITE_MULTIPLE_COILS)
+	{
+		for(i = 0; i < count; i++)
+			Modbus_SetBit(map->Coils, address + i, Modbus_GetBit(data, i));
+	}
+	else
+	{
+		for(i = 0; i < count; i++, data += 2)
+			map->HoldingRegisters[address + i] = Modbus_Word(data);
+	}
+
+	if(map->Written != NULL)
+		map->Written(adu[1], address, count);
+	return 6;
+}
+
+/*
+ * @name	Modbus_Process
+ * @brief	Executes a request and builds the response in its buffer
+ * @param	adu    - request: address, function code and data, without the CRC
+ *			length - bytes of the request without the CRC
+ * @retval	length of the response without the CRC
+ */
+static uint16_t Modbus_Process(uint8_t *adu, uint16_t length)
+{
+	const Modbus_MapType *map = gModbus.Map;
+	uint8_t exception = MODBUS_ILLEGAL_DATA_VALUE;
+	uint16_t response = 0;
+
+	switch(adu[1])
+	{
+		case MODBUS_READ_COILS:
+			if(length == 6)
+				response = Modbus_ReadBits(adu, map->Coils, map->CoilCount, &exception);
+			break;
+
+		case MODBUS_READ_DISCRETE_INPUTS:
+			if(length == 6)
+				response = Modbus_ReadBits(adu, map->DiscreteInputs, map->DiscreteInputCount, &exception);
+			break;
+
+		case MODBUS_READ_HOLDING_REGISTERS:
+			if(length == 6)
+				response = Modbus_ReadRegisters(adu, map->HoldingRegisters, map->HoldingRegisterCount, &exception);
+			break;
+
+		case MODBUS_READ_INPUT_REGISTERS:
+			if(length == 6)
+				response = Modbus_ReadRegisters(adu, map->InputRegisters, map->InputRegisterCount, &exception);
+			break;
+
+		case MODBUS_WRITE_SINGLE_COIL:
+		case MODBUS_WRITE_SINGLE_REGISTER:
+			if(length == 6)
+				response = Modbus_WriteSingle(adu, map, &exception);
+			break;
+
+		case MODBUS_WRITE_MULTIPLE_COILS:
+		case MODBUS_WRITE_MULTIPLE_REGISTERS:
+			response = Modbus_WriteMultiple(adu, length, map, &exception);
+			break;
+
+		default:
+			exception = MODBUS_ILLEGAL_FUNCTION;
+			break;
+	}
+
+	if(response == 0)
+	{
+		adu[1] |= MODBUS_EXCEPTION;
+		adu[2] = exception;
+		response = 3;
+		gModbus.Statistics.Exceptions++;
+	}
+	return response;
+}
+
+/*
+ * @name	Modbus_TransmitSource
+ * @brief	Transmit source of the USART (UDRE ISR): the response followed by its CRC, low byte first
+ * @retval	1 with the last byte, 0 otherwise
+ */
+static uint8_t Modbus_TransmitSource(uint8_t port, uint8_t *data)
+{
+	(void)port;
+	if(gModbus.Index < gModbus.Length)
+	{
+		*data = gModbus.Response[gModbus.Index++];
+		gModbus.CRC = CRC16_ModbusUpdate(gModbus.CRC, *data);
+		return 0;
+	}
+	if(gModbus.Index++ == gModbus.Length)
+	{
+		*data = gModbus.CRC & 0xFF;
+		return 0;
+	}
+	*data = gModbus.CRC >> 8;
+	return 1;
+}
+
+/*
+ * @name	Modbus_TransmitComplete
+ * @brief	TXC ISR after the response: the buffer of the request goes back to the receiver
+ */
+static void Modbus_TransmitComplete(uint8_t port)
+{
+	USART_ReleaseIdleFrame(port);
+}
+
+/*
+ * @name	Modbus_FrameReceived
+ * @brief	Idle line hook (Timer2 ISR): checks the request and starts the response
+ */
+static void Modbus_FrameReceived(uint8_t port)
+{
+	uint16_t length;
+	uint8_t status;
+	uint8_t *adu = (uint8_t *)USART_ReceiveIdleFrame(port, &length, &status);		// gModbus.Buffer, owned by this module
+
+	if(adu == NULL)
+		return;
+
+	if(status & USART_IDLE_FRAME_OVERFLOW)
+	{
+		gModbus.Statistics.Overruns++;
+	}
+	else if((status & USART_IDLE_FRAME_LINE_ERROR) || (length < MODBUS_MIN_ADU))
+	{
+		gModbus.Statistics.CRCErrors++;
+	}
+	else if((adu[0] == gModbus.Address) || (adu[0] == MODBUS_BROADCAST_ADDRESS))
+	{
+		//Other slaves are filtered before the CRC, only the own requests cost the CRC
+		if(CRC16_ModbusCompute(CRC16_MODBUS_INIT, adu, length) != CRC16_MODBUS_RESIDUE)
+		{
+			gModbus.Statistics.CRCErrors++;
+		}
+		else
+		{
+			gModbus.Statistics.Requests++;
+			length = Modbus_Process(adu, length - MODBUS_CRC_SIZE);
+			if(adu[0] != MODBUS_BROADCAST_ADDRESS)
+			{
+				gModbus.Response = adu;
+				gModbus.Length = length;
+				gModbus.Index = 0;
+				gModbus.CRC = CRC16_MODBUS_INIT;
+				if(USART_StartTransmitSource(port, Modbus_TransmitSource, Modbus_TransmitComplete) == 0x00)
+					return;							// buffer is released by Modbus_TransmitComplete()
+				gModbus.Statistics.Overruns++;
+			}
+		}
+	}
+	USART_ReleaseIdleFrame(port);
+}
+
+/*
+ * @name	Modbus_Init
+ * @brief	Starts the slave on a USART
+ * @param	port    - USART0 or USART1, configured with USARTInit()
+ *			address - slave address, 1 to MODBUS_MAX_SLAVE_ADDRESS
+ *			map     - coils, inputs and registers of the application, has to stay valid
+ * @retval	0x00 - slave is running
+ *			0x01 - wrong address or no map
+ * @note	Replaces the receive hook of the USART, uses the Timer2 compare unit of the USART
+ */
+uint8_t Modbus_Init(uint8_t port, uint8_t address, const Modbus_MapType *map)
+{
+	USART_BaudType baud;
+	uint8_t sreg = SREG;
+
+	if((address == MODBUS_BROADCAST_ADDRESS) || (address > MODBUS_MAX_SLAVE_ADDRESS) || (map == NULL))
+		return 0x01;
+
+	cli();
+	gModbus.Port = port & 0x01;
+	gModbus.Address = address;
+	gModbus.Map = map;
+	gModbus.Statistics.Requests = 0;
+	gModbus.Statistics.CRCErrors = 0;
+	gModbus.Statistics.Exceptions = 0;
+	gModbus.Statistics.Overruns = 0;
+	SREG = sreg;
+
+	USART_GetBaud(gModbus.Port, &baud);
+	USART_EnableIdleFrames(gModbus.Port, gModbus.Buffer[0], gModbus.Buffer[1], MODBUS_RTU_MAX_ADU,
+			(baud.BaudRate > MODBUS_FAST_BAUD_RATE) ? MODBUS_FAST_T35 : 0, Modbus_FrameReceived);
+	return 0x00;
+}
+
+/*
+ * @name	Modbus_GetStatistics
+ * @brief	Copies the counters of the slave
+ */
+void Modbus_GetStatistics(Modbus_StatisticsType *statistics)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	*statistics = gModbus.Statistics;
+	SREG = sreg;
+}
@@ -0,0 +1,76 @@
+/**
+  ******************************************************************************
+  * @file    modbus_rtu.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Header for modbus_rtu.c, Modbus RTU slave on a USART
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MODBUS_RTU_H
+#define __MODBUS_RTU_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdlib.h>
+#include "atmega644p_usart.h"
+
+/* Exported constants --------------------------------------------------------*/
+#ifndef MODBUS_RTU_MAX_ADU
+#define MODBUS_RTU_MAX_ADU				256			// bytes of a request/response: address, PDU and CRC
+#endif
+
+#define MODBUS_BROADCAST_ADDRESS		0x00		// writes are executed by every slave, no response
+#define MODBUS_MAX_SLAVE_ADDRESS		247
+#define MODBUS_CRC_SIZE					2
+#define MODBUS_FAST_BAUD_RATE			19200		// above this rate the inter-frame delay is fixed
+#define MODBUS_FAST_T35					1750		// us, inter-frame delay above MODBUS_FAST_BAUD_RATE
+
+//Function codes
+#define MODBUS_READ_COILS				0x01
+#define MODBUS_READ_DISCRETE_INPUTS		0x02
+#define MODBUS_READ_HOLDING_REGISTERS	0x03
+#define MODBUS_READ_INPUT_REGISTERS		0x04
+#define MODBUS_WRITE_SINGLE_COIL		0x05
+#define MODBUS_WRITE_SINGLE_REGISTER	0x06
+#define MODBUS_WRITE_MULTIPLE_COILS		0x0F
+#define MODBUS_WRITE_MULTIPLE_REGISTERS	0x10
+
+//Exception codes, the function code of an exception response has MODBUS_EXCEPTION set
+#define MODBUS_EXCEPTION				0x80
+#define MODBUS_ILLEGAL_FUNCTION			0x01
+#define MODBUS_ILLEGAL_DATA_ADDRESS		0x02
+#define MODBUS_ILLEGAL_DATA_VALUE		0x03
+
+/* Exported types ------------------------------------------------------------*/
+typedef void (*Modbus_WrittenHookType)(uint8_t, uint16_t, uint16_t);	// function code, first address and count written by the master
+
+typedef struct
+{
+	const uint8_t		*DiscreteInputs;		// bit packed, input 0 is bit 0 of the first byte
+	uint16_t			DiscreteInputCount;
+	uint8_t				*Coils;					// bit packed as the discrete inputs
+	uint16_t			CoilCount;
+	const uint16_t		*InputRegisters;
+	uint16_t			InputRegisterCount;
+	uint16_t			*HoldingRegisters;
+	uint16_t			HoldingRegisterCount;
+	Modbus_WrittenHookType	Written;			// called from the ISR after coils or registers have been written, can be NULL
+}Modbus_MapType;
+
+typedef struct
+{
+	uint16_t	Requests;		// requests to this slave (or broadcast) with a correct CRC
+	uint16_t	CRCErrors;		// frames with a wrong CRC, a line error or shorter than 4 bytes
+	uint16_t	Exceptions;		// exception responses sent
+	uint16_t	Overruns;		// frames longer than MODBUS_RTU_MAX_ADU, or received while the response was still sent
+}Modbus_StatisticsType;
+
+/* Exported functions ------------------------------------------------------- */
+extern uint8_t Modbus_Init(uint8_t port, uint8_t address, const Modbus_MapType *map);
+extern void Modbus_GetStatistics(Modbus_StatisticsType *statistics);
+
+#endif // __MODBUS_RTU_H
@@ -0,0 +1,324 @@
+/**
+  ******************************************************************************
+  * @file    mux.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file is having the logical channels of one USART: logs, console and
+  *			 telemetry share the debug link without corrupting each other.
+  *			 Every channel is a byte stream with its own transmit queue. The bytes go out
+  *			 in frames of frame.c (COBS, CRC16, 0x00 delimiter) whose first payload byte
+  *			 is the channel: Frame on the line: COBS(channel, data, CRC) 0x00
+  * @note	 Scheduling: when a frame has been sent (TXC ISR), the next one is taken from the
+  *			 channel with the highest priority which has queued data, channels of the same
+  *			 priority take turns. A frame carries at most MUX_MAX_PAYLOAD bytes, so a high
+  *			 priority channel waits at most for one frame of a lower one while the low priority
+  *			 channels fill the remaining bandwidth.
+  *			 tools/mux_demux.c splits the stream again on the host side.
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Configure the USART with USARTInit(), 8 data bits, and enable the receive interrupt
+  * 2. Call Mux_Init() with the USART and optionally a hook called from the ISR when data for a channel is ready
+  * 3. Mux_OpenChannel() for every channel with its queue (power of 2, upto 256 bytes) and priority (higher is first)
+  * 4. Mux_Write() queues a block of bytes, all or nothing, Mux_PutChar() one byte and waits while the queue is full
+  * 5. Mux_Receive() returns the data of a received frame and its channel (no copy), call Mux_Release() when done with it
+  * 6. The USART belongs to the multiplexer: do not send with USART_PutChar()/print() on it any more
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/interrupt.h>
+#include "mux.h"
+
+/* Typedefs ------------------------------------------------------------------*/
+typedef struct
+{
+	uint8_t				*Buffer;
+	uint8_t				Mask;			// size - 1
+	volatile uint8_t	Head;			// written by Mux_Write()
+	volatile uint8_t	Tail;			// written by the scheduler
+	uint8_t				Priority;
+	uint8_t				Open;
+	Mux_StatisticsType	Statistics;
+}Mux_ChannelType;
+
+typedef struct
+{
+	uint8_t				Port;
+	volatile uint8_t	Busy;			// a frame is being sent
+	uint8_t				Last;			// channel of the last frame
+	uint8_t				Frame[MUX_MAX_PAYLOAD + 1];
+	Mux_ReceivedHookType Hook;
+	Mux_ChannelType		Channel[MUX_MAX_CHANNELS];
+}Mux_Type;
+
+/* Global Variables ----------------------------------------------------------*/
+static Mux_Type gMux;
+
+/* Functions -----------------------------------------------------------------*/
+
+/*
+ * @name	Mux_Queued
+ * @brief	Number of bytes in the queue of a channel
+ */
+static inline uint8_t Mux_Queued(const Mux_ChannelType *channel)
+{
+	return (channel->Head - channel->Tail) & channel->Mask;
+}
+
+/*
+ * @name	Mux_Select
+ * @brief	Channel of the next frame: highest priority with queued data, round robin between equal priorities
+ * @retval	channel, MUX_MAX_CHANNELS if nothing is queued
+ */
+static uint8_t Mux_Select(void)
+{
+	uint8_t selected = MUX_MAX_CHANNELS;
+	uint8_t i, index;
+
+	for(i = 1; i <= MUX_MAX_CHANNELS; i++)
+	{
+		index = (gMux.Last + i) % MUX_MAX_CHANNELS;		// starts after the last one
+		if(!gMux.Channel[index].Open || (Mux_Queued(&gMux.Channel[index]) == 0))
+			continue;
+		if((selected == MUX_MAX_CHANNELS) || (gMux.Channel[index].Priority > gMux.Channel[selected].Priority))
+			selected = index;
+	}
+	return selected;
+}
+
+static void Mux_Sent(uint8_t port);
+
+/*
+ * @name	Mux_Schedule
+ * @brief	Starts the next frame if the link is idle
+ * @note	Called with the interrupts disabled. The frame is copied out of the queue, so the queue
+ *			is free again while the frame is on the line.
+ */
+static void Mux_Schedule(void)
+{
+	Mux_ChannelType *channel;
+	uint8_t selected, length;
+
+	if(gMux.Busy || USART_IsTransmitBusy(gMux.Port))
+		return;											// the next write or the end of the frame tries again
+	selected = Mux_Select();
+	if(selected == MUX_MAX_CHANNELS)
+		return;
+
+	channel = &gMux.Channel[selected];
+	gMux.Frame[0] = selected;
+	for(length = 0; (length < MUX_MAX_PAYLOAD) && (channel->Tail != channel->Head); length++)
+	{
+		gMux.Frame[length + 1] = channel->Buffer[channel->Tail];
+		channel->Tail = (channel->Tail + 1) & channel->Mask;
+	}
+
+	if(Frame_Send(gMux.Port, gMux.Frame, length + 1, Mux_Sent) == 0x00)
+	{
+		gMux.Busy = 1;
+		gMux.Last = selected;
+		channel->Statistics.Frames++;
+	}
+}
+
+/*
+ * @name	Mux_Sent
+ * @brief	Transmit complete hook of the frames (TXC ISR), schedules the next frame
+ */
+static void Mux_Sent(uint8_t port)
+{
+	(void)port;
+	gMux.Busy = 0;
+	Mux_Schedule();
+}
+
+/*
+ * @name	Mux_FrameReceived
+ * @brief	Frame hook (receive ISR), drops frames without data and gives the channel to the application hook
+ */
+static void Mux_FrameReceived(uint8_t port)
+{
+	const uint8_t *frame;
+	uint8_t length;
+
+	frame = Frame_Receive(port, &length);
+	if((length < 2) || (frame[0] >= MUX_MAX_CHANNELS))
+	{
+		Frame_Release(port);
+		return;
+	}
+	if(gMux.Hook != NULL)
+		gMux.Hook(frame[0]);
+}
+
+/*
+ * @name	Mux_Init
+ * @brief	Starts the multiplexer on a USART, all channels are closed
+ * @param	port - USART0 or USART1
+ *			hook - called from the receive ISR when a frame for a channel is ready, can be NULL
+ * @note	Replaces the receive hook of the USART (Frame_Init())
+ */
+void Mux_Init(uint8_t port, Mux_ReceivedHookType hook)
+{
+	uint8_t sreg = SREG;
+	uint8_t i;
+
+	cli();
+	gMux.Port = port & 0x01;
+	gMux.Busy = 0;
+	gMux.Last = MUX_MAX_CHANNELS - 1;
+	gMux.Hook = hook;
+	for(i = 0; i < MUX_MAX_CHANNELS; i++)
+		gMux.Channel[i].Open = 0;
+	SREG = sreg;
+
+	Frame_Init(port & 0x01, Mux_FrameReceived);
+}
+
+/*
+ * @name	Mux_OpenChannel
+ * @brief	Gives a transmit queue and a priority to a channel
+ * @param	channel  - 0 to MUX_MAX_CHANNELS - 1
+ *			buffer   - queue of the channel
+ *			size     - 2, 4 ... 256 bytes, one byte of it stays unused
+ *			priority - higher value is sent first
+ * @retval	0x00 - channel is open
+ *			0x02 - wrong channel or size
+ */
+uint8_t Mux_OpenChannel(uint8_t channel, uint8_t *buffer, uint16_t size, uint8_t priority)
+{
+	Mux_ChannelType *mux = &gMux.Channel[channel];
+	uint8_t sreg = SREG;
+
+	if((channel >= MUX_MAX_CHANNELS) || (buffer == NULL) || (size < 2) || (size > 256) || (size & (size - 1)))
+		return 0x02;
+
+	cli();
+	mux->Buffer = buffer;
+	mux->Mask = size - 1;
+	mux->Head = 0;
+	mux->Tail = 0;
+	mux->Priority = priority;
+	mux->Statistics.Frames = 0;
+	mux->Statistics.Dropped = 0;
+	mux->Open = 1;
+	SREG = sreg;
+	return 0x00;
+}
+
+/*
+ * @name	Mux_Write
+ * @brief	Queues bytes on a channel and starts sending if the link is idle
+ * @param	channel - open channel
+ *			data    - bytes, copied into the queue
+ *			length  - number of bytes
+ * @note	All or nothing: a telemetry record is never cut by a full queue. Dropped bytes are counted.
+ * @retval	0x00 - queued
+ *			0x01 - not enough room in the queue, nothing queued
+ *			0x02 - channel is not open
+ */
+uint8_t Mux_Write(uint8_t channel, const uint8_t *data, uint16_t length)
+{
+	Mux_ChannelType *mux = &gMux.Channel[channel];
+	uint8_t head;
+	uint8_t sreg;
+
+	if((channel >= MUX_MAX_CHANNELS) || !mux->Open)
+		return 0x02;
+	if(length > (uint16_t)(mux->Mask - Mux_Queued(mux)))
+	{
+		sreg = SREG;
+		cli();
+		mux->Statistics.Dropped += length;
+		SREG = sreg;
+		return 0x01;
+	}
+
+	head = mux->Head;
+	while(length--)
+	{
+		mux->Buffer[head] = *data++;
+		head = (head + 1) & mux->Mask;
+	}
+
+	sreg = SREG;
+	cli();
+	mux->Head = head;						// the scheduler sees the whole block at once
+	Mux_Schedule();
+	SREG = sreg;
+	return 0x00;
+}
+
+/*
+ * @name	Mux_PutChar
+ * @brief	Queues one byte on a channel, waits while the queue is full
+ * @note	Global interrupts have to be enabled. Do not call it from an ISR.
+ */
+void Mux_PutChar(uint8_t channel, uint8_t data)
+{
+	Mux_ChannelType *mux = &gMux.Channel[channel];
+
+	if(channel >= MUX_MAX_CHANNELS)
+		return;
+	while(mux->Open && (Mux_Queued(mux) == mux->Mask))
+		;												// the TXC ISR makes room
+	Mux_Write(channel, &data, 1);
+}
+
+/*
+ * @name	Mux_Pending
+ * @brief	Number of bytes of a channel which are not sent yet
+ */
+uint16_t Mux_Pending(uint8_t channel)
+{
+	if(channel >= MUX_MAX_CHANNELS)
+		return 0;
+	return Mux_Queued(&gMux.Channel[channel]);
+}
+
+/*
+ * @name	Mux_Receive
+ * @brief	Returns the data of the last received frame
+ * @param	channel - channel of the frame
+ *			length  - number of data bytes
+ * @retval	data, NULL if there is no frame. It is valid until Mux_Release().
+ */
+const uint8_t* Mux_Receive(uint8_t *channel, uint8_t *length)
+{
+	const uint8_t *frame;
+	uint8_t size;
+
+	frame = Frame_Receive(gMux.Port, &size);
+	if(frame == NULL)
+		return NULL;
+
+	*channel = frame[0];
+	*length = size - 1;
+	return &frame[1];
+}
+
+/*
+ * @name	Mux_Release
+ * @brief	Gives the buffer of the frame returned by Mux_Receive() back to the ISR
+ */
+void Mux_Release(void)
+{
+	Frame_Release(gMux.Port);
+}
+
+/*
+ * @name	Mux_GetStatistics
+ * @brief	Copies the counters of a channel
+ */
+void Mux_GetStatistics(uint8_t channel, Mux_StatisticsType *statistics)
+{
+	uint8_t sreg = SREG;
+
+	if(channel >= MUX_MAX_CHANNELS)
+		return;
+	cli();
+	*statistics = gMux.Channel[channel].Statistics;
+	SREG = sreg;
+}
@@ -0,0 +1,58 @@
+/**
+  ******************************************************************************
+  * @file    mux.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Header for mux.c, logical channels multiplexed over one USART
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MUX_H
+#define __MUX_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdlib.h>
+#include "atmega644p_usart.h"
+#include "frame.h"
+
+/* Exported constants --------------------------------------------------------*/
+#ifndef MUX_MAX_CHANNELS
+#define MUX_MAX_CHANNELS		4
+#endif
+#ifndef MUX_MAX_PAYLOAD
+#define MUX_MAX_PAYLOAD			32			// bytes of a channel per frame, bounds the wait of a higher priority channel
+#endif
+
+#if (MUX_MAX_PAYLOAD + 1) > FRAME_MAX_PAYLOAD
+#error "MUX_MAX_PAYLOAD and the channel byte have to fit into FRAME_MAX_PAYLOAD"
+#endif
+
+//Suggested channels of the debug link
+#define MUX_CHANNEL_LOG			0
+#define MUX_CHANNEL_CONSOLE		1
+#define MUX_CHANNEL_TELEMETRY	2
+
+/* Exported types ------------------------------------------------------------*/
+typedef void (*Mux_ReceivedHookType)(uint8_t);		// channel which has received data ready
+
+typedef struct
+{
+	uint16_t	Frames;			// frames sent for the channel
+	uint16_t	Dropped;		// bytes not queued because the queue was full
+}Mux_StatisticsType;
+
+/* Exported functions ------------------------------------------------------- */
+extern void Mux_Init(uint8_t port, Mux_ReceivedHookType hook);
+extern uint8_t Mux_OpenChannel(uint8_t channel, uint8_t *buffer, uint16_t size, uint8_t priority);
+extern uint8_t Mux_Write(uint8_t channel, const uint8_t *data, uint16_t length);
+extern void Mux_PutChar(uint8_t channel, uint8_t data);
+extern uint16_t Mux_Pending(uint8_t channel);
+extern const uint8_t* Mux_Receive(uint8_t *channel, uint8_t *length);
+extern void Mux_Release(void);
+extern void Mux_GetStatistics(uint8_t channel, Mux_StatisticsType *statistics);
+
+#endif // __MUX_H
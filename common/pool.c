@@ -0,0 +1,211 @@
+/**
+  ******************************************************************************
+  * @file    pool.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file is having the fixed-block pool allocator which replaces malloc()/calloc()/free()
+  *			 of the libraries: static blocks in a few size classes, a request gets a block of the
+  *			 smallest class which fits it. Blocks are never split or merged, so the pool cannot
+  *			 fragment and an allocation which works once works after days of uptime as well.
+  * @note	 + Pool_Alloc() and Pool_Free() take a constant time (no search, no division) with the
+  *			   interrupts disabled for a few instructions, they can be used in the ISRs.
+  *			 + A free block keeps the pointer to the next free block in its first bytes. Blocks
+  *			   which have never been used are taken from the end of the class, so no initialisation
+  *			   is needed before the first Pool_Alloc().
+  *			 + When the class of a request is empty the next bigger class is tried. The failure is
+  *			   counted on the class of the request, so its high-water and failures tell how many
+  *			   blocks it needs (POOL_xxx_BLOCKS).
+  *			 + A block which has never been allocated, or freed while no block of the class is in use,
+  *			   is not put on the free list (BadFrees). With POOL_DEBUG=1 the free list is searched as
+  *			   well, which catches every double free but is no longer constant time.
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Pool_Alloc(size) instead of malloc(size), NULL if there is no free block big enough
+  * 2. Pool_Free(block) instead of free(block), NULL and pointers not from the pool are ignored
+  * 3. Pool_GetStatistics(0 .. POOL_CLASSES - 1, &statistics) for the usage of each class
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "pool.h"
+
+/* Typedefs ------------------------------------------------------------------*/
+typedef struct
+{
+	uint8_t		*Memory;		// first block of the class
+	uint8_t		*End;			// behind the last block
+	uint8_t		*Fresh;			// blocks from here on have never been allocated
+	void		*Free;			// list of the freed blocks
+	uint16_t	BlockSize;
+	uint8_t		Blocks;
+	uint8_t		InUse;
+	uint8_t		HighWater;
+	uint16_t	Failures;
+	uint16_t	BadFrees;
+}Pool_ClassType;
+
+/* Global Variables ----------------------------------------------------------*/
+static uint8_t gPool_Small[POOL_SMALL_BLOCKS][POOL_SMALL_SIZE] __attribute__((aligned(sizeof(void *))));
+static uint8_t gPool_Medium[POOL_MEDIUM_BLOCKS][POOL_MEDIUM_SIZE] __attribute__((aligned(sizeof(void *))));
+static uint8_t gPool_Large[POOL_LARGE_BLOCKS][POOL_LARGE_SIZE] __attribute__((aligned(sizeof(void *))));
+
+#define POOL_CLASS(memory, size, blocks)	{ &(memory)[0][0], &(memory)[0][0] + sizeof(memory), &(memory)[0][0], NULL, (size), (blocks), 0, 0, 0, 0 }
+
+static Pool_ClassType gPool_Class[POOL_CLASSES] =
+{
+	POOL_CLASS(gPool_Small, POOL_SMALL_SIZE, POOL_SMALL_BLOCKS),
+	POOL_CLASS(gPool_Medium, POOL_MEDIUM_SIZE, POOL_MEDIUM_BLOCKS),
+	POOL_CLASS(gPool_Large, POOL_LARGE_SIZE, POOL_LARGE_BLOCKS),
+};
+
+#if (POOL_SMALL_SIZE < 8) || (POOL_SMALL_SIZE > POOL_MEDIUM_SIZE) || (POOL_MEDIUM_SIZE > POOL_LARGE_SIZE)
+#error "Pool classes have to be in ascending order and hold at least the free list pointer"
+#endif
+#if (POOL_SMALL_BLOCKS > 254) || (POOL_MEDIUM_BLOCKS > 254) || (POOL_LARGE_BLOCKS > 254)
+#error "Upto 254 blocks per pool class"
+#endif
+
+/* Functions -----------------------------------------------------------------*/
+
+/*
+ * @name	Pool_Alloc
+ * @brief	Allocates a block of the smallest class which fits the size
+ * @param	size - bytes needed
+ * @retval	block, NULL if no class with a free block can hold size bytes
+ * @note	The content of the block is not cleared
+ */
+void* Pool_Alloc(uint16_t size)
+{
+	Pool_ClassType *pool;
+	Pool_ClassType *requested = NULL;
+	uint8_t *block = NULL;
+	uint8_t sreg = SREG;
+
+	cli();
+	for(pool = &gPool_Class[0]; pool < &gPool_Class[POOL_CLASSES]; pool++)
+	{
+		if(size > pool->BlockSize)
+			continue;
+		if(requested == NULL)
+			requested = pool;
+
+		if(pool->Free != NULL)
+		{
+			block = pool->Free;
+			pool->Free = *(void **)block;
+		}
+		else if(pool->Fresh < pool->End)
+		{
+			block = pool->Fresh;
+			pool->Fresh += pool->BlockSize;
+		}
+		else
+			continue;
+
+		pool->InUse++;
+		if(pool->InUse > pool->HighWater)
+			pool->HighWater = pool->InUse;
+		break;
+	}
+
+	if(block == NULL)
+	{
+		if(requested == NULL)
+			requested = &gPool_Class[POOL_CLASSES - 1];		// bigger than any block
+		requested->Failures++;
+	}
+	SREG = sreg;
+
+	return block;
+}
+
+/*
+ * @name	pool_IsFree
+ * @brief	Tells if a block of the class is not allocated
+ * @note	Called with the interrupts disabled
+ */
+static uint8_t pool_IsFree(const Pool_ClassType *pool, const void *block)
+{
+#if (POOL_DEBUG > 0)
+	const void *free;
+#endif
+
+	if(((const uint8_t *)block >= pool->Fresh) || (pool->InUse == 0))
+		return 1;
+#if (POOL_DEBUG > 0)
+	for(free = pool->Free; free != NULL; free = *(void * const *)free)
+	{
+		if(free == block)
+			return 1;
+	}
+#endif
+	return 0;
+}
+
+/*
+ * @name	Pool_Free
+ * @brief	Gives a block back to its class
+ * @param	block - from Pool_Alloc(), NULL is ignored
+ * @note	A pointer which is not from the pool is ignored as well, a block which is not allocated is
+ *			ignored and counted in BadFrees
+ */
+void Pool_Free(void *block)
+{
+	Pool_ClassType *pool;
+	uint8_t sreg = SREG;
+
+	if(block == NULL)
+		return;
+
+	cli();
+	for(pool = &gPool_Class[0]; pool < &gPool_Class[POOL_CLASSES]; pool++)
+	{
+		if(((uint8_t *)block >= pool->Memory) && ((uint8_t *)block < pool->End))
+		{
+			if(pool_IsFree(pool, block))
+			{
+				pool->BadFrees++;		// double free, the free list would get a cycle
+				break;
+			}
+			*(void **)block = pool->Free;
+			pool->Free = block;
+			pool->InUse--;
+			break;
+		}
+	}
+	SREG = sreg;
+}
+
+/*
+ * @name	Pool_GetStatistics
+ * @brief	Copies the usage of a class
+ * @param	index - class, 0 is the smallest one
+ *			statistics - destination
+ * @retval	0x00 - Succeed!
+ *			0x01 - No such class
+ */
+uint8_t Pool_GetStatistics(uint8_t index, Pool_StatisticsType *statistics)
+{
+	Pool_ClassType *pool;
+	uint8_t sreg;
+
+	if(index >= POOL_CLASSES)
+		return 0x01;
+
+	pool = &gPool_Class[index];
+	sreg = SREG;
+	cli();
+	statistics->BlockSize = pool->BlockSize;
+	statistics->Blocks = pool->Blocks;
+	statistics->InUse = pool->InUse;
+	statistics->HighWater = pool->HighWater;
+	statistics->Failures = pool->Failures;
+	statistics->BadFrees = pool->BadFrees;
+	SREG = sreg;
+
+	return 0x00;
+}
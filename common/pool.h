@@ -0,0 +1,63 @@
+/**
+  ******************************************************************************
+  * @file    pool.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Header for pool.c, fixed-block pool allocator with size classes
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __POOL_H
+#define __POOL_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Exported constants --------------------------------------------------------*/
+//Size classes, smallest first. Blocks per class upto 254
+#ifndef POOL_SMALL_SIZE
+#define POOL_SMALL_SIZE			16
+#endif
+#ifndef POOL_SMALL_BLOCKS
+#define POOL_SMALL_BLOCKS		4
+#endif
+#ifndef POOL_MEDIUM_SIZE
+#define POOL_MEDIUM_SIZE		64
+#endif
+#ifndef POOL_MEDIUM_BLOCKS
+#define POOL_MEDIUM_BLOCKS		2
+#endif
+#ifndef POOL_LARGE_SIZE
+#define POOL_LARGE_SIZE			256			// I2C buffers of 255 bytes and their '\0'
+#endif
+#ifndef POOL_LARGE_BLOCKS
+#define POOL_LARGE_BLOCKS		2
+#endif
+
+#define POOL_CLASSES			3
+
+#ifndef POOL_DEBUG
+#define POOL_DEBUG				0			// 1 -> Pool_Free() walks the free list of the class to catch a double free
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+	uint16_t	BlockSize;
+	uint8_t		Blocks;
+	uint8_t		InUse;			// blocks allocated now
+	uint8_t		HighWater;		// most blocks allocated at the same time
+	uint16_t	Failures;		// requests of this class which got no block
+	uint16_t	BadFrees;		// Pool_Free() of a block which is not allocated (double free), ignored
+}Pool_StatisticsType;
+
+/* Exported functions ------------------------------------------------------- */
+extern void* Pool_Alloc(uint16_t size);
+extern void Pool_Free(void *block);
+extern uint8_t Pool_GetStatistics(uint8_t index, Pool_StatisticsType *statistics);
+
+#endif // __POOL_H
@@ -0,0 +1,76 @@
+/**
+  ******************************************************************************
+  * @file    power.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file is having the sleep of the blocking calls: instead of spinning on a flag the
+  *			 CPU sleeps until the interrupt which sets it. The sleep mode is chosen by the caller
+  *			 after what has to keep running:
+  *			 + SLEEP_MODE_IDLE     : USART receive complete, TWI master, the timers (scheduler tick)
+  *			 + SLEEP_MODE_PWR_DOWN : TWI address match (slave), pin change and INTx only, the clocks
+  *			                         are stopped, so the USARTs, Timer0/Timer1 and a TWI master are too
+  * @note	 + Resume time (INCLUDE_PROFILE=1): the ISRs which can wake the CPU up take TCNT1 with
+  *			   POWER_WAKE_STAMP() at their entry, Power_Sleep() records the cycles upto the return to the
+  *			   blocked code as ePROFILE_RESUME ("ISR to resume"), i.e. the ISR itself plus the way back.
+  *			 + This is not the latency from the event to the ISR entry, Timer1 cannot see it: 4 cycles of
+  *			   wake up and 4 of interrupt response in Idle, plus after a power-down the start-up time of
+  *			   the oscillator set by the CKSEL/SUT fuses (16K CK = 1ms for the full swing crystal).
+  *			 + The brown-out detector is switched off during the power-down when the device has BODS.
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Blocking call: POWER_WAIT_UNTIL(flag != 0, SLEEP_MODE_IDLE); the flag is set by an ISR
+  * 2. Put POWER_WAKE_STAMP() at the top of the ISR to have the time upto the resume measured
+  * 3. Own loops: cli(); check; Power_Sleep(mode); exactly as POWER_WAIT_UNTIL() does
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/io.h>
+#include "power.h"
+
+/* Global Variables ----------------------------------------------------------*/
+#if (INCLUDE_PROFILE > 0)
+volatile uint8_t gPower_Sleeping = 0;		// set by Power_Sleep(), cleared by the first POWER_WAKE_STAMP()
+volatile uint16_t gPower_WakeStamp;
+#endif // INCLUDE_PROFILE
+
+/* Functions -----------------------------------------------------------------*/
+
+/*
+ * @name	Power_Sleep
+ * @brief	Sleeps until an interrupt, global interrupts are enabled on return
+ * @param	mode - SLEEP_MODE_IDLE, SLEEP_MODE_PWR_DOWN ... of <avr/sleep.h>
+ * @note	Has to be called with the interrupts disabled, right after the check of the wake up condition.
+ *			With POWER_SLEEP_WHEN_BLOCKED=0 it only enables the interrupts, the caller busy-waits.
+ */
+void Power_Sleep(uint8_t mode)
+{
+#if (POWER_SLEEP_WHEN_BLOCKED > 0)
+#if (INCLUDE_PROFILE > 0)
+	uint16_t now;
+
+	gPower_Sleeping = 1;
+#endif // INCLUDE_PROFILE
+	set_sleep_mode(mode);
+	sleep_enable();
+#if defined(sleep_bod_disable)
+	if((mode == SLEEP_MODE_PWR_DOWN) || (mode == SLEEP_MODE_PWR_SAVE))
+		sleep_bod_disable();		// timed sequence: the sleep instruction has to follow within 3 cycles
+#endif
+	sei();
+	sleep_cpu();
+	sleep_disable();
+
+#if (INCLUDE_PROFILE > 0)
+	now = TIMER1_GetCount();
+	if(!gPower_Sleeping)
+		Profile_Record(ePROFILE_RESUME, now - gPower_WakeStamp);
+	gPower_Sleeping = 0;		// woken by an ISR without POWER_WAKE_STAMP()
+#endif // INCLUDE_PROFILE
+#else
+	(void)mode;
+	sei();
+#endif // POWER_SLEEP_WHEN_BLOCKED
+}
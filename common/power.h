@@ -0,0 +1,58 @@
+/**
+  ******************************************************************************
+  * @file    power.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Header for power.c, sleeping while a blocking call waits for an interrupt
+  * @note	 POWER_WAKE_STAMP() compiles to nothing unless INCLUDE_PROFILE > 0.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __POWER_H
+#define __POWER_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "profile.h"
+
+/* Exported constants --------------------------------------------------------*/
+#ifndef POWER_SLEEP_WHEN_BLOCKED
+#define POWER_SLEEP_WHEN_BLOCKED	1		// 0 -> the blocking calls busy-wait, e.g. while debugging over JTAG
+#endif
+
+/* Exported macro ------------------------------------------------------------*/
+#if (INCLUDE_PROFILE > 0)
+extern volatile uint8_t gPower_Sleeping;
+extern volatile uint16_t gPower_WakeStamp;
+
+//First statement of the ISRs which can wake the CPU up: Timer1 at the ISR entry, taken by the first ISR only
+#define POWER_WAKE_STAMP()		do { if(gPower_Sleeping) { gPower_WakeStamp = TIMER1_GetCount(); gPower_Sleeping = 0; } } while(0)
+#else
+#define POWER_WAKE_STAMP()		do { } while(0)
+#endif // INCLUDE_PROFILE
+
+/*
+ * Sleeps in mode until condition is true. The condition is checked with the interrupts disabled
+ * and the sleep instruction follows sei() directly, so an ISR which makes it true just before the
+ * sleep wakes the CPU up. Global interrupts are enabled by this macro.
+ */
+#define POWER_WAIT_UNTIL(condition, mode)		\
+	do											\
+	{											\
+		cli();									\
+		while(!(condition))						\
+		{										\
+			Power_Sleep(mode);					\
+			cli();								\
+		}										\
+		sei();									\
+	}while(0)
+
+/* Exported functions ------------------------------------------------------- */
+extern void Power_Sleep(uint8_t mode);
+
+#endif // __POWER_H
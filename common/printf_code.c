@@ -11,69 +11,204 @@
   */
 
 /* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include <avr/interrupt.h>
 #include "printf_code.h"
+#include "atmega644p_i2c.h"
+#include "profile.h"
+
+/* Global Variables ----------------------------------------------------------*/
+static void display_Block(Print_StreamType *stream, const char *data, uint16_t length);
+
+static char gPrint_ConsoleBuffer[PRINT_CONSOLE_BUFFER_SIZE];
+static Print_StreamType gPrint_Console = { display_Block, gPrint_ConsoleBuffer, PRINT_CONSOLE_BUFFER_SIZE, 0, 0, NULL, 0, 0 };
 
 /* Function Definations ------------------------------------------------------*/
 
 /**
-  * @name   display_Character()
-  * @brief  this function will print the char
-  * @param  ch - character needs to be printed!
+  * @name   display_Block()
+  * @brief  this function will print a block of characters on the console (stream of print())
+  * @param  stream - console stream
+  *         data   - characters
+  *         length - number of characters
   * @note	Here instead of putchar() use the USART/UART put function written by urself!
   * @retval None
   */
-void display_Character(char ch)
+static void display_Block(Print_StreamType *stream, const char *data, uint16_t length)
+{
+	(void)stream;
+	while(length--)
+		USART_PutChar(*data++);
+		//putchar(*data++);
+}
+
+/**
+  * @name   Print_USARTWrite()
+  * @brief  this function sends a block of a USART stream
+  * @param  stream - USART stream
+  *         data   - characters, one half of the stream buffer
+  *         length - number of characters
+  * @note	The block is sent by the UDRE ISR while the next one is formatted into the other half.
+  *         With the global interrupts disabled (or without the other half) it is sent by polling.
+  * @retval None
+  */
+static void Print_USARTWrite(Print_StreamType *stream, const char *data, uint16_t length)
+{
+	char *sent;
+
+	if((stream->Spare == NULL) || !(SREG & 0x80))		// I bit
+	{
+		while(length--)
+			USART_WriteChar(stream->Port, *data++);
+		return;
+	}
+
+	while(USART_IsTransmitBusy(stream->Port))
+		;												// the previous block is in the other half
+	USART_StartTransmit(stream->Port, (const uint8_t *)data, length, NULL);
+
+	sent = stream->Buffer;
+	stream->Buffer = stream->Spare;
+	stream->Spare = sent;
+}
+
+/**
+  * @name   Print_I2CWrite()
+  * @brief  this function sends a block of an I2C stream as one master transmission
+  * @param  stream - I2C stream
+  *         data   - characters, the stream buffer has one more byte for the end of string
+  *         length - number of characters
+  * @note	I2C_TransmitBufferFill() copies the string, so the stream buffer is free again. It is called once
+  *         per print_to() (Whole), a second fill would free the block the TWI ISR is still sending.
+  * @retval None
+  */
+static void Print_I2CWrite(Print_StreamType *stream, const char *data, uint16_t length)
 {
-	USART_PutChar(ch);
-	//putchar(ch);
+	(void)data;			// stream->Buffer itself
+	stream->Buffer[length] = '\0';
+	if(I2C_TransmitBufferFill(stream->Buffer) == 0x00)
+		I2C_StartCommunication();
+}
+
+/**
+  * @name   Print_Flush()
+  * @brief  this function gives the buffered characters of a stream to its sink
+  * @param  stream - stream to be flushed
+  * @note	print_to() flushes at its end. A RAM stream keeps its characters.
+  * @retval None
+  */
+void Print_Flush(Print_StreamType *stream)
+{
+	uint16_t length = stream->Length;
+
+	if((stream->Write == NULL) || (length == 0))
+		return;
+	stream->Length = 0;
+	stream->Write(stream, stream->Buffer, length);
+}
+
+/**
+  * @name   print_Character()
+  * @brief  this function will print the character only!
+  * @param  stream - where the character goes
+  *         data   - charater needs to be printed!
+  * @note	the character is only stored in the stream buffer, the sink gets it when the buffer is full
+  * @retval None
+  */
+static inline void print_Character(Print_StreamType *stream, const char data)
+{
+	stream->Count++;
+	if(stream->Length >= stream->Size)
+	{
+		if((stream->Write == NULL) || stream->Whole)
+			return;										// RAM/I2C stream is full, only counted
+		Print_Flush(stream);
+	}
+	stream->Buffer[stream->Length++] = data;
 }
 
 /**
   * @name   print_String()
   * @brief  this function will print the string
-  * @param  *str - the pointer to the string needs to be printed!
+  * @param  stream - where the string goes
+  *         *str   - the pointer to the string needs to be printed!
   * @note	-
   * @retval None
   */
-void print_String(const char *str)
+static void print_String(Print_StreamType *stream, const char *str)
 {
 	while(*str != '\0')
 	{
-		display_Character(*str);
+		print_Character(stream, *str);
 		str++;
 	}
 }
 
 /**
-  * @name   print_Character()
-  * @brief  this function will print the character only!
-  * @param  data - charater needs to be printed!
-  * @note	-
+  * @name   print_Block()
+  * @brief  this function will print a run of characters, copied in blocks
+  * @param  stream - where the characters go
+  *         data   - characters
+  *         length - number of characters
+  * @note	same result as print_Character() for every character, one copy per buffer
+  * @retval None
+  */
+static void print_Block(Print_StreamType *stream, const char *data, uint16_t length)
+{
+	uint16_t room;
+
+	stream->Count += length;
+	while(length != 0)
+	{
+		room = stream->Size - stream->Length;
+		if(room == 0)
+		{
+			if((stream->Write == NULL) || stream->Whole || (stream->Size == 0))
+				return;									// RAM/I2C stream is full, only counted
+			Print_Flush(stream);
+			continue;
+		}
+		if(room > length)
+			room = length;
+		memcpy(&stream->Buffer[stream->Length], data, room);
+		stream->Length += room;
+		data += room;
+		length -= room;
+	}
+}
+
+/**
+  * @name   print_End()
+  * @brief  this function ends a print: the sink gets the rest, a RAM stream gets its end of string
+  * @param  stream - stream of the print
   * @retval None
   */
-void print_Character(const char data)
+static inline void print_End(Print_StreamType *stream)
 {
-	display_Character(data);
+	if(stream->Write != NULL)
+		Print_Flush(stream);
+	else if(stream->Buffer != NULL)
+		stream->Buffer[stream->Length] = '\0';			// Size leaves room for it
 }
 
 /**
   * @name   print_Integer()
   * @brief  this function will print the numbers only!
+  * @param  stream - where the number goes
   * @param  data - number needs to be printed!
   * @param  length - lenght of number needs to be printed! bacisally Decimal meaning max lenght is 10 decimanls (assuming 32 bit computer)
   * @note	right now it will be printing decimal numbers from -2147483648 to 2147483647
   * 		needs some modification for hex numbers and unsigned values!
   * @retval None
   */
-void print_Integer(const int32_t data, int length)
+static void print_Integer(Print_StreamType *stream, const int32_t data, int length)
 {
-	char *s;
+	char s[11];			// 10 decimal digits and the end of string
 	int i;
 	uint32_t val = 0;
 
 	//Initialize the variables!
 	i = 0;
-	s = (char *)(calloc((length+1), sizeof(char)));
     if(data != 0)
     {
         if(length == 10)
@@ -112,34 +247,30 @@ void print_Integer(const int32_t data, int length)
 
 	if(data<0 && length > 8)
 	{
-		display_Character('-');
+		print_Character(stream, '-');
 	}
 
 	i= i - 1; //as i represents the number of digits
 	while(i >= 0)
 	{
-		display_Character(s[i]);
+		print_Character(stream, s[i]);
 		i--;
 	}
-
-	free(s);
 }
 
-
 /**
-  * @name   print()
-  * @brief  this function will behave similar to printf but the fully functional printf, a partial printf function!
+  * @name   vprint_to()
+  * @brief  this function is the format engine of print(), print_to() and snprint()
+  * @param  stream - where the formatted characters go
   * @param  *str - pointer to the string which needs to be analysed and printed!
-  * @param  ... - unknown number of arguments!
-  * @note	for printing unsinged numbers, hex values and long values needs modification!
-  *         For integers typecast the number by (uint32_t) or (int32_t) to print the proper value
-  * @retval None
+  * @param  arg_list - the arguments
+  * @note	the stream is flushed at the end, a RAM stream gets its end of string
+  * @retval number of characters of the format (the ones dropped by a full RAM stream included)
   */
-void print(const char *str, ...)
+uint16_t vprint_to(Print_StreamType *stream, const char *str, va_list arg_list)
 {
-	va_list arg_list;
-
-	va_start(arg_list, str);
+	PROFILE_ENTER(ePROFILE_PRINT);
+	stream->Count = 0;
 	while(*str != '\0')
 	{
 		switch(*str)
@@ -157,35 +288,221 @@ void print(const char *str, ...)
 											//Note: These int or uint variable must have postfixed with _t, like int8_t or uint8_t
 											//      Else the print values may be different from what has been passed!
 											//      if _t is used then size is always fixed to those many bits!
-											print_Integer(va_arg(arg_list, const int32_t), (*str=='d'? 10: 8));
+											print_Integer(stream, va_arg(arg_list, const int32_t), (*str=='d'? 10: 8));
 										break;
 								case 'c':
-											print_Character(va_arg(arg_list, const int));
+											print_Character(stream, va_arg(arg_list, const int));
 										break;
 								case 's':
-											print_String(va_arg(arg_list, const char *));
+											print_String(stream, va_arg(arg_list, const char *));
 										break;
 
 								default:
-										display_Character(*str);
+										print_Character(stream, *str);
 										break;
 							}
 						}
 						else
 						{
 							//Here 2 times % symbol is invalid (you cannot use %%)
-							print("Error Error Error! cannot print becasue format specifier is entered twice!");
+							print_String(stream, "Error Error Error! cannot print becasue format specifier is entered twice!");
 						}
 
 					break;
 
 			default:
-						display_Character(*str);
+						print_Character(stream, *str);
 					break;
 		}
 		str++;
 	}
+
+	print_End(stream);
+	PROFILE_EXIT(ePROFILE_PRINT);
+	return stream->Count;
+}
+
+/**
+  * @name   Print_Segments()
+  * @brief  this function prints a format split at build time (PRINT_TO()/PRINT() of printf_code.h)
+  * @param  stream - where the formatted characters go
+  * @param  segments - literal runs and typed conversions, in the order of the output
+  * @param  count - number of segments
+  * @note	no format string is parsed at runtime: a literal run is copied as one block, a conversion
+  *         calls its function directly
+  * @retval number of characters (the ones dropped by a full RAM stream included)
+  */
+uint16_t Print_Segments(Print_StreamType *stream, const Print_SegmentType *segments, uint8_t count)
+{
+	PROFILE_ENTER(ePROFILE_PRINT);
+	stream->Count = 0;
+	for(; count != 0; count--, segments++)
+	{
+		switch(segments->Type)
+		{
+			case ePRINT_TEXT:
+						print_Block(stream, segments->Value.Text, segments->Length);
+					break;
+			case ePRINT_DECIMAL:
+						print_Integer(stream, segments->Value.Integer, 10);
+					break;
+			case ePRINT_HEX:
+						print_Integer(stream, segments->Value.Integer, 8);
+					break;
+			case ePRINT_CHARACTER:
+						print_Character(stream, (char)segments->Value.Integer);
+					break;
+			default:
+						print_String(stream, segments->Value.Text);
+					break;
+		}
+	}
+
+	print_End(stream);
+	PROFILE_EXIT(ePROFILE_PRINT);
+	return stream->Count;
+}
+
+/**
+  * @name   print_to()
+  * @brief  this function will behave similar to fprintf, with the formats of print()
+  * @param  stream - where the formatted characters go
+  * @param  *str - pointer to the string which needs to be analysed and printed!
+  * @param  ... - unknown number of arguments!
+  * @retval number of characters
+  */
+uint16_t print_to(Print_StreamType *stream, const char *str, ...)
+{
+	va_list arg_list;
+	uint16_t count;
+
+	va_start(arg_list, str);
+	count = vprint_to(stream, str, arg_list);
 	va_end(arg_list);
+	return count;
+}
+
+/**
+  * @name   snprint()
+  * @brief  this function will behave similar to snprintf, with the formats of print()
+  * @param  buffer - the characters are formatted straight into it, always ended with '\0' (if size != 0)
+  * @param  size - size of buffer, end of string included
+  * @param  *str - pointer to the string which needs to be analysed and printed!
+  * @param  ... - unknown number of arguments!
+  * @note	e.g. build a frame in RAM and send it with one USART_StartTransmit()
+  * @retval number of characters of the format, >= size means the string has been cut
+  */
+uint16_t snprint(char *buffer, uint16_t size, const char *str, ...)
+{
+	Print_StreamType stream;
+	va_list arg_list;
+	uint16_t count;
+
+	Print_RAMStream(&stream, buffer, size);
+	va_start(arg_list, str);
+	count = vprint_to(&stream, str, arg_list);
+	va_end(arg_list);
+	return count;
+}
+
+/**
+  * @name   print()
+  * @brief  this function will behave similar to printf but the fully functional printf, a partial printf function!
+  * @param  *str - pointer to the string which needs to be analysed and printed!
+  * @param  ... - unknown number of arguments!
+  * @note	for printing unsinged numbers, hex values and long values needs modification!
+  *         For integers typecast the number by (uint32_t) or (int32_t) to print the proper value
+  *         The characters go to the console (USART_PutChar()), PRINT_CONSOLE_BUFFER_SIZE at a time
+  * @retval None
+  */
+void print(const char *str, ...)
+{
+	va_list arg_list;
+
+	va_start(arg_list, str);
+	vprint_to(&gPrint_Console, str, arg_list);
+	va_end(arg_list);
+}
+
+/**
+  * @name   Print_GetConsole()
+  * @brief  this function gives the stream of print(), for PRINT() and print_to()
+  * @retval console stream
+  */
+Print_StreamType* Print_GetConsole(void)
+{
+	return &gPrint_Console;
+}
+
+/**
+  * @name   Print_InitStream()
+  * @brief  this function sets up a stream with an own sink
+  * @param  stream - stream to be set up
+  *         write  - called with every full buffer and at the end of print_to(), NULL for a RAM stream
+  *         buffer - characters are formatted into it
+  *         size   - size of buffer
+  * @retval None
+  */
+void Print_InitStream(Print_StreamType *stream, Print_WriteBlockType write, char *buffer, uint16_t size)
+{
+	stream->Write = write;
+	stream->Buffer = buffer;
+	stream->Size = size;
+	stream->Length = 0;
+	stream->Count = 0;
+	stream->Spare = NULL;
+	stream->Port = 0;
+	stream->Whole = 0;
+}
+
+/**
+  * @name   Print_RAMStream()
+  * @brief  this function sets up a stream which formats into memory, no copy
+  * @param  stream - stream to be set up
+  *         buffer - destination, the string grows with every print_to() until Print_RAMStream() is called again
+  *         size   - size of buffer, end of string included
+  * @retval None
+  */
+void Print_RAMStream(Print_StreamType *stream, char *buffer, uint16_t size)
+{
+	Print_InitStream(stream, NULL, (size != 0) ? buffer : NULL, (size != 0) ? (size - 1) : 0);
+	if(size != 0)
+		buffer[0] = '\0';
+}
+
+/**
+  * @name   Print_USARTStream()
+  * @brief  this function sets up a stream on USART0 or USART1
+  * @param  stream - stream to be set up
+  *         port   - USART0 or USART1, configured with USARTInit()
+  *         buffer - two halves: one is sent by the UDRE ISR while the other is formatted
+  *         size   - size of buffer, 2 or more
+  * @note	The transmit interrupt of the USART belongs to the stream, do not mix it with USART_StartTransmit()
+  * @retval None
+  */
+void Print_USARTStream(Print_StreamType *stream, uint8_t port, char *buffer, uint16_t size)
+{
+	Print_InitStream(stream, Print_USARTWrite, buffer, size / 2);
+	stream->Spare = &buffer[size / 2];
+	stream->Port = port & 0x01;
+}
+
+/**
+  * @name   Print_I2CStream()
+  * @brief  this function sets up a stream on the I2C master transmitter
+  * @param  stream - stream to be set up
+  *         buffer - one print_to() is one I2C transmission, the characters beyond the buffer are dropped
+  *         size   - size of buffer, end of string included, only the first I2C_MAX_TRANSMIT_LENGTH + 1 are used
+  * @note	I2C has to be configured as master transmitter with the slave address. The application
+  *         waits for the end of the transmission (I2C event hook) before the next print_to().
+  * @retval None
+  */
+void Print_I2CStream(Print_StreamType *stream, char *buffer, uint16_t size)
+{
+	if(size > I2C_MAX_TRANSMIT_LENGTH + 1)
+		size = I2C_MAX_TRANSMIT_LENGTH + 1;
+	Print_InitStream(stream, Print_I2CWrite, buffer, (size != 0) ? (size - 1) : 0);
+	stream->Whole = 1;
 }
 
 /**
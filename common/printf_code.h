@@ -18,15 +18,89 @@
 #include <stdarg.h>
 //#include <strings.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include "atmega644p_usart.h"
 
 /* Exported types ------------------------------------------------------------*/
+typedef struct Print_Stream Print_StreamType;
+
+typedef void (*Print_WriteBlockType)(Print_StreamType *, const char *, uint16_t);	// stream, block and its length
+
+struct Print_Stream
+{
+	Print_WriteBlockType	Write;		// takes the buffered block, NULL for a RAM stream (characters beyond Size are dropped)
+	char					*Buffer;	// the characters are formatted straight into it
+	uint16_t				Size;
+	uint16_t				Length;		// characters in Buffer
+	uint16_t				Count;		// characters of the last print_to(), the dropped ones included
+	char					*Spare;		// second half of a USART stream buffer, sent by the UDRE ISR meanwhile
+	uint8_t					Port;		// USART0/USART1 of a USART stream
+	uint8_t					Whole;		// the sink takes one block per print_to(), characters beyond Size are dropped
+};
+
+typedef enum
+{
+	ePRINT_TEXT = 0,		// literal run
+	ePRINT_DECIMAL,			// %d
+	ePRINT_HEX,				// %x
+	ePRINT_CHARACTER,		// %c
+	ePRINT_STRING,			// %s
+}Print_SegmentKindType;
+
+typedef struct
+{
+	uint8_t			Type;		// Print_SegmentKindType
+	uint16_t		Length;		// characters of a literal run, known at build time
+	union
+	{
+		const char	*Text;
+		int32_t		Integer;
+	}Value;
+}Print_SegmentType;
 
 /* Exported constants --------------------------------------------------------*/
+#ifndef PRINT_CONSOLE_BUFFER_SIZE
+#define PRINT_CONSOLE_BUFFER_SIZE	16			// characters of print() sent with one call
+#endif
 
 /* Exported macro ------------------------------------------------------------*/
+/*
+ * Format split at build time: the literal runs and the conversions are written as segments,
+ *		PRINT("\n\rBaud Rate ", PRINT_D(baud), PRINT_LIT(" UBRR "), PRINT_X(ubrr));
+ * is print("\n\rBaud Rate %d UBRR %x", ...) without parsing the format at runtime.
+ * The length of a literal run is its sizeof(), a conversion does not compile (negative array
+ * size) if the argument does not have the type print() expects: int32_t for %d, int32_t or
+ * uint32_t for %x, a character for %c and a string for %s. On the target int is 16 bits, so
+ * an int passed to %d/%x is caught here instead of printing garbage.
+ */
+#define PRINT_ASSERT(condition)		(sizeof(char[(condition) ? 1 : -1]) - 1)
+#define PRINT_IS_TYPE(x, type)		__builtin_types_compatible_p(__typeof__(x), type)
+
+#define PRINT_LIT(text)		{ ePRINT_TEXT, sizeof("" text "") - 1, { .Text = (text) } }
+#define PRINT_D(x)			{ ePRINT_DECIMAL, PRINT_ASSERT(PRINT_IS_TYPE(x, int32_t)), { .Integer = (x) } }
+#define PRINT_X(x)			{ ePRINT_HEX, PRINT_ASSERT(PRINT_IS_TYPE(x, int32_t) || PRINT_IS_TYPE(x, uint32_t)), \
+								{ .Integer = (int32_t)(x) } }
+#define PRINT_C(x)			{ ePRINT_CHARACTER, PRINT_ASSERT(PRINT_IS_TYPE(x, char) || PRINT_IS_TYPE(x, int) || \
+								PRINT_IS_TYPE(x, unsigned char) || PRINT_IS_TYPE(x, signed char)), { .Integer = (x) } }
+#define PRINT_S(x)			{ ePRINT_STRING, PRINT_ASSERT(PRINT_IS_TYPE(&(x)[0], char *) || PRINT_IS_TYPE(&(x)[0], const char *)), \
+								{ .Text = (x) } }
+
+//First argument is a literal run, so the segment list is never empty
+#define PRINT_TO(stream, text, ...)	Print_Segments((stream), (const Print_SegmentType[]){ PRINT_LIT(text), ##__VA_ARGS__ }, \
+										sizeof((const Print_SegmentType[]){ PRINT_LIT(text), ##__VA_ARGS__ }) / sizeof(Print_SegmentType))
+#define PRINT(text, ...)			PRINT_TO(Print_GetConsole(), text, ##__VA_ARGS__)
 
 /* Exported functions ------------------------------------------------------- */
 extern void print(const char *str, ...);
+extern uint16_t print_to(Print_StreamType *stream, const char *str, ...);
+extern uint16_t vprint_to(Print_StreamType *stream, const char *str, va_list arg_list);
+extern uint16_t snprint(char *buffer, uint16_t size, const char *str, ...);
+extern void Print_InitStream(Print_StreamType *stream, Print_WriteBlockType write, char *buffer, uint16_t size);
+extern void Print_RAMStream(Print_StreamType *stream, char *buffer, uint16_t size);
+extern void Print_USARTStream(Print_StreamType *stream, uint8_t port, char *buffer, uint16_t size);
+extern void Print_I2CStream(Print_StreamType *stream, char *buffer, uint16_t size);
+extern void Print_Flush(Print_StreamType *stream);
+extern uint16_t Print_Segments(Print_StreamType *stream, const Print_SegmentType *segments, uint8_t count);
+extern Print_StreamType* Print_GetConsole(void);
 
 #endif // __PRINTF_CODE_H
@@ -0,0 +1,178 @@
+/**
+  ******************************************************************************
+  * @file    profile.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file is having the cycle profiling of the hot paths.
+  *			 Every profiled section has an entry in a fixed table with the number
+  *			 of measurements, min, max, sum (for the average) and a histogram of
+  *			 the durations. Timer1 is the time base: 1 count = 1 CPU cycle.
+  * @note	 A section must be shorter than 65536 cycles (4.096ms at 16MHz), longer
+  *			 sections wrap around and are reported with a wrong duration.
+  *			 The cost of PROFILE_ENTER()/PROFILE_EXIT() themselves is measured once in
+  *			 Profile_Init() and subtracted from every measurement.
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Build with INCLUDE_PROFILE=1 and call Profile_Init() once at startup
+  * 2. Wrap the code with PROFILE_ENTER(id) ... PROFILE_EXIT(id) in the same block, the drivers already do it for
+  *    the USART receive ISRs, I2C ISR and print(). The resume time of Power_Sleep() is recorded by power.c
+  * 3. Call Profile_Dump() to print the table on the USART, Profile_Reset() to start again
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/interrupt.h>
+#include "profile.h"
+#include "printf_code.h"
+
+/* Global Variables ----------------------------------------------------------*/
+Profile_EntryType gProfile_Table[ePROFILE_COUNT];
+static uint16_t gProfile_Overhead = 0;
+
+static const char * const gProfile_Names[ePROFILE_COUNT] =
+{
+	"USART0 RX ISR",
+	"USART1 RX ISR",
+	"I2C ISR      ",
+	"print()      ",
+	"ISR to resume",
+	"Application 0",
+	"Application 1",
+	"Application 2",
+	"Application 3",
+};
+
+/* Function Definations ------------------------------------------------------*/
+
+/**
+  * @name   Profile_Reset()
+  * @brief  this function will clear all the entries of the profile table
+  * @param  None
+  * @note	-
+  * @retval None
+  */
+void Profile_Reset(void)
+{
+	uint8_t sreg = SREG;
+	uint8_t id, bucket;
+
+	cli();
+	for(id = 0; id < ePROFILE_COUNT; id++)
+	{
+		gProfile_Table[id].Count = 0;
+		gProfile_Table[id].Min = 0xFFFF;
+		gProfile_Table[id].Max = 0;
+		gProfile_Table[id].Sum = 0;
+		for(bucket = 0; bucket < PROFILE_HISTOGRAM_BUCKETS; bucket++)
+			gProfile_Table[id].Histogram[bucket] = 0;
+	}
+	SREG = sreg;
+}
+
+/**
+  * @name   Profile_Init()
+  * @brief  this function will start the Timer1 cycle counter and measure the profiling overhead
+  * @param  None
+  * @note	Timer1 is shared, if it is already running it is not restarted
+  * @retval None
+  */
+void Profile_Init(void)
+{
+	uint16_t start;
+
+	TIMER1_StartFreeRunning();
+
+	//Cost of reading the counter twice, removed from every measurement
+	start = TIMER1_GetCount();
+	gProfile_Overhead = TIMER1_GetCount() - start;
+
+	Profile_Reset();
+}
+
+/**
+  * @name   Profile_Record()
+  * @brief  this function will add one measurement to the entry of the table
+  * @param  id - entry of the table
+  * @param  cycles - measured duration (including the overhead of the counter reads)
+  * @note	Called by PROFILE_EXIT(), safe to be called from the ISRs
+  * @retval None
+  */
+void Profile_Record(ProfileIdType id, uint16_t cycles)
+{
+	Profile_EntryType *entry = &gProfile_Table[id];
+	uint8_t sreg = SREG;
+	uint8_t bucket = 0;
+	uint16_t range;
+
+	cycles = (cycles > gProfile_Overhead) ? (cycles - gProfile_Overhead) : 0;
+
+	//Histogram bucket is the position of the most significant bit above the first bucket
+	for(range = cycles >> PROFILE_FIRST_BUCKET_SHIFT; (range != 0) && (bucket < (PROFILE_HISTOGRAM_BUCKETS - 1)); range >>= 1)
+		bucket++;
+
+	cli();
+	if(entry->Count != 0xFFFF)
+	{
+		entry->Count++;
+		entry->Sum += cycles;
+	}
+	if(cycles < entry->Min)
+		entry->Min = cycles;
+	if(cycles > entry->Max)
+		entry->Max = cycles;
+	if(entry->Histogram[bucket] != 0xFFFF)
+		entry->Histogram[bucket]++;
+	SREG = sreg;
+}
+
+/**
+  * @name   Profile_Get()
+  * @brief  this function will copy one entry of the table
+  * @param  id - entry of the table
+  * @param  entry - where the entry is copied
+  * @note	The copy is done with the interrupts disabled, so the entry is consistent
+  * @retval 0x00 - Succeed, 0x01 - id is not valid
+  */
+uint8_t Profile_Get(ProfileIdType id, Profile_EntryType *entry)
+{
+	uint8_t sreg = SREG;
+
+	if(id >= ePROFILE_COUNT)
+		return 0x01;
+
+	cli();
+	*entry = gProfile_Table[id];
+	SREG = sreg;
+
+	return 0x00;
+}
+
+/**
+  * @name   Profile_Dump()
+  * @brief  this function will print the profile table, one line per entry which has measurements
+  * @param  None
+  * @note	Durations are in CPU cycles. Histogram columns: < 32, < 64, < 128 ... < 2048, >= 2048
+  * @retval None
+  */
+void Profile_Dump(void)
+{
+	Profile_EntryType entry;
+	uint8_t id, bucket;
+
+	PRINT("\n\rProfile (cycles)\tcount\tmin\tmax\tavg\thistogram");
+	for(id = 0; id < ePROFILE_COUNT; id++)
+	{
+		Profile_Get(id, &entry);
+		if(entry.Count == 0)
+			continue;
+
+		PRINT("\n\r", PRINT_S(gProfile_Names[id]), PRINT_LIT("\t"), PRINT_D((int32_t)entry.Count), PRINT_LIT("\t"),
+			  PRINT_D((int32_t)entry.Min), PRINT_LIT("\t"), PRINT_D((int32_t)entry.Max), PRINT_LIT("\t"),
+			  PRINT_D((int32_t)(entry.Sum / entry.Count)), PRINT_LIT("\t"));
+		for(bucket = 0; bucket < PROFILE_HISTOGRAM_BUCKETS; bucket++)
+			PRINT("", PRINT_D((int32_t)entry.Histogram[bucket]), PRINT_LIT(" "));
+	}
+	PRINT("\n\r");
+}
@@ -0,0 +1,73 @@
+/**
+  ******************************************************************************
+  * @file    profile.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Header for profile.c, cycle profiling of the hot paths with Timer1
+  * @note	 PROFILE_ENTER()/PROFILE_EXIT() compile to nothing unless INCLUDE_PROFILE > 0.
+  *			 Enable it for all the files: make DEFS="-DINCLUDE_PROFILE=1"
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PROFILE_H
+#define __PROFILE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "atmega644p_timer.h"
+
+/* Exported constants --------------------------------------------------------*/
+#ifndef INCLUDE_PROFILE
+#define INCLUDE_PROFILE				0
+#endif // INCLUDE_PROFILE
+
+#define PROFILE_HISTOGRAM_BUCKETS	8		// < 32, < 64, < 128 ... < 2048, >= 2048 cycles
+#define PROFILE_FIRST_BUCKET_SHIFT	5		// upper limit of the first bucket is (1 << 5) cycles
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum
+{
+	ePROFILE_USART0_RX = 0,		// USART0RX_IRQHandler
+	ePROFILE_USART1_RX,			// USART1RX_IRQHandler
+	ePROFILE_I2C_IRQ,			// I2C_IRQHandler
+	ePROFILE_PRINT,				// print()
+	ePROFILE_RESUME,			// waking ISR to the return into the blocked call, see power.c
+	ePROFILE_APPLICATION0,		// free for the application code
+	ePROFILE_APPLICATION1,
+	ePROFILE_APPLICATION2,
+	ePROFILE_APPLICATION3,
+	ePROFILE_COUNT
+}ProfileIdType;
+
+typedef struct
+{
+	uint16_t	Count;								// number of measurements (saturates at 0xFFFF)
+	uint16_t	Min;								// in cycles
+	uint16_t	Max;								// in cycles
+	uint32_t	Sum;								// in cycles, for the average
+	uint16_t	Histogram[PROFILE_HISTOGRAM_BUCKETS];
+}Profile_EntryType;
+
+/* Exported macro ------------------------------------------------------------*/
+#if (INCLUDE_PROFILE > 0)
+extern Profile_EntryType gProfile_Table[ePROFILE_COUNT];
+
+//The start is a local variable of the caller: nested measurements of the same id (e.g. print() from an ISR
+//while print() is profiled in the main context) do not overwrite each other. ENTER and EXIT in the same scope.
+#define PROFILE_ENTER(id)		uint16_t profileStart_##id = TIMER1_GetCount()
+#define PROFILE_EXIT(id)		Profile_Record((id), TIMER1_GetCount() - profileStart_##id)
+#else
+#define PROFILE_ENTER(id)		do { } while(0)
+#define PROFILE_EXIT(id)		do { } while(0)
+#endif // INCLUDE_PROFILE
+
+/* Exported functions ------------------------------------------------------- */
+extern void Profile_Init(void);
+extern void Profile_Reset(void);
+extern void Profile_Record(ProfileIdType id, uint16_t cycles);
+extern uint8_t Profile_Get(ProfileIdType id, Profile_EntryType *entry);
+extern void Profile_Dump(void);
+
+#endif // __PROFILE_H
@@ -13,6 +13,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "scanf_code.h"
 #include "printf_code.h"
+#include "pool.h"
 
 /* defines -------------------------------------------------------------------*/
 #define		MAX_BUFFER_LENGTH		200
@@ -150,7 +151,9 @@ void copy_Number(uint32_t *dest_addr, char *data, int length)
 			not the corresponding address passed as a arguement!
 			And also make sure that while reading the string, make sure that memory is allocated
 			for that string before calling this function
+			The input line is read into a block of the pool (pool.c)
   * @retval 0
+			-1 - No free block in the pool for the input line
   */
 int scan(const char* formats, ... )
 {
@@ -159,7 +162,9 @@ int scan(const char* formats, ... )
 	int i = 0;
 	va_list arg;
 
-    str = (char *)malloc(MAX_BUFFER_LENGTH * sizeof(char));
+    str = (char *)Pool_Alloc(MAX_BUFFER_LENGTH * sizeof(char));
+    if(str == NULL)
+        return -1;
 
     /*
      * For AVR or ARM compiler we need to use the CARRIAGE RETURN (ASCII Value 0x0D) for ENTER KEY in QWERTY keyboard
@@ -225,7 +230,7 @@ int scan(const char* formats, ... )
 	}
 
 	va_end(arg);
-    free(str);
+    Pool_Free(str);
 
 	return 0;
 }
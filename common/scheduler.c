@@ -0,0 +1,250 @@
+/**
+  ******************************************************************************
+  * @file    scheduler.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file is having a cooperative run-to-completion task scheduler.
+  *			 + Fixed task table of SCHEDULER_MAX_TASKS entries, the index of the entry
+  *			   is the priority of the task (0 is the highest priority)
+  *			 + Posted tasks are kept in a bitmap, dispatch picks the lowest set bit
+  *			 + Deferred work: Scheduler_PostDelayed() posts the task after a number of
+  *			   milliseconds, counted by the 1ms tick of Timer0
+  *			 + Tickless idle: Timer0 only runs while a delayed post is pending, and when
+  *			   no task is posted the CPU sleeps in SLEEP_MODE_IDLE until an interrupt
+  * @note	 A task runs to completion, it is never preempted by another task. It must
+  *			 not busy-wait: work which has to wait is split and posted again.
+  *			 Scheduler_Post() can be called from the ISRs (e.g. the USART receive hook,
+  *			 the I2C event hook or the GPIO pin change hook).
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Call Scheduler_Init() and add the tasks with Scheduler_AddTask()
+  * 2. Post the tasks from the ISRs/tasks with Scheduler_Post() or Scheduler_PostDelayed()
+  * 3. Call Scheduler_Run(), it never returns
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "scheduler.h"
+#include "atmega644p_timer.h"
+#include "power.h"
+
+/* Global Variables ----------------------------------------------------------*/
+static Scheduler_TaskType gScheduler_Tasks[SCHEDULER_MAX_TASKS];
+static volatile uint8_t gScheduler_Pending = 0;						// bit n -> task n is posted
+static volatile uint16_t gScheduler_Delay[SCHEDULER_MAX_TASKS];		// remaining milliseconds, 0 -> no delayed post
+static volatile uint8_t gScheduler_Delayed = 0;						// bit n -> gScheduler_Delay[n] is running
+
+//Position of the lowest set bit of a nibble, used to find the highest priority task
+static const uint8_t gScheduler_LowestBit[16] = { 0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0 };
+
+/* Function Definations ------------------------------------------------------*/
+
+/**
+  * @name   Scheduler_Init()
+  * @brief  this function will clear the task table
+  * @param  None
+  * @note	Timer0 is stopped until the first delayed post
+  * @retval None
+  */
+void Scheduler_Init(void)
+{
+	uint8_t priority;
+	uint8_t sreg = SREG;
+
+	cli();
+	for(priority = 0; priority < SCHEDULER_MAX_TASKS; priority++)
+	{
+		gScheduler_Tasks[priority] = NULL;
+		gScheduler_Delay[priority] = 0;
+	}
+	gScheduler_Pending = 0;
+	gScheduler_Delayed = 0;
+	TIMER0_StopTick();
+	SREG = sreg;
+}
+
+/**
+  * @name   Scheduler_AddTask()
+  * @brief  this function will add the task to the table
+  * @param  priority - 0 (highest) to SCHEDULER_MAX_TASKS - 1 (lowest), one task per priority
+  * @param  task - function to be called when the task is posted
+  * @note	-
+  * @retval 0x00 - Succeed
+  *			0x01 - priority is out of range
+  *			0x02 - another task has the same priority
+  */
+uint8_t Scheduler_AddTask(uint8_t priority, Scheduler_TaskType task)
+{
+	if(priority >= SCHEDULER_MAX_TASKS)
+		return 0x01;
+	if(gScheduler_Tasks[priority] != NULL)
+		return 0x02;
+
+	gScheduler_Tasks[priority] = task;
+	return 0x00;
+}
+
+/**
+  * @name   Scheduler_Post()
+  * @brief  this function will mark the task as ready to run
+  * @param  priority - priority of the task
+  * @note	Posting a task which is already posted has no effect: it runs once.
+  *			Safe to be called from the ISRs.
+  * @retval 0x00 - Succeed
+  *			0x01 - priority is out of range
+  */
+uint8_t Scheduler_Post(uint8_t priority)
+{
+	uint8_t sreg = SREG;
+
+	if(priority >= SCHEDULER_MAX_TASKS)
+		return 0x01;
+
+	cli();
+	gScheduler_Pending |= (0x01 << priority);
+	SREG = sreg;
+
+	return 0x00;
+}
+
+/**
+  * @name   Scheduler_PostDelayed()
+  * @brief  this function will post the task after a delay
+  * @param  priority - priority of the task
+  * @param  milliseconds - delay, the task is posted after milliseconds - 1 to milliseconds
+  * @note	A new delayed post of the same task replaces the previous one.
+  *			Safe to be called from the ISRs.
+  * @retval 0x00 - Succeed
+  *			0x01 - priority is out of range
+  */
+uint8_t Scheduler_PostDelayed(uint8_t priority, uint16_t milliseconds)
+{
+	uint8_t sreg = SREG;
+
+	if(priority >= SCHEDULER_MAX_TASKS)
+		return 0x01;
+
+	if(milliseconds == SCHEDULER_NO_DELAY)
+		return Scheduler_Post(priority);
+
+	cli();
+	gScheduler_Delay[priority] = milliseconds;
+	gScheduler_Delayed |= (0x01 << priority);
+	if(!TIMER0_IsTickRunning())
+		TIMER0_StartTick();		// Tick only runs while there is something to count
+	SREG = sreg;
+
+	return 0x00;
+}
+
+/**
+  * @name   Scheduler_Cancel()
+  * @brief  this function will remove the task from the posted and the delayed tasks
+  * @param  priority - priority of the task
+  * @note	-
+  * @retval 0x00 - Succeed
+  *			0x01 - priority is out of range
+  */
+uint8_t Scheduler_Cancel(uint8_t priority)
+{
+	uint8_t sreg = SREG;
+
+	if(priority >= SCHEDULER_MAX_TASKS)
+		return 0x01;
+
+	cli();
+	gScheduler_Pending &= ~(0x01 << priority);
+	gScheduler_Delayed &= ~(0x01 << priority);
+	if(gScheduler_Delayed == 0)
+		TIMER0_StopTick();
+	SREG = sreg;
+
+	return 0x00;
+}
+
+/**
+  * @name   Scheduler_RunOnce()
+  * @brief  this function will run the highest priority posted task
+  * @param  None
+  * @note	-
+  * @retval 0x00 - no task was posted
+  *			0x01 - one task has been executed
+  */
+uint8_t Scheduler_RunOnce(void)
+{
+	uint8_t priority;
+	uint8_t sreg = SREG;
+
+	cli();
+	if(gScheduler_Pending == 0)
+	{
+		SREG = sreg;
+		return 0x00;
+	}
+
+	if(gScheduler_Pending & 0x0F)
+		priority = gScheduler_LowestBit[gScheduler_Pending & 0x0F];
+	else
+		priority = gScheduler_LowestBit[gScheduler_Pending >> 4] + 4;
+	gScheduler_Pending &= ~(0x01 << priority);
+	SREG = sreg;
+
+	if(gScheduler_Tasks[priority] != NULL)
+		gScheduler_Tasks[priority]();
+
+	return 0x01;
+}
+
+/**
+  * @name   Scheduler_Run()
+  * @brief  this function will run the posted tasks forever, the CPU sleeps when there is nothing to do
+  * @param  None
+  * @note	The check for posted tasks and the sleep instruction are atomic: sei() takes effect after
+  *			the next instruction, so an interrupt which posts a task just before the sleep wakes the CPU up.
+  *			The sleep is the one of power.c, so the time from the waking ISR to the resume is measured with INCLUDE_PROFILE=1.
+  *			Global interrupts are enabled by this function.
+  * @retval None
+  */
+void Scheduler_Run(void)
+{
+	while(1)
+	{
+		if(Scheduler_RunOnce())
+			continue;
+
+		cli();
+		if(gScheduler_Pending == 0)
+			Power_Sleep(SLEEP_MODE_IDLE);	// USART, TWI and the timers keep running in Idle mode
+		sei();
+	}
+}
+
+/**
+  * @name   TIMER0_COMPA_IRQHandler()
+  * @brief  1ms tick: counts down the delayed posts and stops Timer0 once none is left
+  * @param  None
+  * @note	-
+  * @retval None
+  */
+TIMER0_COMPA_IRQHandler()
+{
+	uint8_t priority;
+	uint8_t bit;
+
+	for(priority = 0, bit = 0x01; priority < SCHEDULER_MAX_TASKS; priority++, bit <<= 1)
+	{
+		if((gScheduler_Delayed & bit) && (--gScheduler_Delay[priority] == 0))
+		{
+			gScheduler_Delayed &= ~bit;
+			gScheduler_Pending |= bit;
+		}
+	}
+
+	if(gScheduler_Delayed == 0)
+		TIMER0_StopTick();		// Tickless: nothing to count anymore
+}
@@ -0,0 +1,36 @@
+/**
+  ******************************************************************************
+  * @file    scheduler.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Header for scheduler.c, cooperative run-to-completion task scheduler
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SCHEDULER_H
+#define __SCHEDULER_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef void (*Scheduler_TaskType)(void);
+
+/* Exported constants --------------------------------------------------------*/
+#define SCHEDULER_MAX_TASKS			8		// one bit per task in the pending bitmap
+#define SCHEDULER_NO_DELAY			0x0000
+
+/* Exported functions ------------------------------------------------------- */
+extern void Scheduler_Init(void);
+extern uint8_t Scheduler_AddTask(uint8_t priority, Scheduler_TaskType task);
+extern uint8_t Scheduler_Post(uint8_t priority);
+extern uint8_t Scheduler_PostDelayed(uint8_t priority, uint16_t milliseconds);
+extern uint8_t Scheduler_Cancel(uint8_t priority);
+extern uint8_t Scheduler_RunOnce(void);
+extern void Scheduler_Run(void);
+
+#endif // __SCHEDULER_H
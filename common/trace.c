@@ -0,0 +1,272 @@
+/**
+  ******************************************************************************
+  * @file    trace.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file is having the post-mortem trace: a ring of 4 byte records in
+  *			 the .noinit section, which is not cleared by the startup code. After a
+  *			 watchdog or external reset the records of the previous run are still there
+  *			 and are dumped on the next boot, with the reset cause (MCUSR) decoded.
+  * @note	 + MCUSR is captured in .init3, before the C startup, and cleared there: a
+  *			   watchdog reset leaves the watchdog enabled, it is switched off as well.
+  *			 + After a power-on reset the SRAM content is random: the ring is cleared.
+  *			   It is also cleared when the magic number or the index is not valid.
+  *			 + Trace_Write() costs a few stores with the interrupts disabled, it can be
+  *			   used in the ISRs (the I2C ISR traces every status with INCLUDE_TRACE=1).
+  *			 + Every boot writes an eTRACE_RESET record, so the ring shows the resets in
+  *			   between the records. When the ring is full the oldest records are overwritten.
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Build with INCLUDE_TRACE=1, call Trace_Init() at startup and Trace_Dump() on a print stream
+  *    (e.g. Print_GetConsole()) once the USART is configured
+  * 2. TRACE(event, data, value) writes a record, events from eTRACE_APPLICATION are free
+  * 3. print_to() on a stream of Trace_Stream() writes text into the ring (3 characters per record)
+  * 4. Trace_Clear() once the dump has been read, otherwise it is dumped again on the next boot
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "trace.h"
+#include "atmega644p_reg.h"
+
+/* Typedefs ------------------------------------------------------------------*/
+typedef struct
+{
+	uint16_t			Magic;			// TRACE_MAGIC once Trace_Init() has set up the ring
+	uint8_t				Head;			// next record to be written
+	uint8_t				Full;			// the ring has wrapped, Head is also the oldest record
+	Trace_RecordType	Records[TRACE_RECORDS];
+}Trace_RingType;
+
+/* Global Variables ----------------------------------------------------------*/
+static Trace_RingType gTrace __attribute__((section(".noinit")));
+static uint8_t gTrace_ResetCause __attribute__((section(".noinit")));	// MCUSR of this boot
+
+static const char * const gTrace_ResetNames[5] = { " power-on", " external", " brown-out", " watchdog", " JTAG" };
+
+/* Functions -----------------------------------------------------------------*/
+
+#if !defined(HOST_BUILD)
+/*
+ * @name	Trace_CaptureResetCause
+ * @brief	Runs in .init3 (after the stack setup, before .data/.bss are initialised)
+ * @note	WDRF forces WDE on, so it is cleared before the watchdog is switched off with
+ *			the timed sequence, otherwise the watchdog resets the MCU again during the startup
+ */
+void Trace_CaptureResetCause(void) __attribute__((naked, used, section(".init3")));
+void Trace_CaptureResetCause(void)
+{
+	gTrace_ResetCause = REG_READ(MCUSR);
+	REG_WRITE(MCUSR, 0x00);
+	REG_WRITE(WDTCSR, (1 << WDCE) | (1 << WDE));
+	REG_WRITE(WDTCSR, 0x00);
+}
+#endif // HOST_BUILD
+
+/*
+ * @name	Trace_Init
+ * @brief	Keeps the records of the previous run if they are valid, then records this boot
+ */
+void Trace_Init(void)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	if((gTrace.Magic != TRACE_MAGIC) || (gTrace.Head >= TRACE_RECORDS) || (gTrace_ResetCause & TRACE_RESET_POWER_ON))
+	{
+		gTrace.Head = 0;
+		gTrace.Full = 0;
+		gTrace.Magic = TRACE_MAGIC;
+	}
+	SREG = sreg;
+
+	Trace_Write(eTRACE_RESET, gTrace_ResetCause, 0);
+}
+
+/*
+ * @name	Trace_Write
+ * @brief	Adds a record, overwrites the oldest one when the ring is full
+ * @param	event - Trace_EventType or from eTRACE_APPLICATION
+ *			data, value - content of the record
+ * @note	Safe to be called from the ISRs
+ */
+void Trace_Write(uint8_t event, uint8_t data, uint16_t value)
+{
+	Trace_RecordType *record;
+	uint8_t sreg = SREG;
+
+	cli();
+	record = &gTrace.Records[gTrace.Head & (TRACE_RECORDS - 1)];
+	record->Event = event;
+	record->Data = data;
+	record->Value = value;
+	gTrace.Head = (gTrace.Head + 1) & (TRACE_RECORDS - 1);
+	if(gTrace.Head == 0)
+		gTrace.Full = 1;
+	SREG = sreg;
+}
+
+/*
+ * @name	Trace_GetResetCause
+ * @brief	MCUSR of this boot, TRACE_RESET_xxx bits
+ */
+uint8_t Trace_GetResetCause(void)
+{
+	return gTrace_ResetCause;
+}
+
+/*
+ * @name	Trace_Read
+ * @brief	Copies the records, oldest first
+ * @param	records - destination
+ *			size    - number of records it can take, the newest ones are copied if it is smaller
+ * @retval	number of records copied
+ */
+uint16_t Trace_Read(Trace_RecordType *records, uint16_t size)
+{
+	uint16_t count, index, i;
+	uint8_t sreg = SREG;
+
+	cli();
+	count = gTrace.Full ? TRACE_RECORDS : gTrace.Head;
+	if(count > size)
+		count = size;
+	index = (gTrace.Head - count) & (TRACE_RECORDS - 1);
+	for(i = 0; i < count; i++)
+		records[i] = gTrace.Records[(index + i) & (TRACE_RECORDS - 1)];
+	SREG = sreg;
+
+	return count;
+}
+
+/*
+ * @name	Trace_Clear
+ * @brief	Removes all records
+ */
+void Trace_Clear(void)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	gTrace.Head = 0;
+	gTrace.Full = 0;
+	SREG = sreg;
+}
+
+/*
+ * @name	Trace_DumpReset
+ * @brief	Prints the reset causes of a MCUSR value
+ */
+static void Trace_DumpReset(Print_StreamType *stream, uint8_t cause)
+{
+	uint8_t bit;
+
+	for(bit = 0; bit < 5; bit++)
+	{
+		if(cause & (1 << bit))
+			PRINT_TO(stream, "", PRINT_S(gTrace_ResetNames[bit]));
+	}
+	if(cause == 0)
+		PRINT_TO(stream, " unknown");
+}
+
+/*
+ * @name	Trace_Dump
+ * @brief	Prints the reset cause of this boot and the records, oldest first
+ * @param	stream - e.g. Print_GetConsole() or a USART stream
+ * @note	The records are read one at a time, the ISRs can keep on tracing meanwhile
+ */
+void Trace_Dump(Print_StreamType *stream)
+{
+	Trace_RecordType record;
+	uint16_t count, i;
+	uint8_t text = 0;
+	char characters[3];
+	uint8_t sreg;
+
+	PRINT_TO(stream, "\n\rReset:");
+	Trace_DumpReset(stream, gTrace_ResetCause);
+
+	sreg = SREG;
+	cli();
+	count = gTrace.Full ? TRACE_RECORDS : gTrace.Head;
+	SREG = sreg;
+	PRINT_TO(stream, "\n\rTrace (", PRINT_D((int32_t)count), PRINT_LIT(" records, oldest first)"));
+
+	for(i = 0; i < count; i++)
+	{
+		sreg = SREG;
+		cli();
+		record = gTrace.Records[(gTrace.Head - count + i) & (TRACE_RECORDS - 1)];
+		SREG = sreg;
+
+		if(record.Event == eTRACE_TEXT)
+		{
+			if(!text)
+				PRINT_TO(stream, "\n\rtext: ");
+			text = 1;
+			characters[0] = record.Data;
+			characters[1] = record.Value & 0xFF;
+			characters[2] = record.Value >> 8;
+			PRINT_TO(stream, "", PRINT_C(characters[0]));
+			if(characters[1] != '\0')
+				PRINT_TO(stream, "", PRINT_C(characters[1]));
+			if(characters[2] != '\0')
+				PRINT_TO(stream, "", PRINT_C(characters[2]));
+			continue;
+		}
+		text = 0;
+
+		if(record.Event == eTRACE_RESET)
+		{
+			PRINT_TO(stream, "\n\r---- boot, reset:");
+			Trace_DumpReset(stream, record.Data);
+		}
+		else if(record.Event == eTRACE_I2C)
+		{
+			PRINT_TO(stream, "\n\rI2C status ", PRINT_X((uint32_t)record.Data));
+		}
+		else if(record.Event == eTRACE_MEMORY)
+		{
+			PRINT_TO(stream, "\n\rSRAM guard hit, free ", PRINT_D((int32_t)record.Value));
+		}
+		else
+		{
+			PRINT_TO(stream, "\n\revent ", PRINT_X((uint32_t)record.Event), PRINT_LIT(" data "), PRINT_X((uint32_t)record.Data),
+					 PRINT_LIT(" value "), PRINT_X((uint32_t)record.Value));
+		}
+	}
+	PRINT_TO(stream, "\n\r");
+}
+
+/*
+ * @name	Trace_StreamWrite
+ * @brief	Sink of a trace stream: 3 characters per eTRACE_TEXT record
+ */
+static void Trace_StreamWrite(Print_StreamType *stream, const char *data, uint16_t length)
+{
+	(void)stream;
+	for(; length >= 3; length -= 3, data += 3)
+		Trace_Write(eTRACE_TEXT, data[0], (uint8_t)data[1] | ((uint16_t)(uint8_t)data[2] << 8));
+
+	if(length == 2)
+		Trace_Write(eTRACE_TEXT, data[0], (uint8_t)data[1]);
+	else if(length == 1)
+		Trace_Write(eTRACE_TEXT, data[0], 0);
+}
+
+/*
+ * @name	Trace_Stream
+ * @brief	Sets up a print stream which writes its text into the trace
+ * @param	stream - stream to be set up
+ *			buffer - characters are collected here, a multiple of 3 fills the records completely
+ *			size   - size of buffer
+ */
+void Trace_Stream(Print_StreamType *stream, char *buffer, uint16_t size)
+{
+	Print_InitStream(stream, Trace_StreamWrite, buffer, size);
+}
@@ -0,0 +1,71 @@
+/**
+  ******************************************************************************
+  * @file    trace.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Header for trace.c, post-mortem trace ring in .noinit SRAM
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TRACE_H
+#define __TRACE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "printf_code.h"
+
+/* Exported constants --------------------------------------------------------*/
+#ifndef INCLUDE_TRACE
+#define INCLUDE_TRACE				0
+#endif // INCLUDE_TRACE
+
+#ifndef TRACE_RECORDS
+#define TRACE_RECORDS				32			// 4 bytes each, power of 2 upto 256
+#endif
+
+#define TRACE_MAGIC					0x7A3C		// the ring has been set up by a previous boot
+
+//Reset causes, bits of MCUSR
+#define TRACE_RESET_POWER_ON		0x01		// PORF
+#define TRACE_RESET_EXTERNAL		0x02		// EXTRF
+#define TRACE_RESET_BROWN_OUT		0x04		// BORF
+#define TRACE_RESET_WATCHDOG		0x08		// WDRF
+#define TRACE_RESET_JTAG			0x10		// JTRF
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum
+{
+	eTRACE_RESET = 0,			// Data: MCUSR of the boot
+	eTRACE_TEXT,				// Data and Value: 3 characters of a trace stream
+	eTRACE_I2C,					// Data: TWSR served by the I2C ISR
+	eTRACE_MEMORY,				// Value: free SRAM when Memory_Check() found the guard overwritten
+	eTRACE_APPLICATION = 0x10,	// first event free for the application code
+}Trace_EventType;
+
+typedef struct
+{
+	uint8_t		Event;
+	uint8_t		Data;
+	uint16_t	Value;
+}Trace_RecordType;
+
+/* Exported macro ------------------------------------------------------------*/
+#if (INCLUDE_TRACE > 0)
+#define TRACE(event, data, value)	Trace_Write((event), (data), (value))
+#else
+#define TRACE(event, data, value)	do { } while(0)
+#endif // INCLUDE_TRACE
+
+/* Exported functions ------------------------------------------------------- */
+extern void Trace_Init(void);
+extern void Trace_Write(uint8_t event, uint8_t data, uint16_t value);
+extern uint8_t Trace_GetResetCause(void);
+extern uint16_t Trace_Read(Trace_RecordType *records, uint16_t size);
+extern void Trace_Clear(void);
+extern void Trace_Dump(Print_StreamType *stream);
+extern void Trace_Stream(Print_StreamType *stream, char *buffer, uint16_t size);
+
+#endif // __TRACE_H
@@ -27,11 +27,20 @@
 /* Includes ------------------------------------------------------------------*/
 #include <avr/io.h>
 #include "avr/iomxx4.h"
+#include "avr/interrupt.h"
+#include "atmega644p_reg.h"
 
 /* defines	------------------------------------------------------------------*/
 #define		GPIO_PIN_RESET		0x00
 #define		GPIO_PIN_SET		0x01
 
+#define		GLOBAL_INTERRUPT_ENABLE		0x80
+
+#define		GPIOA_PinChange_IRQHandler()	ISR(PCINT0_vect)	//ISR
+#define		GPIOB_PinChange_IRQHandler()	ISR(PCINT1_vect)	//ISR
+#define		GPIOC_PinChange_IRQHandler()	ISR(PCINT2_vect)	//ISR
+#define		GPIOD_PinChange_IRQHandler()	ISR(PCINT3_vect)	//ISR
+
 /* enums	------------------------------------------------------------------*/
 typedef enum
 {
@@ -75,9 +84,12 @@ typedef enum
 //	pins		pin_num;		// pin number where value will be written
 //}GPIO_Structure;
 
+typedef void (*GPIO_PinChangeHookType)(ports, uint8_t);	// port and the value of its PINx register
+
 /* exported functions ------------------------------------------------------------------*/
 void GPIO_Write(ports, pins, uint8_t);
 uint8_t GPIO_Read(ports, pins);
 void GPIO_Config(ports, pins, modes);
+void GPIO_RegisterPinChangeHook(ports, pins, GPIO_PinChangeHookType);
 
 #endif // end of __ATMEGA644P_GPIO_H
@@ -20,6 +20,7 @@
 #include <avr/io.h>
 #include "avr/iomxx4.h"
 #include "avr/interrupt.h"
+#include "atmega644p_reg.h"
 #include "stdio.h"
 #include "stdarg.h"
 #include "stdlib.h"
@@ -68,6 +69,7 @@
 
 #define BUFFER_SIZE					128
 #define TOTAL_POSSIBLE_DEVICES		128
+#define I2C_MAX_TRANSMIT_LENGTH		255		// characters of I2C_TransmitBufferFill(), the end of string not counted
 
 #define DISABLE		0x00
 #define ENABLE		0x01
@@ -100,6 +102,8 @@ typedef struct
 	I2CPrescalarValues		I2C_Prescalar;
 }I2C_StructureType;
 
+typedef void (*I2C_EventHookType)(uint8_t);		// status (TWSR) served by the ISR
+
 /* exported functions ------------------------------------------------------------------*/
 uint8_t I2C_DiscoverConnectedDevices(void);
 uint8_t I2C_PrintDescoveredDevices(void);
@@ -115,7 +119,9 @@ uint8_t* I2C_GetReceivedData(void);
 uint8_t I2C_FlushReceiveBuffer(void);
 uint8_t I2C_FlushTransmitBuffer(void);
 uint8_t I2C_GetSlaveDirection(void);
+uint8_t I2C_WaitForAddress(void);
 void I2C_SetAcknowledgementBit(uint8_t);
 uint8_t I2C_GetCommunicationError(void);
+void I2C_RegisterEventHook(I2C_EventHookType);
 
 #endif // end of __ATMEGA644P_I2C_H
@@ -0,0 +1,47 @@
+/**
+  ******************************************************************************
+  * @file    atmega644p_reg.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file contains the register access macros used by all the drivers.
+  * @note	 On the target the macros are plain accesses to the I/O registers of
+  *			 <avr/io.h>, so the generated code is the same as before (in/out/sbi/cbi).
+  *			 For the host build (HOST_BUILD) every access goes through the peripheral
+  *			 models in host/src, which lets the drivers run on a Linux machine.
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Always access the I/O register through REG_READ() and REG_WRITE()
+  * 2. REG_SET() and REG_CLEAR() are the read-modify-write versions: reg |= mask and reg &= ~mask
+  *
+  ******************************************************************************
+  */
+
+#ifndef __ATMEGA644P_REG_H				// to avoid the multiple definition!
+#define __ATMEGA644P_REG_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/io.h>
+
+/* Defines -------------------------------------------------------------------*/
+#if defined(HOST_BUILD)
+
+#define REG_READ(reg)				HostReg_Read(&(reg))
+#define REG_WRITE(reg, value)		HostReg_Write(&(reg), (uint8_t)(value))
+
+/* Implemented by the host peripheral models (host/src/host_io.c) */
+uint8_t HostReg_Read(volatile uint8_t *);
+void HostReg_Write(volatile uint8_t *, uint8_t);
+
+#else
+
+#define REG_READ(reg)				(reg)
+#define REG_WRITE(reg, value)		((reg) = (value))
+
+#endif // HOST_BUILD
+
+#define REG_SET(reg, mask)			REG_WRITE(reg, REG_READ(reg) | (mask))
+#define REG_CLEAR(reg, mask)		REG_WRITE(reg, REG_READ(reg) & (uint8_t)(~(mask)))
+
+#endif // end of __ATMEGA644P_REG_H
@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file    atmega644p_soft_uart.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file contains the software UARTs on GPIO pins (8N1, 1200 to 38400 baud)
+  * @note	 Two software UARTs: SOFTUART0 uses the compare unit A of Timer1 and SOFTUART1
+  *			 the compare unit B. The receive pin uses the pin change interrupt of its port,
+  *			 so the pin change hook of that port belongs to the software UARTs.
+  ******************************************************************************
+  *
+  * @Reference	Do check the datasheet for the 16-bit Timer/Counter1 output compare units
+  *				and the pin change interrupts!
+  *
+  ******************************************************************************
+  */
+
+#ifndef __ATMEGA644P_SOFT_UART_H				// to avoid the multiple definition!
+#define __ATMEGA644P_SOFT_UART_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/io.h>
+#include "avr/iomxx4.h"
+#include "avr/interrupt.h"
+#include "stdlib.h"
+#include "atmega644p_reg.h"
+#include "atmega644p_gpio.h"
+#include "atmega644p_usart.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define SOFTUART0	0
+#define SOFTUART1	1
+
+#define SOFTUART_MIN_BAUD_RATE		1200		// a bit has to be shorter than half of the Timer1 counter
+#define SOFTUART_MAX_BAUD_RATE		38400		// ISR cost per bit is fixed, faster rates leave no CPU time
+
+#ifndef SOFTUART_TX_BUFFER_SIZE
+#define SOFTUART_TX_BUFFER_SIZE		16			// bytes, power of 2 upto 128 (fifo.h)
+#endif
+#ifndef SOFTUART_RX_BUFFER_SIZE
+#define SOFTUART_RX_BUFFER_SIZE		16			// words, power of 2 upto 128 (fifo.h)
+#endif
+
+/* Typedefs and structure ----------------------------------------------------*/
+typedef struct
+{
+	uint32_t	SOFTUART_BaudRate;
+	ports		SOFTUART_TxPort;		// GPIO of the transmit pin
+	pins		SOFTUART_TxPin;
+	ports		SOFTUART_RxPort;		// GPIO of the receive pin
+	pins		SOFTUART_RxPin;
+}SOFTUART_StructureType;
+
+/* exported functions ------------------------------------------------------------------*/
+uint32_t SOFTUART_Init(uint8_t, SOFTUART_StructureType);
+void SOFTUART_WriteChar(uint8_t, uint8_t);
+uint8_t SOFTUART_ReadChar(uint8_t, uint16_t *);
+void SOFTUART_RegisterReceiveHook(uint8_t, USART_ReceiveHookType);
+uint8_t SOFTUART_StartTransmit(uint8_t, const uint8_t *, uint16_t, USART_TransmitCompleteHookType);
+uint8_t SOFTUART_IsTransmitBusy(uint8_t);
+void SOFTUART_WaitTransmitComplete(uint8_t);
+
+#endif // end of __ATMEGA644P_SOFT_UART_H
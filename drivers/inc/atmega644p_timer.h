@@ -0,0 +1,120 @@
+/**
+  ******************************************************************************
+  * @file    atmega644p_timer.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file contains the Timer0, Timer1 and Timer2 definitions.
+  *			 + Timer0 is a 1ms tick (CTC mode, clk/64) which can be stopped when nobody
+  *			   needs it (tickless idle of the scheduler).
+  *			 + Timer1 is used as a free running cycle counter (normal mode, no prescalar):
+  *			   TCNT1 counts the CPU cycles and wraps every 65536 cycles. The two compare
+  *			   units are events at a given cycle (one per software UART).
+  *			 + Timer2 is a free running tick counter (normal mode, clk/128): TCNT2 counts
+  *			   8us ticks at 16MHz, the two compare units are timeouts (one per USART).
+  * @note	 Timer1 is never stopped or reloaded once it is started, so several modules
+  *			 can share it: differences of two TIMER1_GetCount() values are the elapsed
+  *			 cycles as long as they are below 65536 (4.096ms at 16MHz).
+  ******************************************************************************
+  *
+  * @Reference	Do check the datasheet for more information on 16-bit Timer/Counter1 and
+  *				how the 16-bit registers has to be accessed (low byte first on read)!
+  *
+  ******************************************************************************
+  */
+
+#ifndef __ATMEGA644P_TIMER_H				// to avoid the multiple definition!
+#define __ATMEGA644P_TIMER_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/io.h>
+#include "avr/iomxx4.h"
+#include "avr/interrupt.h"
+#include "atmega644p_reg.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define TIMER0_PRESCALAR_64			0x03		// CS02:0 of TCCR0B -> clk/64
+#define TIMER0_CTC_MODE				0x02		// WGM01 of TCCR0A
+#define TIMER0_COMPARE_A_INTERRUPT	0x02		// OCIE0A of TIMSK0
+#define TIMER0_TICK_COMPARE_VALUE	((F_CPU / 64 / 1000) - 1)	// 1ms, 249 at 16MHz
+
+#define TIMER0_COMPA_IRQHandler()	ISR(TIMER0_COMPA_vect)	//ISR of the 1ms tick
+
+#define TIMER1_NO_PRESCALAR			0x01		// CS12:0 of TCCR1B -> clk/1
+#define TIMER1_CLOCK_SELECT_MASK	0x07
+#define TIMER1_COMPARE_A_INTERRUPT	0x02		// OCIE1A of TIMSK1, OCF1A of TIFR1
+#define TIMER1_COMPARE_B_INTERRUPT	0x04		// OCIE1B of TIMSK1, OCF1B of TIFR1
+
+#define TIMER1_COMPA_IRQHandler()	ISR(TIMER1_COMPA_vect)
+#define TIMER1_COMPB_IRQHandler()	ISR(TIMER1_COMPB_vect)
+
+#define TIMER2_PRESCALAR_128		0x05		// CS22:0 of TCCR2B -> clk/128
+#define TIMER2_PRESCALAR			128
+#define TIMER2_CLOCK_SELECT_MASK	0x07
+#define TIMER2_COMPARE_A_INTERRUPT	0x02		// OCIE2A of TIMSK2, OCF2A of TIFR2
+#define TIMER2_COMPARE_B_INTERRUPT	0x04		// OCIE2B of TIMSK2, OCF2B of TIFR2
+#define TIMER2_OVERFLOW_INTERRUPT	0x01		// TOIE2 of TIMSK2, TOV2 of TIFR2 -> every 256 ticks (2.048ms at 16MHz)
+
+#define TIMER2_COMPA_IRQHandler()	ISR(TIMER2_COMPA_vect)
+#define TIMER2_COMPB_IRQHandler()	ISR(TIMER2_COMPB_vect)
+#define TIMER2_OVF_IRQHandler()		ISR(TIMER2_OVF_vect)
+
+/* Typedefs and structure ----------------------------------------------------*/
+typedef struct
+{
+	uint16_t	Last;			// counter value of the previous read
+	uint32_t	Elapsed;		// cycles since TIMER1_StartStopwatch()
+}TIMER1_StopwatchType;
+
+/* exported functions ------------------------------------------------------------------*/
+void TIMER0_StartTick(void);
+void TIMER0_StopTick(void);
+uint8_t TIMER0_IsTickRunning(void);
+void TIMER1_StartFreeRunning(void);
+uint8_t TIMER1_IsRunning(void);
+void TIMER1_StartStopwatch(TIMER1_StopwatchType *);
+uint32_t TIMER1_ReadStopwatch(TIMER1_StopwatchType *);
+void TIMER2_StartFreeRunning(void);
+uint8_t TIMER2_IsRunning(void);
+
+/*
+ * @name	TIMER1_GetCount
+ * @brief	Returns the current value of the cycle counter
+ * @note	Inline as it is used in the hot paths. Low byte has to be read first, reading TCNT1L
+ *			latches TCNT1H in the temporary register of the timer. The temporary register is shared by
+ *			all the 16 bit registers of Timer1 and the ISRs use it too (profiling, soft UART compares),
+ *			so both reads are done with the interrupts disabled.
+ */
+static inline uint16_t TIMER1_GetCount(void)
+{
+	uint8_t sreg = SREG;
+	uint8_t low, high;
+
+	cli();
+	low = REG_READ(TCNT1L);
+	high = REG_READ(TCNT1H);
+	SREG = sreg;
+
+	return ((uint16_t)high << 8) | low;
+}
+
+/*
+ * @name	TIMER1_SetCompare
+ * @brief	Writes a 16 bit compare register (OCR1A or OCR1B)
+ * @param	high, low - OCR1xH and OCR1xL
+ *			count     - counter value of the compare match
+ * @note	High byte has to be written first, it goes to the temporary register of the timer
+ *			and both bytes are updated with the write of the low byte. Interrupts are disabled in
+ *			between, see TIMER1_GetCount().
+ */
+static inline void TIMER1_SetCompare(volatile uint8_t *high, volatile uint8_t *low, uint16_t count)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	REG_WRITE(*high, count >> 8);
+	REG_WRITE(*low, count & 0xFF);
+	SREG = sreg;
+}
+
+#endif // end of __ATMEGA644P_TIMER_H
@@ -20,6 +20,8 @@
 #include <avr/io.h>
 #include "avr/iomxx4.h"
 #include "avr/interrupt.h"
+#include "atmega644p_reg.h"
+#include "atmega644p_gpio.h"
 #include "stdio.h"
 #include "stdarg.h"
 #include "stdlib.h"
@@ -33,13 +35,56 @@
 #define RECEIVE_COMPLETE_FLAG		0x80
 #define TRANSMIT_COMPLETE_FLAG		0x40
 #define DATA_REGISTER_EMPTY_FLAG	0x20
+#define FRAME_ERROR_FLAG			0x10	// FEn: stop bit of the received data was 0
+#define DATA_OVERRUN_FLAG			0x08	// DORn: data has been lost before the received data
+#define PARITY_ERROR_FLAG			0x04	// UPEn: parity of the received data is wrong
+#define DOUBLE_SPEED_BIT			0x02
+#define MULTI_PROCESSOR_MODE_BIT	0x01	// MPCMn: data frames (9th bit = 0) are ignored by the receiver
+
+#define RECEIVE_INTERRUPT_ENABLE	0x80	// RXCIEn of UCSRnB
+#define TRANSMIT_INTERRUPT_ENABLE	0x40	// TXCIEn of UCSRnB
+#define DATA_EMPTY_INTERRUPT_ENABLE	0x20	// UDRIEn of UCSRnB
+#define RECEIVER_ENABLE				0x10	// RXENn of UCSRnB
+#define TRANSMIT_DATA_BIT8			0x01	// TXB8n of UCSRnB
+#define RECEIVE_DATA_BIT8			0x02	// RXB8n of UCSRnB
+#define USART_ADDRESS_FRAME			0x0100	// 9th bit set -> address frame in the multi-processor mode
+#define USART_BROADCAST_ADDRESS		0xFF	// address frame accepted by every node
+
+//Error flags in the received words given to the hook / stored in the receive buffer (bits 12..10, 9th data bit is bit 8)
+#define USART_RX_FRAME_ERROR		0x1000
+#define USART_RX_OVERRUN			0x0800
+#define USART_RX_PARITY_ERROR		0x0400
+#define USART_RX_ERRORS				(USART_RX_FRAME_ERROR | USART_RX_OVERRUN | USART_RX_PARITY_ERROR)
+#define USART_RX_DATA				0x01FF	// data bits of a received word
+
+#ifndef USART_RECEIVE_BUFFER_SIZE
+#define USART_RECEIVE_BUFFER_SIZE	128		// words of the receive buffer (fifo.h), power of 2 upto 128
+#endif
+
+//Receiver tolerance recommended by the datasheet (8 data bits), in 0.01%
+#define USART_MAX_BAUD_ERROR		200		// normal speed: +-2.0%
+#define USART_MAX_BAUD_ERROR_U2X	150		// double speed: +-1.5%
+
+//Auto-baud (atmega644p_usart_autobaud.c)
+#define USART_AUTOBAUD_SYNC_BYTE	0x55	// 'U': start bit and data give 9 edges one bit time apart
+#define USART_AUTOBAUD_MIN_RATE		300		// a bit has to be shorter than the 16 bit Timer1 counter
+#define USART_AUTOBAUD_MAX_RATE		115200	// limited by the polling loop (a few cycles per edge)
+#define USART_AUTOBAUD_SNAP_ERROR	200		// measured rate within 2.00% of a standard rate -> standard rate
+
+//Idle line framing (atmega644p_usart_idle.c), status of a frame
+#define USART_IDLE_FRAME_OVERFLOW	0x01	// frame was longer than the buffer, the end is missing
+#define USART_IDLE_FRAME_LINE_ERROR	0x02	// a byte of the frame had FEn, DORn or UPEn set
 
 #define	GLOBAL_INTERRUPT_FLAG		0x80
 
 #define USART0RX_IRQHandler()		ISR(USART0_RX_vect)
 #define USART1RX_IRQHandler()		ISR(USART1_RX_vect)
+#define USART0UDRE_IRQHandler()		ISR(USART0_UDRE_vect)
+#define USART1UDRE_IRQHandler()		ISR(USART1_UDRE_vect)
+#define USART0TX_IRQHandler()		ISR(USART0_TX_vect)
+#define USART1TX_IRQHandler()		ISR(USART1_TX_vect)
 
-volatile uint8_t	gReceive_Buffer_Full;	//Developer has to make sure to read the buffer once the receive buffer is Full! and reset the flag after reading the buffer
+extern volatile uint8_t	gReceive_Buffer_Full;	//Set when a carriage return has been received or the receive buffer is full, reset by USART_ClearReceiveBuffer()/USART_FlushReceiveBuffer()
 
 /* Typedefs and structure ----------------------------------------------------*/
 typedef enum
@@ -67,8 +112,8 @@ typedef enum
 typedef enum
 {
 	SYNCRONOUS  		= 0x01,		// Divider value when Synchronous is selected!
-	DOUBLESPEEDASYNC 	= 0x03,		// Divider value when Double speed is selected!
-	ASYNCHRONOUS 		= 0x04,		// Divider value when Asynchronous is selected!
+	DOUBLESPEEDASYNC 	= 0x03,		// Divider value when Double speed is selected! (U2X forced)
+	ASYNCHRONOUS 		= 0x04,		// Divider value when Asynchronous is selected! (U2X selected for the lowest error)
 }USARTModesType;
 
 typedef enum
@@ -88,12 +133,62 @@ typedef struct
 	USARTCommunicationType	USART_Communication;
 }USART_StructureType;
 
+typedef struct
+{
+	uint32_t	BaudRate;			// achieved baud rate
+	int16_t		Error;				// (achieved - requested) / requested in 0.01%, e.g. -350 = -3.50%
+	uint16_t	UBRR;				// value of UBRRn
+	uint8_t		DoubleSpeed;		// U2Xn is set
+}USART_BaudType;
+
+typedef void (*USART_ReceiveHookType)(uint8_t, uint16_t);		// USART0/USART1 and the received data (9th bit in bit 8, USART_RX_ERRORS)
+
+typedef struct
+{
+	uint16_t	Received;			// data received by the ISR (wraps around)
+	uint16_t	FrameErrors;		// FEn: wrong baud rate, noise or a break on the line
+	uint16_t	Overruns;			// DORn: the ISR was too late, at least one data has been lost
+	uint16_t	ParityErrors;		// UPEn
+	uint16_t	BufferOverflows;	// data dropped because the receive buffer was full
+}USART_StatisticsType;
+typedef void (*USART_TransmitCompleteHookType)(uint8_t);		// USART0/USART1, called when the last stop bit has been sent
+typedef uint8_t (*USART_TransmitSourceType)(uint8_t, uint8_t *);	// USART0/USART1 and the next byte, returns 1 with the last byte
+typedef void (*USART_IdleFrameHookType)(uint8_t);				// USART0/USART1 which has an idle line frame ready
+
 /* exported functions ------------------------------------------------------------------*/
-void USARTInit(uint8_t, USART_StructureType);
+uint32_t USARTInit(uint8_t, USART_StructureType);
+uint8_t USART_CalculateBaud(uint32_t, USARTModesType, USART_BaudType *);
+void USART_GetBaud(uint8_t, USART_BaudType *);
+uint8_t USART_GetReliableBaudRates(uint32_t *, uint8_t);
+uint32_t USART_GetMaxBaudRate(void);
+uint32_t USART_NearestStandardBaudRate(uint32_t, int16_t);
+uint8_t USART_AutoBaud(uint8_t, USART_StructureType *, uint16_t);
 void USART_PutChar(uint16_t);
 uint16_t USART_GetChar();
+void USART_WriteChar(uint8_t, uint16_t);
+void USART_WaitTransmitComplete(uint8_t);
+uint8_t USART_ReadChar(uint8_t, uint16_t *);
+uint8_t USART_SetReceiveInterrupt(uint8_t, uint8_t);
 void USART_EnableInterrupt(USARTCommunicationType);
 void USART_ClearReceiveBuffer();
+uint8_t USART_ReadReceiveBuffer(uint16_t *);
 void USART_FlushReceiveBuffer();
+void USART_RegisterReceiveHook(uint8_t, USART_ReceiveHookType);
+void USART_GetStatistics(uint8_t, USART_StatisticsType *);
+void USART_ResetStatistics(uint8_t);
+void USART_EnableAddressFilter(uint8_t, uint8_t);
+void USART_DisableAddressFilter(uint8_t);
+void USART_SendAddressed(uint8_t, uint8_t, const uint8_t *, uint16_t);
+uint8_t USART_StartTransmit(uint8_t, const uint8_t *, uint16_t, USART_TransmitCompleteHookType);
+uint8_t USART_StartTransmitSource(uint8_t, USART_TransmitSourceType, USART_TransmitCompleteHookType);
+uint8_t USART_IsTransmitBusy(uint8_t);
+void USART_EnableRS485(uint8_t, ports, pins);
+void USART_DisableRS485(uint8_t);
+uint16_t USART_CharacterTime(uint8_t);
+void USART_EnableIdleFrames(uint8_t, uint8_t *, uint8_t *, uint16_t, uint16_t, USART_IdleFrameHookType);
+void USART_DisableIdleFrames(uint8_t);
+const uint8_t* USART_ReceiveIdleFrame(uint8_t, uint16_t *, uint8_t *);
+void USART_ReleaseIdleFrame(uint8_t);
+uint16_t USART_GetIdleFramesDropped(uint8_t);
 
 #endif // end of __ATMEGA644P_USART_H
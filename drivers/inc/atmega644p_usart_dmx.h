@@ -0,0 +1,57 @@
+/**
+  ******************************************************************************
+  * @file    atmega644p_usart_dmx.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file contains the DMX512 mode of USART0/USART1 (transmitter and receiver)
+  * @note	 DMX512 line: 250kbaud, 8 data bits, no parity, 2 stop bits (8N2).
+  *			 Packet: BREAK (>= 88us low), MAB (mark after break, >= 8us high), start code and
+  *			 upto 512 slots. With 512 slots a packet takes 22.7ms, so continuous sending
+  *			 refreshes the universe at 44Hz.
+  ******************************************************************************
+  *
+  * @Reference	ANSI E1.11 (DMX512-A) for the timing of the packet!
+  *
+  ******************************************************************************
+  */
+
+#ifndef __ATMEGA644P_USART_DMX_H				// to avoid the multiple definition!
+#define __ATMEGA644P_USART_DMX_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/io.h>
+#include "avr/iomxx4.h"
+#include "stdlib.h"
+#include "atmega644p_reg.h"
+#include "atmega644p_usart.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define USART_DMX_BAUD_RATE			250000
+#define USART_DMX_BREAK_BAUD_RATE	100000		// 0x00 at 100kbaud: 90us BREAK, the 2 stop bits are a 20us MAB
+#define USART_DMX_START_CODE		0x00		// null start code: dimmer levels
+#define USART_DMX_MAX_LENGTH		513			// start code and 512 slots
+#define USART_DMX_MIN_LENGTH		25			// start code and 24 slots: packet is longer than the 1204us minimum
+
+/* Typedefs and structure ----------------------------------------------------*/
+typedef void (*USART_DMX_ReceivedHookType)(uint8_t);		// USART0/USART1 which has a packet ready
+
+typedef struct
+{
+	uint16_t	Packets;		// packets given to the application
+	uint16_t	Errors;			// packets stopped by a frame error, an overrun or a parity error of a slot
+	uint16_t	Dropped;		// packets lost because the application did not release the previous one
+}USART_DMX_StatisticsType;
+
+/* exported functions ------------------------------------------------------------------*/
+uint32_t USART_DMXInit(uint8_t, USARTCommunicationType);
+uint8_t USART_DMX_StartTransmit(uint8_t, uint8_t *, uint8_t *, uint16_t);
+void USART_DMX_StopTransmit(uint8_t);
+uint8_t* USART_DMX_GetTransmitBuffer(uint8_t);
+void USART_DMX_CommitTransmitBuffer(uint8_t);
+void USART_DMX_StartReceive(uint8_t, uint8_t *, uint8_t *, uint16_t, USART_DMX_ReceivedHookType);
+const uint8_t* USART_DMX_Receive(uint8_t, uint16_t *);
+void USART_DMX_Release(uint8_t);
+void USART_DMX_GetStatistics(uint8_t, USART_DMX_StatisticsType *);
+
+#endif // end of __ATMEGA644P_USART_DMX_H
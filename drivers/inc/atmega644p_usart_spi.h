@@ -0,0 +1,60 @@
+/**
+  ******************************************************************************
+  * @file    atmega644p_usart_spi.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file contains the configuration of USART0/USART1 in Master SPI mode (MSPIM)
+  * @note	 In MSPIM the USART is a SPI master: XCKn is SCK, TXDn is MOSI and RXDn is MISO.
+  *			 USART0: SCK = PB0, MOSI = PD1, MISO = PD0
+  *			 USART1: SCK = PD4, MOSI = PD3, MISO = PD2
+  *			 The slave select pin is any GPIO, driven by the application.
+  ******************************************************************************
+  *
+  * @Reference	Do check the datasheet chapter "USART in SPI Mode" for the timing of the SPI modes!
+  *
+  ******************************************************************************
+  */
+
+#ifndef __ATMEGA644P_USART_SPI_H				// to avoid the multiple definition!
+#define __ATMEGA644P_USART_SPI_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/io.h>
+#include "avr/iomxx4.h"
+#include "stdlib.h"
+#include "atmega644p_reg.h"
+#include "atmega644p_usart.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define USART_SPI_MAX_CLOCK_RATE		(F_CPU / 2)		// UBRRn = 0
+#define USART_SPI_DUMMY_BYTE			0xFF			// sent when there is no transmit buffer
+
+/* Typedefs and structure ----------------------------------------------------*/
+typedef enum
+{
+	SPI_MODE0	= 0x00,		// CPOL = 0, CPHA = 0 -> sample on rising edge
+	SPI_MODE1	= 0x02,		// CPOL = 0, CPHA = 1 -> sample on falling edge
+	SPI_MODE2	= 0x01,		// CPOL = 1, CPHA = 0 -> sample on falling edge
+	SPI_MODE3	= 0x03,		// CPOL = 1, CPHA = 1 -> sample on rising edge
+}USARTSPIModes;			// UCPOLn and UCPHAn bits of UCSRnC
+
+typedef enum
+{
+	MSB_FIRST	= 0x00,
+	LSB_FIRST	= 0x04,		// UDORDn bit of UCSRnC
+}USARTSPIDataOrder;
+
+typedef struct
+{
+	uint32_t			USART_SPI_ClockRate;	// SCK frequency, upto F_CPU/2. Rounded down to the next possible rate
+	USARTSPIModes		USART_SPI_Mode;			// SPI mode 0 to 3
+	USARTSPIDataOrder	USART_SPI_DataOrder;	// MSB or LSB first
+}USART_SPI_StructureType;
+
+/* exported functions ------------------------------------------------------------------*/
+uint32_t USART_SPIInit(uint8_t, USART_SPI_StructureType);
+uint8_t USART_SPI_Transfer(uint8_t, uint8_t);
+void USART_SPI_TransferBuffer(uint8_t, const uint8_t *, uint8_t *, uint16_t);
+
+#endif // end of __ATMEGA644P_USART_SPI_H
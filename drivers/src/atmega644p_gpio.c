@@ -1,5 +1,5 @@
 /**  ******************************************************************************  * @file    atmega644p_gpio.c  * @author  Basavaraju B V  * @version V1.0.0  * @date    09-July-2013  * @brief   This file contails basic functions to initialize the GPIOs in the controller  * @Note	 If the mode is selected as input, then for the corresponding pin  *			 resistor should be pulled-up by writing 1 to that pin.  ******************************************************************************  *  *					HOW TO USE  * 1. Call the appropiate function with the arguents which whose enums are in the atmega644p_gpio.h file.  ******************************************************************************  *//* Includes ------------------------------------------------------------------*/
-#include "atmega644p_gpio.h"
+#include "atmega644p_gpio.h"#include "power.h"/* *  Hooks of the pin change interrupts, one per port: PCINT0 -> PORTA, PCINT1 -> PORTB, PCINT2 -> PORTC, PCINT3 -> PORTD */static GPIO_PinChangeHookType gPinChangeHook[4];
 /*
  *  This Function returns the pointer to the SFR_IO8 page! So it should be volatile
  *  Check iomxx4.h file for more detials on PORTx/PINx/DDRx
@@ -8,5 +8,5 @@
  *  Volatile is used for ret value and the function because to avoid warnings and compiler should not optimise the code!
  */static volatile uint8_t *(GetSFR_IO_Reg(ports GPIOx, actions action)){
     volatile uint8_t *ret = 0;    switch(GPIOx+action)	{		case 0:		ret = &(PINA); 	    break;		case 1:		ret = &(DDRA); 	    break;		case 2:		ret = &(PORTA); 	break;		case 3:		ret = &(PINB); 	    break;		case 4:		ret = &(DDRB); 	    break;		case 5:		ret = &(PORTB); 	break;		case 6:		ret = &(PINC); 	    break;		case 7:		ret = &(DDRC); 	    break;		case 8:		ret = &(PORTC); 	break;		case 9:		ret = &(PIND); 	    break;		case 10:	ret = &(DDRD); 	    break;		case 11:	ret = &(PORTD); 	break;		//defaulf: 			            break;	}
-	return ret;}void GPIO_Write(ports GPIOx, pins pin, uint8_t val){	volatile uint8_t *GPIO = GetSFR_IO_Reg(GPIOx, WRITE);	if(val != GPIO_PIN_RESET)	{		*GPIO = (*GPIO | pin);	}	else	{		*GPIO = (*GPIO & ~pin);	}}uint8_t GPIO_Read(ports GPIOx, pins pin){	volatile uint8_t *GPIO = GetSFR_IO_Reg(GPIOx, READ);	return (*GPIO & pin);}void GPIO_Config(ports GPIOx, pins pin, modes mode){	volatile uint8_t *GPIO = GetSFR_IO_Reg(GPIOx, CONFIG);	if(mode != INPUT)	{		*GPIO = (*GPIO | pin);	}	else	{		*GPIO = (*GPIO & ~pin);		/*		*	once the Pin is configured as input. Internal PULL-UP resister		*	should be activated. Below code does that.		*/		GPIO = GetSFR_IO_Reg(GPIOx, WRITE);		*GPIO = (*GPIO | pin);	}}
+	return ret;}void GPIO_Write(ports GPIOx, pins pin, uint8_t val){	volatile uint8_t *GPIO = GetSFR_IO_Reg(GPIOx, WRITE);	if(val != GPIO_PIN_RESET)	{		REG_SET(*GPIO, pin);	}	else	{		REG_CLEAR(*GPIO, pin);	}}uint8_t GPIO_Read(ports GPIOx, pins pin){	volatile uint8_t *GPIO = GetSFR_IO_Reg(GPIOx, READ);	return (REG_READ(*GPIO) & pin);}void GPIO_Config(ports GPIOx, pins pin, modes mode){	volatile uint8_t *GPIO = GetSFR_IO_Reg(GPIOx, CONFIG);	if(mode != INPUT)	{		REG_SET(*GPIO, pin);	}	else	{		REG_CLEAR(*GPIO, pin);		/*		*	once the Pin is configured as input. Internal PULL-UP resister		*	should be activated. Below code does that.		*/		GPIO = GetSFR_IO_Reg(GPIOx, WRITE);		REG_SET(*GPIO, pin);	}}/* *  This Function returns the pin change mask register (PCMSKx) of the port */static volatile uint8_t *(GetPinChangeMask(ports GPIOx)){	volatile uint8_t *ret = 0;	switch(GPIOx)	{		case GPIOA:		ret = &(PCMSK0); 	break;		case GPIOB:		ret = &(PCMSK1); 	break;		case GPIOC:		ret = &(PCMSK2); 	break;		case GPIOD:		ret = &(PCMSK3); 	break;	}	return ret;}/* *  Enables the pin change interrupt of the pins and registers the hook called when one of them toggles. *  One hook per port: a new registration for the port replaces the hook of the previous one. *  With hook == NULL the pin change interrupt of the pins is disabled. *  The hook is executed in interrupt context with the value of PINx, so it has to be short! */void GPIO_RegisterPinChangeHook(ports GPIOx, pins pin, GPIO_PinChangeHookType hook){	volatile uint8_t *mask = GetPinChangeMask(GPIOx);	uint8_t control = 0x01 << (GPIOx / 3);	// PCIEx bit of PCICR	uint8_t sreg = SREG;	cli();	if(hook != 0)	{		gPinChangeHook[GPIOx / 3] = hook;		REG_SET(*mask, pin);		REG_SET(PCICR, control);	}	else	{		REG_CLEAR(*mask, pin);		if(REG_READ(*mask) == 0x00)		{			REG_CLEAR(PCICR, control);			gPinChangeHook[GPIOx / 3] = 0;		}	}	SREG = sreg | GLOBAL_INTERRUPT_ENABLE;	// Pin change is only useful with the global interrupt enabled}/* *  Common part of the pin change ISRs, a pin change wakes the CPU up from any sleep mode (see power.c) */static inline void GPIO_PinChangeIRQ(ports GPIOx){	POWER_WAKE_STAMP();	if(gPinChangeHook[GPIOx / 3] != 0)		gPinChangeHook[GPIOx / 3](GPIOx, REG_READ(*GetSFR_IO_Reg(GPIOx, READ)));}GPIOA_PinChange_IRQHandler(){	GPIO_PinChangeIRQ(GPIOA);}GPIOB_PinChange_IRQHandler(){	GPIO_PinChangeIRQ(GPIOB);}GPIOC_PinChange_IRQHandler(){	GPIO_PinChangeIRQ(GPIOC);}GPIOD_PinChange_IRQHandler(){	GPIO_PinChangeIRQ(GPIOD);}
 
@@ -21,7 +21,7 @@
   * 7. Once Data is received after performing actions please make sure that buffer is flusshed using I2C_FlushReceiveBuffer()
   * -> Slave Mode:
   * 2. fill the data using I2C_TransmitBufferFill(), Incase if master requests data then this data will be used!
-  * 3. Wait until device is address using I2C_GetSlaveDirection()
+  * 3. Wait until device is address using I2C_GetSlaveDirection(), or sleep in power-down until then with I2C_WaitForAddress()
   * 4. Once device is addressed, check the direction using I2C_GetSlaveDirection()
   * 5. If it is receive, then wait for data to be filled in buffer using i2c_DataReceived()
   * 6. Once Data is received and after performing actions, flush the receive buffer using ()
@@ -32,6 +32,10 @@
 
 /*----------------------------------- Includes -------------------------------*/
 #include "atmega644p_i2c.h"
+#include "profile.h"
+#include "trace.h"
+#include "pool.h"
+#include "power.h"
 
 /*---------------------------------- Global Variables ----------------------------------*/
 static uint8_t gI2C_Slave_Address;
@@ -41,12 +45,14 @@ static uint8_t gI2C_TransmitFlag = 0xFF;	// 0xFF = Direction Unknown, 0x00 -> Re
 static uint8_t gI2C_CommunicationError =0x00;
 static I2CModesOfOperation gMode;
 
-static uint8_t* gI2C_Connected_Devices = NULL;
+static uint8_t gI2C_Connected_Devices[TOTAL_POSSIBLE_DEVICES / 8];	// bit n of byte n / 8 -> device n has acknowledged
+static uint8_t gI2C_Devices_Discovered = 0x00;
 static uint8_t* gReceive_Buffer_I2C = NULL;		// Once Received data is printed the buffer needs to be freed
 static uint8_t* gTrasnmit_Buffer_I2C = NULL;		// Once the data is tranmitted the buffer needs to be freed
 static uint8_t gReceive_Buffer_Index = 0;
 static uint8_t gTransmit_Buffer_Index = 0;
 static uint8_t gReceiveBufferSize = 0;
+static I2C_EventHookType gI2C_EventHook = NULL;
 
 
 /*---------------------------------- Function and Hooks ----------------------------------*/
@@ -73,7 +79,7 @@ uint8_t I2CInit(I2C_StructureType *I2CStruct)
 
 	if((gI2C_Self_Address) && (gI2C_Self_Address <= 0x7F))
 	{
-		TWAR = (gI2C_Self_Address << 1) | (I2CStruct->I2C_GeneralCall != DISABLE ? 0x01 : 0x00);
+		REG_WRITE(TWAR, (gI2C_Self_Address << 1) | (I2CStruct->I2C_GeneralCall != DISABLE ? 0x01 : 0x00));
 	}
 	else
 	{
@@ -81,12 +87,12 @@ uint8_t I2CInit(I2C_StructureType *I2CStruct)
 		return retVal;
 	}
 
-	TWCR = I2CStruct->I2C_Activate != DISABLE ?  0x04 : 0x00;			// -> 0000 0100
-	TWCR |= I2CStruct->I2C_Acknowledgement != DISABLE ? 0x40 : 0x00;	// -> 0100 0000
+	REG_WRITE(TWCR, I2CStruct->I2C_Activate != DISABLE ?  0x04 : 0x00);			// -> 0000 0100
+	REG_SET(TWCR, I2CStruct->I2C_Acknowledgement != DISABLE ? 0x40 : 0x00);	// -> 0100 0000
 
 	if(I2CStruct->I2C_Interrupt != DISABLE)
 	{
-		TWCR |= 0x01;
+		REG_SET(TWCR, 0x01);
 		SREG |= GLOBAL_INTERRUPT_FLAG_ENABLE;
 	}
 
@@ -100,7 +106,7 @@ uint8_t I2CInit(I2C_StructureType *I2CStruct)
 		}
 		else
 		{
-			TWBR = bitRateRegister;
+			REG_WRITE(TWBR, bitRateRegister);
 		}
 	}
 	else
@@ -191,11 +197,11 @@ uint8_t I2C_InitStructureDefault(I2C_StructureType *I2CStruct)
 uint8_t I2C_StartCommunication(void)
 {
 	uint8_t retVal = 0x00;
-	if(TWCR & 0x04)		// Check for I@C enable condition!
+	if(REG_READ(TWCR) & 0x04)		// Check for I@C enable condition!
 	{
 		if(gMode != eSLAVE_MODE)
 		{
-			TWCR |= 0xA0;	// -> 1010 0000
+			REG_SET(TWCR, 0xA0);	// -> 1010 0000
 		}
 		else
 		{
@@ -223,7 +229,7 @@ static uint8_t I2C_SetStopBit(void)
 	uint8_t retVal = 0x00;
 	if(gMode != eSLAVE_MODE)
 	{
-		TWCR |= 0x10; 	// -> 0001 0000
+		REG_SET(TWCR, 0x10); 	// -> 0001 0000
 
 		I2C_FlushTransmitBuffer();
 	}
@@ -245,7 +251,7 @@ uint8_t I2C_StopCommunication(void)
 {
 	uint8_t retVal = 0x00;
 
-	TWCR &= 0xFB;	// -> 1111 1011
+	REG_WRITE(TWCR, REG_READ(TWCR) & 0xFB);	// -> 1111 1011
 	I2C_FlushReceiveBuffer();
 	I2C_FlushTransmitBuffer();
 
@@ -258,25 +264,28 @@ uint8_t I2C_StopCommunication(void)
  * @param	data - pointer of type uint8_t -> data needs to be tranmitted to other device!
  * @retval  0x00 - Succeed!
 			0x0A - I2C is configured in Slave mode and asked to fill the tranmit buffer
+			0x0F - No free block in the pool (pool.c) for the data
+			0x11 - String is longer than I2C_MAX_TRANSMIT_LENGTH characters, the buffer is left as it is
  * @note
  */
 uint8_t I2C_TransmitBufferFill(const char* data)
 {
 	uint8_t retVal = 0x00;
-	uint8_t length = 0;
+	uint16_t length = 0;
 	uint8_t *temp = (uint8_t *)data;
 
 	if(gMode == eSLAVE_MODE || gI2C_TransmitFlag == 0x01)		//Either in slva mode or for Master Transmit mode!
 	{
 		while(*temp != '\0')
 		{
-			length++;
+			if(++length > I2C_MAX_TRANSMIT_LENGTH)
+				return 0x11;	// gTransmit_Buffer_Index is 8 bit
 			temp++;
 		}
-		if(length != 0)
-		{
-			gTrasnmit_Buffer_I2C = (uint8_t*)(malloc((sizeof(uint8_t) * length) + 1));	// Allocate only the necessary size of buffer
-		}
+		Pool_Free(gTrasnmit_Buffer_I2C);	// Buffer of the previous fill which has not been flushed
+		gTrasnmit_Buffer_I2C = (uint8_t*)(Pool_Alloc((sizeof(uint8_t) * length) + 1));	// Block of the smallest class which fits it
+		if(gTrasnmit_Buffer_I2C == NULL)
+			return 0x0F;		// No free block in the pool
 		for(gTransmit_Buffer_Index = 0; *data != '\0'; data++, gTransmit_Buffer_Index++)
 			gTrasnmit_Buffer_I2C[gTransmit_Buffer_Index] = *data;
 
@@ -310,19 +319,28 @@ void I2C_SetReceiveBufferSize(uint8_t length)
  * @param	data - of type uint8_t -> data that has been recieved!
  * @retval  0x00 - Succeed!
 			0x0B - Receive Buffer is full! Cannot receive any more data!
- * @note
+			0x0F - No free block in the pool (pool.c) for the data
+ * @note	Called from the ISR, Pool_Alloc() takes a constant time
  */
 static uint8_t I2C_ReceivedData(uint8_t data)
 {
 	uint8_t retVal = 0x00;
 
 	if((gI2C_TransmitFlag == 0x00) && (gReceive_Buffer_Index == 0))
-		gReceive_Buffer_I2C = (uint8_t *)(calloc(gReceiveBufferSize + 1, sizeof(uint8_t)));
+	{
+		Pool_Free(gReceive_Buffer_I2C);
+		gReceive_Buffer_I2C = (uint8_t *)(Pool_Alloc(gReceiveBufferSize + 1));
+	}
 
-	if(gReceive_Buffer_Index < gReceiveBufferSize)
+	if(gReceive_Buffer_I2C == NULL)
+	{
+		retVal = 0x0F;		// No free block in the pool
+	}
+	else if(gReceive_Buffer_Index < gReceiveBufferSize)
 	{
 		gReceive_Buffer_I2C[gReceive_Buffer_Index] = data;
 		gReceive_Buffer_Index++;
+		gReceive_Buffer_I2C[gReceive_Buffer_Index] = '\0';	// Kept terminated instead of clearing the whole block in the ISR
 	}
 	else
 	{
@@ -366,7 +384,8 @@ uint8_t I2C_FlushReceiveBuffer(void)
 
 	if(gReceive_Buffer_Index != 0)
 	{
-		free(gReceive_Buffer_I2C);
+		Pool_Free(gReceive_Buffer_I2C);
+		gReceive_Buffer_I2C = NULL;
 		gReceive_Buffer_Index = 0;
 	}
 	else
@@ -389,7 +408,8 @@ uint8_t I2C_FlushTransmitBuffer(void)
 
 	if(gTrasnmit_Buffer_I2C != NULL)
 	{
-		free(gReceive_Buffer_I2C);
+		Pool_Free(gTrasnmit_Buffer_I2C);
+		gTrasnmit_Buffer_I2C = NULL;
 		gTransmit_Buffer_Index = 0;
 	}
 	else
@@ -405,7 +425,7 @@ uint8_t I2C_FlushTransmitBuffer(void)
  * @retval  0x00 - Succeed!
  *			0x0D - There are no connected devices
  * @note	This function will only check if there is a positive ACK for the address! it will not send any data after that!
- *			gI2C_Connected_Devices[index] == 0xFF if no device is connected for that address!
+ *			The devices are kept as a bitmap in gI2C_Connected_Devices (16 bytes), not in a pool block.
  */
 uint8_t I2C_DiscoverConnectedDevices(void)
 {
@@ -417,29 +437,25 @@ uint8_t I2C_DiscoverConnectedDevices(void)
 
 	if((!(I2C_InitStructureDefault(&i2c))) && (!(I2CInit(&i2c))))	// Configure as Master Trasmitter! and Initialize the I2C registers!
 	{
-		gI2C_Connected_Devices = (uint8_t *)(malloc(sizeof(uint8_t) * TOTAL_POSSIBLE_DEVICES));
+		for(address = 0; address < (TOTAL_POSSIBLE_DEVICES / 8); address++)
+			gI2C_Connected_Devices[address] = 0x00;
+		gI2C_Devices_Discovered = 0x01;		// Kept for I2C_PrintDescoveredDevices()
+
 		for(address = 0; address<=0x7F; address++)
 		{
 			gI2C_Address_Positive_ACK = 0x00;
 			if(!(I2C_UpdateSlaveAddress(address)))	// Update the address!
 			{
 				I2C_StartCommunication();			// Start the communication and wait for the flag to change!
-				while(!gI2C_Address_Positive_ACK)
-				;
+				POWER_WAIT_UNTIL(gI2C_Address_Positive_ACK, SLEEP_MODE_IDLE);	// TWI master needs the clock
 
 				if(gI2C_Address_Positive_ACK == 0x01)
 				{
-					gI2C_Connected_Devices[address] = address & 0xFF;
+					gI2C_Connected_Devices[address / 8] |= 0x01 << (address % 8);
 					noDevicesConnected = 0x00;		// at least one device is connected!
 				}
-				else
-					gI2C_Connected_Devices[address] = 0xFF;			// When device's address doesn't match!
-			}
-			else
-			{
-				gI2C_Connected_Devices[address] = 0xFF;		// For Self address as well it is assumed to be negative ack as it cannot address itself!
-				continue;
 			}
+			// Self address is left as not connected, the device cannot address itself!
 		}
 		gI2C_TransmitFlag = 0xFF;	//Resett the Transmit Flag to Unknown direction
 	}
@@ -464,7 +480,7 @@ uint8_t I2C_PrintDescoveredDevices(void)
 	uint8_t retVal = 0x00;
 	uint8_t index;
 
-	if(gI2C_Connected_Devices != NULL)	// Make sure that I2C_DiscoverConnectedDevices() is called before calling this function!
+	if(gI2C_Devices_Discovered)	// Make sure that I2C_DiscoverConnectedDevices() is called before calling this function!
 	{
 		print("\n\r\t0x00  0x01  0x02  0x03  0x04  0x05  0x06  0x07  0x08  0x09  0x0A  0x0B  0x0C  0x0D  0x0E  0x0F");
 		for(index = 0; index < TOTAL_POSSIBLE_DEVICES; index++)
@@ -472,9 +488,9 @@ uint8_t I2C_PrintDescoveredDevices(void)
 			if(index%16 == 0)
 				print("\n\r%x\t", (uint32_t)(index));
 
-			if(gI2C_Connected_Devices[index] != 0xFF)
+			if(gI2C_Connected_Devices[index / 8] & (0x01 << (index % 8)))
 			{
-				print("0x%x  ", (uint32_t)(gI2C_Connected_Devices[index]));
+				print("0x%x  ", (uint32_t)(index));
 			}
 			else
                 print("-     ");
@@ -497,9 +513,9 @@ uint8_t I2C_PrintDescoveredDevices(void)
 void I2C_SetAcknowledgementBit(uint8_t value)
 {
 	if(value)
-		TWCR |= 0x40;
+		REG_SET(TWCR, 0x40);
 	else
-		TWCR &= 0xBF;
+		REG_WRITE(TWCR, REG_READ(TWCR) & 0xBF);
 }
 
 /*
@@ -518,6 +534,22 @@ uint8_t I2C_GetCommunicationError(void)
 	return gI2C_CommunicationError;
 }
 
+/*
+ * @name	I2C_RegisterEventHook
+ * @brief	This function will register the function called at the end of every I2C interrupt
+ * @param	hook - function called with the status (TWSR) which has been served, NULL to remove the hook
+ * @retval  -
+ * @note	The hook is executed in interrupt context, it has to be short! (e.g. post a task to the scheduler)
+ */
+void I2C_RegisterEventHook(I2C_EventHookType hook)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	gI2C_EventHook = hook;
+	SREG = sreg;
+}
+
 /*
  * @name	I2C_ResetInterruptFalg
  * @brief	This function will reset the interrupt flag!
@@ -527,7 +559,7 @@ uint8_t I2C_GetCommunicationError(void)
  */
 static void I2C_ResetInterruptFalg(void)
 {
-	TWCR |= 0x80;	// -> 1000 0000
+	REG_SET(TWCR, 0x80);	// -> 1000 0000
 }
 
 /*
@@ -544,33 +576,60 @@ uint8_t I2C_GetSlaveDirection(void)
 	return gI2C_TransmitFlag;
 }
 
+/*
+ * @name	I2C_WaitForAddress
+ * @brief	This function will wait in power-down until the device is addressed as slave
+ * @param	-
+ * @retval  0x00 -> in receive mode
+ *			0x01 -> in transmit mode
+ *			0xFF -> Not in slave mode with I2C, acknowledgement and interrupt enabled, it cannot be addressed
+ * @note	Instead of polling I2C_GetSlaveDirection(). The TWI address match wakes the CPU up from power-down,
+ *			the hardware stretches SCL until the ISR has served it. The USARTs and timers are stopped meanwhile.
+ */
+uint8_t I2C_WaitForAddress(void)
+{
+	if((gMode != eSLAVE_MODE) || ((REG_READ(TWCR) & 0x45) != 0x45))	// -> 0100 0101 TWEA, TWEN and TWIE
+		return 0xFF;
+
+	POWER_WAIT_UNTIL(gI2C_TransmitFlag != 0xFF, SLEEP_MODE_PWR_DOWN);
+	return gI2C_TransmitFlag;
+}
+
 /*
  * @name	I2C_IRQHandler
  * @brief	This is a ISR for I2C or TWI of Atmega644P
  * @param	-
  * @retval  -
  * @note	The user can modify this according to his requirements!
+ *			The hook registered with I2C_RegisterEventHook() is called with the status once the state has been served.
  */
 I2C_IRQHandler()
 {
-	switch(TWSR & 0xFF)
+	uint8_t status;
+
+	POWER_WAKE_STAMP();
+	PROFILE_ENTER(ePROFILE_I2C_IRQ);
+	status = REG_READ(TWSR) & 0xFF;
+	TRACE(eTRACE_I2C, status, 0);
+	switch(status)
 	{
 	//Master Common
 		case MASTER_START_SENT:
 		case MASTER_REPEATED_START_SENT:
 
-			TWDR = (((gI2C_Slave_Address & 0xFF) << 1) | (gMode & 0x01));
-			TWCR &= 0xDF; // -> 1101 1111 Reset the TWSTA bit in the control regester! to avoid repeated start!
+			REG_WRITE(TWDR, (((gI2C_Slave_Address & 0xFF) << 1) | (gMode & 0x01)));
+			REG_WRITE(TWCR, REG_READ(TWCR) & 0xDF); // -> 1101 1111 Reset the TWSTA bit in the control regester! to avoid repeated start!
 			I2C_ResetInterruptFalg();
 			break;
 
 	//Master Trasmit
 		case MASTER_TRANSMIT_ADDRESS_POSITIVE_ACK:
 			gI2C_Address_Positive_ACK = 0x01;		// for Discovering devices!
+			// fall through
 		case MASTER_TRANSMIT_DATA_POSITIVE_ACK:
 			if((gTrasnmit_Buffer_I2C != NULL) && (gTrasnmit_Buffer_I2C[gTransmit_Buffer_Index] != '\0'))
 			{
-				TWDR = gTrasnmit_Buffer_I2C[gTransmit_Buffer_Index] & 0xFF;
+				REG_WRITE(TWDR, gTrasnmit_Buffer_I2C[gTransmit_Buffer_Index] & 0xFF);
 				gTransmit_Buffer_Index++;
 				I2C_ResetInterruptFalg();
 			}
@@ -604,7 +663,8 @@ I2C_IRQHandler()
 
 	//Master Receive
 		case MASTER_RECEIVE_DATA_POSITIVE_ACK:
-			I2C_ReceivedData(TWDR & 0xFF);
+			I2C_ReceivedData(REG_READ(TWDR) & 0xFF);
+			// fall through
 		case MASTER_RECEIVE_ADDRESS_POSITIVE_ACK:
 
 			if(gReceive_Buffer_Index >= gReceiveBufferSize)
@@ -622,7 +682,8 @@ I2C_IRQHandler()
 			break;
 
 		case MASTER_RECEIVE_DATA_NEGATIVE_ACK:
-			I2C_ReceivedData(TWDR & 0xFF);
+			I2C_ReceivedData(REG_READ(TWDR) & 0xFF);
+			// fall through
 		case MASTER_RECEIVE_ADDRESS_NEGATIVE_ACK:
 
 			I2C_SetStopBit();
@@ -645,10 +706,11 @@ I2C_IRQHandler()
 		case SLAVE_RECEIVE_DATA_POSITIVE_ACK:
 		case SLAVE_RECEIVE_GENERAL_CALL_DATA_POSITIVE_ACK:
 
-			I2C_ReceivedData(TWDR & 0xFF);
+			I2C_ReceivedData(REG_READ(TWDR) & 0xFF);
 			if(gReceive_Buffer_Index >= gReceiveBufferSize)
 			{
-				gReceive_Buffer_I2C[gReceive_Buffer_Index] = '\0';
+				if(gReceive_Buffer_I2C != NULL)
+					gReceive_Buffer_I2C[gReceive_Buffer_Index] = '\0';
 				I2C_SetAcknowledgementBit(0); //Negative Acknoledgement
 			}
 			else
@@ -666,7 +728,7 @@ I2C_IRQHandler()
 			break;
 
 		case SLAVE_STOP_OR_REPEATED_START:
-			if(gReceive_Buffer_Index < gReceiveBufferSize)
+			if((gReceive_Buffer_I2C != NULL) && (gReceive_Buffer_Index < gReceiveBufferSize))
 				gReceive_Buffer_I2C[gReceive_Buffer_Index] = '\0';
 			I2C_SetAcknowledgementBit(1); //Positive Acknoledgement
 			I2C_ResetInterruptFalg();
@@ -677,11 +739,12 @@ I2C_IRQHandler()
 		case ARBITRATION_LOST_ADDRESSED_SLAVE_TRANSMIT:
 			gI2C_TransmitFlag = 0x01;		//Set the tranmit flag to 1
 			gTransmit_Buffer_Index = 0;		// TO make sure that index is pointing to 0
+			// fall through
 		case SLAVE_TRANSMIT_DATA_POSITIVE_ACK:
 
 			if((gTrasnmit_Buffer_I2C != NULL) && (gTrasnmit_Buffer_I2C[gTransmit_Buffer_Index] != '\0'))
 			{
-				TWDR = gTrasnmit_Buffer_I2C[gTransmit_Buffer_Index];
+				REG_WRITE(TWDR, gTrasnmit_Buffer_I2C[gTransmit_Buffer_Index]);
 				gTransmit_Buffer_Index++;
 				I2C_SetAcknowledgementBit(1); //Positive Acknoledgement
 			}
@@ -713,7 +776,11 @@ I2C_IRQHandler()
 			break;
 
 		default:
-			print("\n\rImplementation of state %x has been missed! Inform the developer of this driver\n\r", (uint32_t)(TWSR&0xFF));
+			print("\n\rImplementation of state %x has been missed! Inform the developer of this driver\n\r", (uint32_t)(REG_READ(TWSR)&0xFF));
 			break;
 	}
+
+	if(gI2C_EventHook != NULL)
+		gI2C_EventHook(status);
+	PROFILE_EXIT(ePROFILE_I2C_IRQ);
 }
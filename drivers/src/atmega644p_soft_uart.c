@@ -0,0 +1,450 @@
+/**
+  ******************************************************************************
+  * @file    atmega644p_soft_uart.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file has the software UARTs: 8 data bits, no parity, 1 stop bit on any GPIO pins
+  * @Note	 The bit timing comes from the free running Timer1 (clk/1): every transmit edge and every
+  *			 receive sample is a compare match at an absolute cycle, bit time = F_CPU / baud rate.
+  *			 Transmit and receive of a software UART share its compare unit: the ISR handles the
+  *			 events which are due (within SOFTUART_WINDOW_CYCLES) and arms the compare for the next one.
+  *			 So there is exactly one compare ISR per bit and direction, its cost does not depend on the
+  *			 baud rate. Errors do not add up, the next bit is at the previous time + bit time.
+  *			 Receive: the falling edge of the start bit raises the pin change interrupt, the samples are
+  *			 taken in the middle of the bits (edge + 1.5, 2.5 ... bit times). The start bit is sampled as
+  *			 well, a glitch shorter than half a bit is ignored. Pin changes during a character are ignored.
+  *			 The pin registers are accessed directly in the ISRs, a GPIO_Write() through the driver
+  *			 would cost more than the rest of the ISR.
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Call SOFTUART_Init() with SOFTUART0 or SOFTUART1, the baud rate and the pins. It returns the actual baud rate
+  *    (0 if the baud rate is not supported). The global interrupts are enabled.
+  * 2. SOFTUART_WriteChar() queues a byte (waits only while the transmit buffer is full),
+  *    SOFTUART_StartTransmit() sends a buffer and calls the complete hook after its last stop bit
+  * 3. SOFTUART_ReadChar() reads the receive buffer, the words have the USART_RX_ERRORS flags as the USART driver
+  *    (frame error: stop bit low, overrun: data has been lost before this one). Or register a hook with
+  *    SOFTUART_RegisterReceiveHook(), called from the ISR with every received word.
+  * 4. Other pins of the transmit port are written with a read-modify-write by the ISR: the application has to write
+  *    them with the interrupts disabled.
+  ******************************************************************************
+  */
+
+/*----------------------------------- Includes -------------------------------*/
+#include "atmega644p_soft_uart.h"
+#include "atmega644p_timer.h"
+#include "fifo.h"
+
+/*---------------------------------- Defines ----------------------------------*/
+#define SOFTUART_FRAME_BITS			10			// start bit, 8 data bits, stop bit
+#define SOFTUART_STOP_BIT			0x0200		// bit 9 of the transmit frame
+#define SOFTUART_WINDOW_CYCLES		32			// events due within this time are handled by the same ISR
+#define SOFTUART_START_CYCLES		64			// first edge of a transmission after the call
+#define SOFTUART_RX_LATENCY_CYCLES	48			// falling edge of the start bit to the time stamp in the pin change ISR
+
+/*---------------------------------- Typedefs ----------------------------------*/
+FIFO_DEFINE(SOFTUART_Tx, uint8_t, SOFTUART_TX_BUFFER_SIZE)
+FIFO_DEFINE(SOFTUART_Rx, uint16_t, SOFTUART_RX_BUFFER_SIZE)
+
+typedef struct
+{
+	volatile uint8_t	*High;			// OCR1xH
+	volatile uint8_t	*Low;			// OCR1xL
+	uint8_t				Interrupt;		// OCIE1x / OCF1x
+}SOFTUART_CompareType;
+
+typedef struct
+{
+	volatile uint8_t				*TxRegister;	// PORTx of the transmit pin
+	uint8_t							TxMask;
+	volatile uint8_t				*RxRegister;	// PINx of the receive pin
+	uint8_t							RxMask;
+	ports							RxPort;
+	uint8_t							Enabled;
+	uint16_t						BitCycles;
+	//Transmit
+	volatile uint8_t				TxActive;		// a character is on the line
+	uint16_t						TxFrame;		// bits still to be sent, LSB first
+	uint8_t							TxBits;
+	uint16_t						TxNext;			// cycle of the next edge
+	SOFTUART_Tx_FifoType			Tx;				// produced by SOFTUART_WriteChar(), consumed by the ISR
+	const uint8_t * volatile		Data;			// buffer of SOFTUART_StartTransmit()
+	uint16_t						Length;
+	uint16_t						Index;
+	USART_TransmitCompleteHookType	Complete;
+	//Receive
+	uint8_t							RxBits;			// samples still to be taken, 0 -> waiting for a start bit
+	uint8_t							RxShift;
+	uint16_t						RxNext;			// cycle of the next sample
+	uint8_t							RxOverrun;
+	SOFTUART_Rx_FifoType			Rx;				// produced by the ISR, consumed by SOFTUART_ReadChar()
+	USART_ReceiveHookType			Hook;
+}SOFTUART_Type;
+
+/*---------------------------------- Global Variables ----------------------------------*/
+static SOFTUART_Type gSOFTUART[2];
+
+static const SOFTUART_CompareType gSOFTUART_Compare[2] =
+{
+	{ &(OCR1AH), &(OCR1AL), TIMER1_COMPARE_A_INTERRUPT },
+	{ &(OCR1BH), &(OCR1BL), TIMER1_COMPARE_B_INTERRUPT },
+};
+
+//Indexed with GPIOx / 3
+static volatile uint8_t * const gSOFTUART_PinRegisters[4] = { &(PINA), &(PINB), &(PINC), &(PIND) };
+static volatile uint8_t * const gSOFTUART_PortRegisters[4] = { &(PORTA), &(PORTB), &(PORTC), &(PORTD) };
+
+/*---------------------------------- Function and Hooks ----------------------------------*/
+
+/*
+ * @name   	SOFTUART_Schedule(uint8_t, SOFTUART_Type *)
+ * @brief	This function arms the compare unit for the next transmit edge or receive sample
+ * @retval	1 - the next event is already due and has to be handled now, 0 - compare is armed or nothing to do
+ * @note	Called with the interrupts disabled
+ */
+static uint8_t SOFTUART_Schedule(uint8_t __SOFTUARTType__, SOFTUART_Type *uart)
+{
+	const SOFTUART_CompareType *compare = &gSOFTUART_Compare[__SOFTUARTType__];
+	uint16_t next = uart->TxNext;
+
+	if(!uart->TxActive && !uart->RxBits)
+	{
+		REG_CLEAR(TIMSK1, compare->Interrupt);
+		return 0;
+	}
+	if(uart->RxBits && (!uart->TxActive || ((int16_t)(uart->RxNext - next) < 0)))
+		next = uart->RxNext;
+
+	TIMER1_SetCompare(compare->High, compare->Low, next);
+	REG_WRITE(TIFR1, compare->Interrupt);				// match of the previous event, cleared by writing one
+	REG_SET(TIMSK1, compare->Interrupt);
+
+	//The compare matches only if the counter has not passed it yet
+	return ((int16_t)(next - TIMER1_GetCount()) <= SOFTUART_WINDOW_CYCLES) ? 1 : 0;
+}
+
+/*
+ * @name   	SOFTUART_NextByte(uint8_t, SOFTUART_Type *, uint8_t *)
+ * @brief	This function takes the next byte to send: buffer of SOFTUART_StartTransmit() first, then the queue
+ * @retval	1 - *data is valid, 0 - nothing to send
+ * @note	The complete hook is called here, i.e. when the stop bit of the last byte of the buffer has been sent
+ */
+static uint8_t SOFTUART_NextByte(uint8_t __SOFTUARTType__, SOFTUART_Type *uart, uint8_t *data)
+{
+	if(uart->Data != NULL)
+	{
+		if(uart->Index < uart->Length)
+		{
+			*data = uart->Data[uart->Index++];
+			return 1;
+		}
+		uart->Data = NULL;
+		if(uart->Complete != NULL)
+			uart->Complete(__SOFTUARTType__);			// can start the next buffer
+		if(uart->Data != NULL)
+		{
+			*data = uart->Data[uart->Index++];
+			return 1;
+		}
+	}
+	return (SOFTUART_Tx_Get(&uart->Tx, data) == 0x00) ? 1 : 0;
+}
+
+/*
+ * @name   	SOFTUART_TransmitBit(uint8_t, SOFTUART_Type *)
+ * @brief	This function drives the transmit pin with the next bit, at the end of the stop bit the next byte starts
+ */
+static inline void SOFTUART_TransmitBit(uint8_t __SOFTUARTType__, SOFTUART_Type *uart)
+{
+	uint8_t data;
+
+	if(uart->TxBits == 0)
+	{
+		if(!SOFTUART_NextByte(__SOFTUARTType__, uart, &data))
+		{
+			uart->TxActive = 0;
+			return;
+		}
+		uart->TxFrame = ((uint16_t)data << 1) | SOFTUART_STOP_BIT;	// start bit is bit 0
+		uart->TxBits = SOFTUART_FRAME_BITS;
+	}
+
+	if(uart->TxFrame & 0x01)
+		REG_SET(*uart->TxRegister, uart->TxMask);
+	else
+		REG_CLEAR(*uart->TxRegister, uart->TxMask);
+	uart->TxFrame >>= 1;
+	uart->TxBits--;
+	uart->TxNext += uart->BitCycles;
+}
+
+/*
+ * @name   	SOFTUART_ReceiveBit(uint8_t, SOFTUART_Type *)
+ * @brief	This function samples the receive pin in the middle of a bit
+ */
+static inline void SOFTUART_ReceiveBit(uint8_t __SOFTUARTType__, SOFTUART_Type *uart)
+{
+	uint8_t level = REG_READ(*uart->RxRegister) & uart->RxMask;
+	uint16_t word;
+
+	if(uart->RxBits == SOFTUART_FRAME_BITS)
+	{
+		if(level)
+		{
+			uart->RxBits = 0;							// glitch, not a start bit
+			return;
+		}
+	}
+	else if(uart->RxBits > 1)
+	{
+		uart->RxShift = (uart->RxShift >> 1) | (level ? 0x80 : 0x00);
+	}
+	else
+	{
+		uart->RxBits = 0;
+		word = uart->RxShift | (level ? 0x0000 : USART_RX_FRAME_ERROR);
+		if(uart->Hook != NULL)
+		{
+			uart->Hook(__SOFTUARTType__, word);
+			return;
+		}
+		if(SOFTUART_Rx_Put(&uart->Rx, word | (uart->RxOverrun ? USART_RX_OVERRUN : 0x0000)) != 0x00)
+		{
+			uart->RxOverrun = 1;						// buffer full, the word is lost
+			return;
+		}
+		uart->RxOverrun = 0;
+		return;
+	}
+	uart->RxBits--;
+	uart->RxNext += uart->BitCycles;
+}
+
+/*
+ * @name   	SOFTUART_TimerIRQ(uint8_t)
+ * @brief	This function is the common part of the compare ISRs: handles the events which are due
+ * @note	Also called with the interrupts disabled when SOFTUART_Schedule() finds an event already due
+ */
+static void SOFTUART_TimerIRQ(uint8_t __SOFTUARTType__)
+{
+	SOFTUART_Type *uart = &gSOFTUART[__SOFTUARTType__];
+	uint16_t now;
+
+	do
+	{
+		now = TIMER1_GetCount();
+		if(uart->TxActive && ((int16_t)(uart->TxNext - now) <= SOFTUART_WINDOW_CYCLES))
+			SOFTUART_TransmitBit(__SOFTUARTType__, uart);
+		if(uart->RxBits && ((int16_t)(uart->RxNext - now) <= SOFTUART_WINDOW_CYCLES))
+			SOFTUART_ReceiveBit(__SOFTUARTType__, uart);
+	}while(SOFTUART_Schedule(__SOFTUARTType__, uart));
+}
+
+/*
+ * @name   	TIMER1_COMPA_IRQHandler()
+ * @brief	Bit timing of SOFTUART0
+ */
+TIMER1_COMPA_IRQHandler()
+{
+	SOFTUART_TimerIRQ(SOFTUART0);
+}
+
+/*
+ * @name   	TIMER1_COMPB_IRQHandler()
+ * @brief	Bit timing of SOFTUART1
+ */
+TIMER1_COMPB_IRQHandler()
+{
+	SOFTUART_TimerIRQ(SOFTUART1);
+}
+
+/*
+ * @name   	SOFTUART_PinChange(ports, uint8_t)
+ * @brief	Pin change hook of the receive port: a falling edge on an idle receive pin is a start bit
+ * @param  	GPIOx - port of the pin change
+ * 			value - PINx
+ */
+static void SOFTUART_PinChange(ports GPIOx, uint8_t value)
+{
+	uint16_t edge = TIMER1_GetCount() - SOFTUART_RX_LATENCY_CYCLES;
+	SOFTUART_Type *uart;
+	uint8_t i;
+
+	for(i = 0; i < 2; i++)
+	{
+		uart = &gSOFTUART[i];
+		if(!uart->Enabled || (uart->RxPort != GPIOx) || uart->RxBits || (value & uart->RxMask))
+			continue;
+
+		uart->RxBits = SOFTUART_FRAME_BITS;
+		uart->RxNext = edge + (uart->BitCycles >> 1);		// middle of the start bit
+		if(SOFTUART_Schedule(i, uart))
+			SOFTUART_TimerIRQ(i);
+	}
+}
+
+/*
+ * @name   	SOFTUART_StartTransmitter(uint8_t, SOFTUART_Type *)
+ * @brief	This function starts sending when the line is idle
+ * @note	Called with the interrupts disabled
+ */
+static void SOFTUART_StartTransmitter(uint8_t __SOFTUARTType__, SOFTUART_Type *uart)
+{
+	if(uart->TxActive)
+		return;											// the ISR takes the data after the current character
+
+	uart->TxBits = 0;									// first event takes the byte and sends its start bit
+	uart->TxNext = TIMER1_GetCount() + SOFTUART_START_CYCLES;
+	uart->TxActive = 1;
+	if(SOFTUART_Schedule(__SOFTUARTType__, uart))
+		SOFTUART_TimerIRQ(__SOFTUARTType__);
+}
+
+/*
+ * @name   	SOFTUART_Init(uint8_t, SOFTUART_StructureType)
+ * @brief	This function is to configure a software UART
+ * @param  	__SOFTUARTType__ - SOFTUART0 or SOFTUART1
+ * 			config           - baud rate and pins
+ * @note	Timer1 is started if it is not running yet. The transmit pin is an output driven high (idle),
+ * 			the receive pin an input with pull-up. The global interrupts are enabled by the pin change hook.
+ * @retval	Actual baud rate, 0 - baud rate out of SOFTUART_MIN_BAUD_RATE to SOFTUART_MAX_BAUD_RATE
+ */
+uint32_t SOFTUART_Init(uint8_t __SOFTUARTType__, SOFTUART_StructureType config)
+{
+	SOFTUART_Type *uart = &gSOFTUART[__SOFTUARTType__ & 0x01];
+	uint8_t sreg = SREG;
+
+	if((config.SOFTUART_BaudRate < SOFTUART_MIN_BAUD_RATE) || (config.SOFTUART_BaudRate > SOFTUART_MAX_BAUD_RATE))
+		return 0;
+
+	cli();
+	REG_CLEAR(TIMSK1, gSOFTUART_Compare[__SOFTUARTType__ & 0x01].Interrupt);
+	uart->BitCycles = (F_CPU + config.SOFTUART_BaudRate / 2) / config.SOFTUART_BaudRate;
+	uart->TxRegister = gSOFTUART_PortRegisters[config.SOFTUART_TxPort / 3];
+	uart->TxMask = config.SOFTUART_TxPin;
+	uart->RxRegister = gSOFTUART_PinRegisters[config.SOFTUART_RxPort / 3];
+	uart->RxMask = config.SOFTUART_RxPin;
+	uart->RxPort = config.SOFTUART_RxPort;
+	uart->TxActive = 0;
+	SOFTUART_Tx_Init(&uart->Tx);
+	uart->Data = NULL;
+	uart->RxBits = 0;
+	uart->RxOverrun = 0;
+	SOFTUART_Rx_Init(&uart->Rx);
+	uart->Hook = NULL;
+	uart->Enabled = 1;
+	SREG = sreg;
+
+	TIMER1_StartFreeRunning();
+	GPIO_Write(config.SOFTUART_TxPort, config.SOFTUART_TxPin, GPIO_PIN_SET);
+	GPIO_Config(config.SOFTUART_TxPort, config.SOFTUART_TxPin, OUTPUT);
+	GPIO_Config(config.SOFTUART_RxPort, config.SOFTUART_RxPin, INPUT);
+	GPIO_RegisterPinChangeHook(config.SOFTUART_RxPort, config.SOFTUART_RxPin, SOFTUART_PinChange);
+
+	return F_CPU / uart->BitCycles;
+}
+
+/*
+ * @name   	SOFTUART_WriteChar(uint8_t, uint8_t)
+ * @brief	This function is to queue a byte for transmission
+ * @param  	__SOFTUARTType__ - SOFTUART0 or SOFTUART1
+ * 			data             - byte to send
+ * @note	Waits while the transmit buffer is full, global interrupts have to be enabled
+ */
+void SOFTUART_WriteChar(uint8_t __SOFTUARTType__, uint8_t data)
+{
+	SOFTUART_Type *uart = &gSOFTUART[__SOFTUARTType__ & 0x01];
+	uint8_t sreg;
+
+	while(SOFTUART_Tx_Put(&uart->Tx, data) != 0x00)
+		;												// the ISR makes room
+
+	sreg = SREG;
+	cli();
+	SOFTUART_StartTransmitter(__SOFTUARTType__ & 0x01, uart);
+	SREG = sreg;
+}
+
+/*
+ * @name   	SOFTUART_ReadChar(uint8_t, uint16_t *)
+ * @brief	This function is to read a received word without waiting
+ * @param  	__SOFTUARTType__ - SOFTUART0 or SOFTUART1
+ * 			data             - received data with the USART_RX_FRAME_ERROR / USART_RX_OVERRUN flags
+ * @retval	0x00 - data has been read, 0x01 - nothing received
+ */
+uint8_t SOFTUART_ReadChar(uint8_t __SOFTUARTType__, uint16_t *data)
+{
+	return SOFTUART_Rx_Get(&gSOFTUART[__SOFTUARTType__ & 0x01].Rx, data);
+}
+
+/*
+ * @name   	SOFTUART_RegisterReceiveHook(uint8_t, USART_ReceiveHookType)
+ * @brief	This function is to register the function called with every received word
+ * @param  	__SOFTUARTType__ - SOFTUART0 or SOFTUART1
+ * 			hook             - called from the compare ISR, NULL to go back to the receive buffer
+ * @note	The hook delays the next bit of the other direction, it has to be short!
+ */
+void SOFTUART_RegisterReceiveHook(uint8_t __SOFTUARTType__, USART_ReceiveHookType hook)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	gSOFTUART[__SOFTUARTType__ & 0x01].Hook = hook;
+	SREG = sreg;
+}
+
+/*
+ * @name   	SOFTUART_StartTransmit(uint8_t, const uint8_t *, uint16_t, USART_TransmitCompleteHookType)
+ * @brief	This function is to send a buffer, interrupt driven
+ * @param  	__SOFTUARTType__ - SOFTUART0 or SOFTUART1
+ * 			data             - data to be sent, has to stay valid until the complete hook is called
+ * 			length           - number of bytes
+ * 			complete         - called from the compare ISR after the last stop bit, can be NULL
+ * @note	The buffer is sent before the bytes queued by SOFTUART_WriteChar() which are not on the line yet
+ * @retval	0x00 - transmission started
+ * 			0x01 - previous buffer is still being sent
+ * 			0x02 - nothing to send
+ */
+uint8_t SOFTUART_StartTransmit(uint8_t __SOFTUARTType__, const uint8_t *data, uint16_t length, USART_TransmitCompleteHookType complete)
+{
+	SOFTUART_Type *uart = &gSOFTUART[__SOFTUARTType__ & 0x01];
+	uint8_t sreg = SREG;
+
+	if((data == NULL) || (length == 0))
+		return 0x02;
+
+	cli();
+	if(uart->Data != NULL)
+	{
+		SREG = sreg;
+		return 0x01;
+	}
+	uart->Length = length;
+	uart->Index = 0;
+	uart->Complete = complete;
+	uart->Data = data;
+	SOFTUART_StartTransmitter(__SOFTUARTType__ & 0x01, uart);
+	SREG = sreg;
+	return 0x00;
+}
+
+/*
+ * @name   	SOFTUART_IsTransmitBusy(uint8_t)
+ * @brief	This function is to check if a character is being sent
+ * @retval	1 - the transmitter is running, 0 - idle
+ */
+uint8_t SOFTUART_IsTransmitBusy(uint8_t __SOFTUARTType__)
+{
+	return gSOFTUART[__SOFTUARTType__ & 0x01].TxActive;
+}
+
+/*
+ * @name   	SOFTUART_WaitTransmitComplete(uint8_t)
+ * @brief	This function is to wait until everything queued has been sent, stop bit included
+ */
+void SOFTUART_WaitTransmitComplete(uint8_t __SOFTUARTType__)
+{
+	while(gSOFTUART[__SOFTUARTType__ & 0x01].TxActive)
+		;
+}
@@ -0,0 +1,166 @@
+/**
+  ******************************************************************************
+  * @file    atmega644p_timer.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file has the Timer0 configuration as a 1ms tick, the Timer1
+  *			 configuration as a free running cycle counter and the Timer2
+  *			 configuration as a free running tick counter for timeouts
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * -> Timer0:
+  * 1. Implement the tick with TIMER0_COMPA_IRQHandler() { ... }
+  * 2. Call TIMER0_StartTick() / TIMER0_StopTick(), the first tick comes 1ms after the start
+  * -> Timer1:
+  * 1. Call TIMER1_StartFreeRunning() once, calling it again does not disturb the counter
+  * 2. Read the counter with TIMER1_GetCount(), elapsed cycles = (uint16_t)(end - start)
+  * 3. For longer times (timeouts) use a stopwatch: TIMER1_StartStopwatch() and TIMER1_ReadStopwatch()
+  *    at least every 65536 cycles (4ms at 16MHz), e.g. in a polling loop
+  * 4. An event at a given cycle: TIMER1_SetCompare() with OCR1A/OCR1B, clear OCF1x and set OCIE1x in TIMSK1,
+  *    implement TIMER1_COMPA_IRQHandler() / TIMER1_COMPB_IRQHandler() (used by atmega644p_soft_uart.c)
+  * -> Timer2:
+  * 1. Call TIMER2_StartFreeRunning() once, calling it again does not disturb the counter
+  * 2. A timeout is a compare match: OCR2x = TCNT2 + ticks, clear OCF2x and set OCIE2x in TIMSK2,
+  *    implement TIMER2_COMPA_IRQHandler() / TIMER2_COMPB_IRQHandler(). Each unit belongs to one user,
+  *    e.g. the idle line timeout of USART0 (A) and USART1 (B).
+  * 3. A periodic check every 256 ticks: set TIMER2_OVERFLOW_INTERRUPT in TIMSK2 and implement
+  *    TIMER2_OVF_IRQHandler() (used by memory_usage.c with MEMORY_CHECK_TIMER=1)
+  ******************************************************************************
+  */
+
+/*----------------------------------- Includes -------------------------------*/
+#include "atmega644p_timer.h"
+
+/*---------------------------------- Function and Hooks ----------------------------------*/
+
+/*
+ * @name	TIMER0_StartTick
+ * @brief	This function starts the 1ms tick of Timer0 (CTC mode, compare match A interrupt)
+ * @param	-
+ * @retval	-
+ * @note	Counter is cleared, so the first interrupt comes a full millisecond after the call.
+ *			Global interrupts have to be enabled by the caller.
+ */
+void TIMER0_StartTick(void)
+{
+	REG_WRITE(TCCR0B, 0x00);						// Stop while configuring
+	REG_WRITE(TCCR0A, TIMER0_CTC_MODE);
+	REG_WRITE(OCR0A, TIMER0_TICK_COMPARE_VALUE);
+	REG_WRITE(TCNT0, 0x00);
+	REG_WRITE(TIFR0, TIMER0_COMPARE_A_INTERRUPT);	// Clear a pending compare match, flag is cleared by writing one
+	REG_SET(TIMSK0, TIMER0_COMPARE_A_INTERRUPT);
+	REG_WRITE(TCCR0B, TIMER0_PRESCALAR_64);
+}
+
+/*
+ * @name	TIMER0_StopTick
+ * @brief	This function stops Timer0, no more tick interrupt is generated
+ * @param	-
+ * @retval	-
+ */
+void TIMER0_StopTick(void)
+{
+	REG_WRITE(TCCR0B, 0x00);						// No clock source
+	REG_CLEAR(TIMSK0, TIMER0_COMPARE_A_INTERRUPT);
+}
+
+/*
+ * @name	TIMER0_IsTickRunning
+ * @brief	This function checks whether the tick of Timer0 is running
+ * @param	-
+ * @retval	0x00 - stopped, 0x01 - running
+ */
+uint8_t TIMER0_IsTickRunning(void)
+{
+	return (REG_READ(TCCR0B) & 0x07) ? 0x01 : 0x00;
+}
+
+/*
+ * @name	TIMER1_StartFreeRunning
+ * @brief	This function starts Timer1 in normal mode with no prescalar
+ * @param	-
+ * @retval	-
+ * @note	Output compare pins are disconnected. If Timer1 is already running it is left as it is!
+ */
+void TIMER1_StartFreeRunning(void)
+{
+	if(TIMER1_IsRunning())
+		return;
+
+	REG_WRITE(TCCR1A, 0x00);					// Normal port operation, WGM11:10 = 0
+	REG_WRITE(TCCR1B, TIMER1_NO_PRESCALAR);		// WGM13:12 = 0 -> Normal mode, clk/1
+}
+
+/*
+ * @name	TIMER1_IsRunning
+ * @brief	This function checks whether a clock source has been selected for Timer1
+ * @param	-
+ * @retval	0x00 - Timer1 is stopped
+ *			0x01 - Timer1 is running
+ */
+uint8_t TIMER1_IsRunning(void)
+{
+	return (REG_READ(TCCR1B) & TIMER1_CLOCK_SELECT_MASK) ? 0x01 : 0x00;
+}
+
+/*
+ * @name	TIMER1_StartStopwatch
+ * @brief	This function starts measuring a time longer than the 16 bit counter
+ * @param	stopwatch - state of the measurement
+ * @retval	-
+ * @note	Timer1 is started if it is not running yet
+ */
+void TIMER1_StartStopwatch(TIMER1_StopwatchType *stopwatch)
+{
+	TIMER1_StartFreeRunning();
+	stopwatch->Last = TIMER1_GetCount();
+	stopwatch->Elapsed = 0;
+}
+
+/*
+ * @name	TIMER1_ReadStopwatch
+ * @brief	This function returns the cycles since TIMER1_StartStopwatch()
+ * @param	stopwatch - state of the measurement
+ * @retval	elapsed cycles
+ * @note	Has to be called at least every 65536 cycles, the counter wraps around
+ */
+uint32_t TIMER1_ReadStopwatch(TIMER1_StopwatchType *stopwatch)
+{
+	uint16_t now = TIMER1_GetCount();
+
+	stopwatch->Elapsed += (uint16_t)(now - stopwatch->Last);
+	stopwatch->Last = now;
+	return stopwatch->Elapsed;
+}
+
+/*
+ * @name	TIMER2_StartFreeRunning
+ * @brief	This function starts Timer2 in normal mode with clk/128 (8us per tick at 16MHz)
+ * @param	-
+ * @retval	-
+ * @note	Output compare pins are disconnected and the compare interrupts are left as they are.
+ *			If Timer2 is already running it is left as it is!
+ */
+void TIMER2_StartFreeRunning(void)
+{
+	if(TIMER2_IsRunning())
+		return;
+
+	REG_WRITE(ASSR, 0x00);						// Clocked from the I/O clock, not from TOSC1
+	REG_WRITE(TCCR2A, 0x00);					// Normal port operation, WGM21:20 = 0
+	REG_WRITE(TCCR2B, TIMER2_PRESCALAR_128);	// WGM22 = 0 -> Normal mode, clk/128
+}
+
+/*
+ * @name	TIMER2_IsRunning
+ * @brief	This function checks whether a clock source has been selected for Timer2
+ * @param	-
+ * @retval	0x00 - Timer2 is stopped
+ *			0x01 - Timer2 is running
+ */
+uint8_t TIMER2_IsRunning(void)
+{
+	return (REG_READ(TCCR2B) & TIMER2_CLOCK_SELECT_MASK) ? 0x01 : 0x00;
+}
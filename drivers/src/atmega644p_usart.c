@@ -8,33 +8,102 @@
   * @Note	 For Baud rate 0.5 is added so that to get the proper value for UBBR register and the value falls within the error boundry
   * 		 UBBRn = ((Freq / (16 * BaudRate)) + 0.5) - 1	// This is for asynchromous mode!
   * 		       => ((Freq / 16 + baud / 2) / baud - 1)  => So that overflow and underflow has been taken care in code
-  * 		 The Receive IRQ handler will fill the receive buffer gReceived_Data[] untill it is fully filled or enter is pressed.
+  * 		 In ASYNCHRONOUS mode UBRRn is calculated for both dividers 16 and 8 (U2Xn) and the one with the lower error is used,
+  * 		 e.g. 115200 at 16MHz: divider 16 -> 111111 (-3.5%), divider 8 -> 117647 (+2.1%). Normal speed wins a tie, because
+  * 		 the receiver takes more samples per bit.
+  * 		 The Receive IRQ handler puts the received data into the receive buffer, a FIFO of fifo.h shared by both USARTs
+  * 		 (their ISRs do not nest). gReceive_Buffer_Full tells that a carriage return has arrived or the buffer is full.
   ******************************************************************************
   *
   *					HOW TO USE
   * 1. Call the initialization function USARTInit() with the USART which is used.
   * 2. If it is interrupt based make sure that USART_EnableInterrupt() is called
   * 3. Call the function USART_PutChar() and/or USART_GetChar() to send or receive data
-  * 4. If the Receive buffer is filled (gReceive_Buffer_Full == 1) either empty the buffer or flush the buffer by called the function
-  * 	USART_ClearReceiveBuffer() or USART_FlushReceiveBuffer()
+  * 4. Read the receive buffer with USART_ReadReceiveBuffer(), e.g. once gReceive_Buffer_Full is set (line complete).
+  * 	USART_ClearReceiveBuffer() echoes and empties it, USART_FlushReceiveBuffer() drops it.
+  * 5. Instead of the receive buffer, a hook can be registered per USART with USART_RegisterReceiveHook(). The hook is called
+  *    from the receive ISR with every received data, e.g. to post a task to the scheduler.
+  * 6. The receive ISR checks FEn, DORn and UPEn of every data: the flags are stored with the data (USART_RX_ERRORS bits of
+  *    the buffer/hook word) and counted per USART. USART_GetStatistics() returns a snapshot of the counters.
+  * 7. To use the USART as SPI master, see atmega644p_usart_spi.c
+  * 8. Multi-processor mode (9 data bits, USART_DataBits = NINE): USART_EnableAddressFilter() gives the node its address.
+  *    The receiver ignores the data frames (MPCMn) until an address frame with this address or USART_BROADCAST_ADDRESS
+  *    arrives, so the receive interrupt is raised only once per packet for the other nodes. The address frame and the data
+  *    frames of the packet are given to the hook/buffer, the address frame with USART_ADDRESS_FRAME set.
+  *    USART_SendAddressed() sends an address frame followed by the data frames.
+  * 9. Interrupt driven transmit: USART_StartTransmit() sends a buffer from the UDRE ISR and calls the complete hook from
+  *    the TXC ISR, i.e. when the last stop bit has left. The buffer must stay valid until then.
+  *    USART_StartTransmitSource() takes the bytes from a function called in the UDRE ISR instead (encoding on the fly).
+  * 10. RS-485 half duplex: USART_EnableRS485() with the GPIO of the driver enable (DE) pin of the transceiver.
+  *    USART_StartTransmit() sets DE before the first byte and disables the receiver (no local echo), the TXC ISR
+  *    clears DE and enables the receiver again, so the bus is released within the ISR latency after the stop bit.
+  * 11. Binary protocols without a delimiter (e.g. Modbus RTU): see atmega644p_usart_idle.c, a frame ends after an idle line.
+  * 12. USART_GetChar() sleeps in Idle mode between the checks of RXCn, when the global interrupt is enabled (see power.c).
   ******************************************************************************
   */
 
 /*----------------------------------- Includes -------------------------------*/
 #include "atmega644p_usart.h"
+#include "profile.h"
+#include "power.h"
+#include "fifo.h"
 
-volatile static uint8_t *RegA;
-volatile static uint8_t *RegB;
-volatile static uint8_t *RegC;
-volatile static uint8_t *BRRH;
-volatile static uint8_t *BRRL;
-volatile static uint8_t *DataR;
-volatile static uint8_t *DataT;
-//volatile static uint8_t *Data;
+static volatile uint8_t *RegA;
+static volatile uint8_t *RegB;
+static volatile uint8_t *RegC;
+static volatile uint8_t *BRRH;
+static volatile uint8_t *BRRL;
+static volatile uint8_t *DataR;
+static volatile uint8_t *DataT;
+//static volatile uint8_t *Data;
+
+/*---------------------------------- Typedefs ----------------------------------*/
+typedef struct
+{
+	volatile uint8_t	*RegA;
+	volatile uint8_t	*RegB;
+	volatile uint8_t	*Data;
+}USART_PortRegistersType;
+
+typedef struct
+{
+	const uint8_t					*Buffer;
+	USART_TransmitSourceType		Source;			// used instead of Buffer when not NULL
+	uint16_t						Length;
+	uint16_t						Index;
+	USART_TransmitCompleteHookType	Complete;
+	uint8_t							Busy;
+	uint8_t							Receiver;		// RXENn has to be set again after the transmission
+	uint8_t							RS485;			// DE pin is driven
+	ports							DEPort;
+	pins							DEPin;
+}USART_TransmitType;
+
+FIFO_DEFINE(USART_Receive, uint16_t, USART_RECEIVE_BUFFER_SIZE)
 
 /*---------------------------------- Global Variables ----------------------------------*/
-static uint16_t gReceived_Data[128];
-static uint8_t gIndex = 0;
+volatile uint8_t gReceive_Buffer_Full;
+static USART_Receive_FifoType gUSART_Received;		// produced by the receive ISRs, consumed by the application
+
+//Registers used by the ISRs, which always serve their own USART
+static const USART_PortRegistersType gUSART_Ports[2] =
+{
+	{ &(UCSR0A), &(UCSR0B), &(UDR0) },
+	{ &(UCSR1A), &(UCSR1B), &(UDR1) },
+};
+static USART_ReceiveHookType gUSART_ReceiveHook[2] = { NULL, NULL };
+static volatile uint8_t gUSART_GetCharWaiting[2] = { 0, 0 };		// USART_GetChar() sleeps, the data is left in UDRn
+static volatile USART_TransmitType gUSART_Transmit[2];
+static USART_StatisticsType gUSART_Statistics[2];
+static USART_BaudType gUSART_Baud[2];
+
+//Standard baud rates, highest first, checked by USART_GetReliableBaudRates()
+static const uint32_t gUSART_StandardBaudRates[] =
+{
+	1000000, 500000, 250000, 230400, 115200, 76800, 57600, 38400, 28800, 19200, 14400, 9600, 4800, 2400
+};
+static uint8_t gUSART_NodeAddress[2];
+static uint8_t gUSART_AddressFilter[2] = { 0, 0 };		// multi-processor mode enabled
 
 /*---------------------------------- Function and Hooks ----------------------------------*/
 
@@ -102,52 +171,199 @@ void USARTRegInit(uint8_t __USARTType__, USART_StructureType USARTConfig)
     }
 }
 
+/*
+ * @name   	USART_BaudForDivider(uint32_t, uint8_t, USART_BaudType *)
+ * @brief	This function is to calculate UBRRn, the achieved baud rate and the error for one clock divider
+ * @param  	BaudRate - requested baud rate
+ * 			shift    - divider is 1 << shift (16, 8 or 2)
+ * 			result   - UBRRn, BaudRate and Error are updated
+ * @retval	None
+ */
+static void USART_BaudForDivider(uint32_t BaudRate, uint8_t shift, USART_BaudType *result)
+{
+	uint32_t ubrr = (((F_CPU >> shift) + (BaudRate / 2)) / BaudRate);
+	int32_t error;
+
+	if(ubrr == 0)
+		ubrr = 1;
+	if(ubrr > 4096)
+		ubrr = 4096;		// UBRRn is 12 bits
+
+	result->UBRR = ubrr - 1;
+	result->BaudRate = ((F_CPU >> shift) + (ubrr / 2)) / ubrr;
+
+	error = ((int32_t)result->BaudRate - (int32_t)BaudRate) * 10000L / (int32_t)BaudRate;
+	if(error > INT16_MAX)
+		error = INT16_MAX;
+	result->Error = error;
+}
+
+/*
+ * @name   	USART_CalculateBaud(uint32_t, USARTModesType, USART_BaudType *)
+ * @brief	This function is to select UBRRn and U2Xn for a baud rate, without touching the USART
+ * @param  	BaudRate - requested baud rate
+ * 			mode     - ASYNCHRONOUS (U2Xn selected for the lowest error), DOUBLESPEEDASYNC or SYNCRONOUS
+ * 			result   - UBRRn, U2Xn, achieved baud rate and error
+ * @retval	0x00 - the error is within the receiver tolerance
+ * 			0x01 - the error is too big for a reliable communication (the result is the closest possible)
+ * 			0x02 - wrong baud rate
+ */
+uint8_t USART_CalculateBaud(uint32_t BaudRate, USARTModesType mode, USART_BaudType *result)
+{
+	USART_BaudType doubleSpeed;
+	int16_t limit = USART_MAX_BAUD_ERROR;
+
+	if(BaudRate == 0)
+		return 0x02;
+
+	USART_BaudForDivider(BaudRate, mode, result);
+	result->DoubleSpeed = (mode == DOUBLESPEEDASYNC);
+
+	if(mode == ASYNCHRONOUS)
+	{
+		USART_BaudForDivider(BaudRate, DOUBLESPEEDASYNC, &doubleSpeed);
+		if(abs(doubleSpeed.Error) < abs(result->Error))
+		{
+			*result = doubleSpeed;
+			result->DoubleSpeed = 1;
+		}
+	}
+
+	if(result->DoubleSpeed)
+		limit = USART_MAX_BAUD_ERROR_U2X;
+
+	return (abs(result->Error) <= limit) ? 0x00 : 0x01;
+}
+
+/*
+ * @name   	USART_GetBaud(uint8_t, USART_BaudType *)
+ * @brief	This function is to get the baud rate settings selected by the last USARTInit()
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			baud          - UBRRn, U2Xn, achieved baud rate and error
+ * @retval	None
+ */
+void USART_GetBaud(uint8_t __USARTType__, USART_BaudType *baud)
+{
+	*baud = gUSART_Baud[__USARTType__ & 0x01];
+}
+
+/*
+ * @name   	USART_GetReliableBaudRates(uint32_t *, uint8_t)
+ * @brief	This function is to list the standard baud rates which are within the receiver tolerance at F_CPU
+ * @param  	rates - filled with the baud rates, highest first
+ * 			size  - number of entries of rates
+ * @retval	Number of baud rates copied to rates
+ */
+uint8_t USART_GetReliableBaudRates(uint32_t *rates, uint8_t size)
+{
+	USART_BaudType baud;
+	uint8_t count = 0;
+	uint8_t i;
+
+	for(i = 0; (i < sizeof(gUSART_StandardBaudRates) / sizeof(gUSART_StandardBaudRates[0])) && (count < size); i++)
+	{
+		if(USART_CalculateBaud(gUSART_StandardBaudRates[i], ASYNCHRONOUS, &baud) == 0x00)
+			rates[count++] = gUSART_StandardBaudRates[i];
+	}
+	return count;
+}
+
+/*
+ * @name   	USART_GetMaxBaudRate()
+ * @brief	This function is to get the highest standard baud rate which is within the receiver tolerance at F_CPU
+ * @param  	None
+ * @retval	baud rate, 0 if none
+ */
+uint32_t USART_GetMaxBaudRate(void)
+{
+	uint32_t rate = 0;
+
+	USART_GetReliableBaudRates(&rate, 1);
+	return rate;
+}
+
+/*
+ * @name   	USART_NearestStandardBaudRate(uint32_t, int16_t)
+ * @brief	This function is to round a measured baud rate to a standard one
+ * @param  	BaudRate  - measured baud rate
+ * 			tolerance - maximum difference in 0.01%
+ * @retval	closest standard baud rate, BaudRate if none is within the tolerance
+ */
+uint32_t USART_NearestStandardBaudRate(uint32_t BaudRate, int16_t tolerance)
+{
+	uint32_t best = BaudRate;
+	uint32_t bestDifference = ((uint32_t)tolerance * BaudRate) / 10000UL;
+	uint32_t difference;
+	uint8_t i;
+
+	for(i = 0; i < sizeof(gUSART_StandardBaudRates) / sizeof(gUSART_StandardBaudRates[0]); i++)
+	{
+		difference = (gUSART_StandardBaudRates[i] > BaudRate) ? (gUSART_StandardBaudRates[i] - BaudRate) : (BaudRate - gUSART_StandardBaudRates[i]);
+		if(difference <= bestDifference)
+		{
+			best = gUSART_StandardBaudRates[i];
+			bestDifference = difference;
+		}
+	}
+	return best;
+}
+
 /*
  * @name   	USARTInit(uint8_t, USART_StructureType)
  * @brief	This function is to configure USARTx based on the given inputs
  * @param  	__USARTType__ - can have the values USART0 or USART1
  * 			USARTConfig   - Structure to configure the USARTx
  * @note	For Parity check Parity check related function should be called
- * @retval	None
+ * 			In ASYNCHRONOUS mode U2Xn is selected for the lowest baud rate error, see USART_CalculateBaud().
+ * 			The error is available with USART_GetBaud().
+ * @retval	Achieved baud rate, 0 if the baud rate cannot be set (e.g. 0), the USART is left as it is then
  */
-void USARTInit(uint8_t __USARTType__, USART_StructureType USARTConfig)
+uint32_t USARTInit(uint8_t __USARTType__, USART_StructureType USARTConfig)
 {
-	uint16_t BaudRateRegValue; // The register vlaue to be given in UBRRx register!
+	USART_BaudType *baud = &gUSART_Baud[__USARTType__ & 0x01];
+	USART_BaudType calculated;
+
+	//BaudRateRegValue = (((F_CPU / BaudRateDivider + USARTConfig.USART_BaudRate / 2) / USARTConfig.USART_BaudRate) - 1);
+	if(USART_CalculateBaud(USARTConfig.USART_BaudRate, USARTConfig.USART_Modes, &calculated) == 0x02)
+		return 0;		// wrong baud rate, nothing has been touched
+	*baud = calculated;
 
     gReceive_Buffer_Full = 0;
     USARTRegInit(__USARTType__, USARTConfig);
 
 	//Initialize the USART Control and Status Registers to 0
-	*RegA = 0x00;
-	*RegB = 0x00;
-	*RegC = 0x00;
-
-	//gReceived_Data[127] = '\0';		//Null character at the end of the string!
+	REG_WRITE(*RegA, 0x00);
+	REG_WRITE(*RegB, 0x00);
+	REG_WRITE(*RegC, 0x00);
 
 	//Now with the given value of the structure USART_StructureType configure the USART
-	//BaudRateRegValue = (((F_CPU / BaudRateDivider + USARTConfig.USART_BaudRate / 2) / USARTConfig.USART_BaudRate) - 1);
-	BaudRateRegValue = ((((F_CPU / (1 << USARTConfig.USART_Modes)) + (USARTConfig.USART_BaudRate / 2)) / USARTConfig.USART_BaudRate) - 1);
-	*BRRH = (BaudRateRegValue >> 8) & 0xFF;
-	*BRRL = BaudRateRegValue & 0xFF;
+	REG_WRITE(*BRRH, (baud->UBRR >> 8) & 0xFF);
+	REG_WRITE(*BRRL, baud->UBRR & 0xFF);
+	if(baud->DoubleSpeed)
+	{
+		REG_WRITE(*RegA, DOUBLE_SPEED_BIT);
+	}
 
 	/*Needs to be changed in SPI driver for Master SPI mode*/
 	if(USARTConfig.USART_Modes != DOUBLESPEEDASYNC)
 	{
-		*RegC = *RegC | (USARTConfig.USART_Modes << 6);   // To select the USART mode in UCSRxC register!
+		REG_SET(*RegC, (USARTConfig.USART_Modes << 6));   // To select the USART mode in UCSRxC register!
 	}
 
 	// Based on the type of USART communication enable the Tx or RX or Both bits!
-	*RegB = *RegB | USARTConfig.USART_Communication;
+	REG_SET(*RegB, USARTConfig.USART_Communication);
 
 	// Based on the number of Databits enable the corresponding Control and status register in Reg C and/Or Reg B bit 0
-	*RegC = *RegC | ((USARTConfig.USART_DataBits & 0x0F) << 1);
-	*RegB = *RegB | ((USARTConfig.USART_DataBits & 0xF0) >> 4);
+	REG_SET(*RegC, ((USARTConfig.USART_DataBits & 0x0F) << 1));
+	REG_SET(*RegB, ((USARTConfig.USART_DataBits & 0xF0) >> 4));
 
 	// Configuring the stop bits!
-	*RegC = *RegC | USARTConfig.USART_StopBits;
+	REG_SET(*RegC, USARTConfig.USART_StopBits);
 
 	// Configure the Parity Bits!
-	*RegC = *RegC | USARTConfig.USART_Parity;
+	REG_SET(*RegC, USARTConfig.USART_Parity);
+
+	return baud->BaudRate;
 }
 
 /*
@@ -158,28 +374,135 @@ void USARTInit(uint8_t __USARTType__, USART_StructureType USARTConfig)
  */
 void USART_PutChar(uint16_t data)
 {
-	while(!(*RegA & DATA_REGISTER_EMPTY_FLAG))
+	while(!(REG_READ(*RegA) & DATA_REGISTER_EMPTY_FLAG))
 		; //As the Tansmit buffer is not empty wait until the Transmit buffer is empty then copy the data to data register to transmit!
 
-	//If there are 9 bits to transmit
+	//If there are 9 bits to transmit, TXB8 has to be written before the data register
 	if(data & 0x0100)
-		*RegB = *RegB | 0x01;
-	*DataT = data & 0xFF;
+		REG_SET(*RegB, TRANSMIT_DATA_BIT8);
+	else
+		REG_CLEAR(*RegB, TRANSMIT_DATA_BIT8);
+	REG_WRITE(*DataT, data & 0xFF);
 }
 
 /*
- * @name   	USARTInit()
- * @brief	This function is to transmit the charater
+ * @name   	USART_GetChar()
+ * @brief	This function is to receive a charater on the USART initialised last
  * @param  	None
- * @retval	uint16_t
+ * @note	RXCn of this USART is polled. With the global interrupt enabled the CPU sleeps (SLEEP_MODE_IDLE) in between:
+ * 			the receive interrupt is enabled only to wake the CPU up, the ISR leaves the data in UDRn for this function
+ * 			(gUSART_GetCharWaiting), so the receive buffer and the hook of the application never see it.
+ * @retval	uint16_t - received data, 9th bit in bit 8
  */
 uint16_t USART_GetChar()
 {
-	while(!(*RegA & RECEIVE_COMPLETE_FLAG))
+	uint8_t port = (RegA == &(UCSR1A)) ? USART1 : USART0;
+	uint8_t previous;
+	uint16_t ch;
+
+	if(SREG & 0x80)
+	{
+		cli();
+		gUSART_GetCharWaiting[port] = 1;
+		previous = USART_SetReceiveInterrupt(port, 1);
+		while(!(REG_READ(*RegA) & RECEIVE_COMPLETE_FLAG))
+		{
+			Power_Sleep(SLEEP_MODE_IDLE);
+			cli();
+		}
+		gUSART_GetCharWaiting[port] = 0;
+		ch = ((REG_READ(*RegB) & 0x02) << 7) | (REG_READ(*DataR) & 0xFF);
+		USART_SetReceiveInterrupt(port, previous);	// after UDRn has been read, the ISR must not take the data
+		sei();
+		return ch;
+	}
+
+	while(!(REG_READ(*RegA) & RECEIVE_COMPLETE_FLAG))
 		; //As the Receive buffer is empty wait until the receive buffer is filled then return the data from data register!
 
 	//Make sure that 9th bit is also copied while returning the received data!
-	return (((*RegB & 0x02) << 7) | (*DataR & 0xFF));
+	return (((REG_READ(*RegB) & 0x02) << 7) | (REG_READ(*DataR) & 0xFF));
+}
+
+/*
+ * @name   	USART_WriteChar(uint8_t, uint16_t)
+ * @brief	This function is to transmit a charater on the given USART (polling)
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			data          - The data to be transmitted! (9th bit in bit 8)
+ * @note	TXCn is cleared before UDRn is written, so USART_WaitTransmitComplete() waits for this data
+ * @retval	None
+ */
+void USART_WriteChar(uint8_t __USARTType__, uint16_t data)
+{
+	const USART_PortRegistersType *usart = &gUSART_Ports[__USARTType__ & 0x01];
+
+	while(!(REG_READ(*usart->RegA) & DATA_REGISTER_EMPTY_FLAG))
+		;
+
+	if(data & 0x0100)
+		REG_SET(*usart->RegB, TRANSMIT_DATA_BIT8);
+	else
+		REG_CLEAR(*usart->RegB, TRANSMIT_DATA_BIT8);
+	REG_WRITE(*usart->RegA, (REG_READ(*usart->RegA) & (DOUBLE_SPEED_BIT | MULTI_PROCESSOR_MODE_BIT)) | TRANSMIT_COMPLETE_FLAG);
+	REG_WRITE(*usart->Data, data & 0xFF);
+}
+
+/*
+ * @name   	USART_WaitTransmitComplete(uint8_t)
+ * @brief	This function is to wait until the last data of USART_WriteChar() has been sent, stop bit included
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * @note	Has to be called before the baud rate is changed
+ * @retval	None
+ */
+void USART_WaitTransmitComplete(uint8_t __USARTType__)
+{
+	const USART_PortRegistersType *usart = &gUSART_Ports[__USARTType__ & 0x01];
+
+	while(!(REG_READ(*usart->RegA) & TRANSMIT_COMPLETE_FLAG))
+		;
+}
+
+/*
+ * @name   	USART_ReadChar(uint8_t, uint16_t *)
+ * @brief	This function is to read a received charater of the given USART without waiting (polling)
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			data          - received data (9th bit in bit 8, USART_RX_ERRORS)
+ * @note	The receive interrupt has to be disabled, see USART_SetReceiveInterrupt()
+ * @retval	0x00 - data has been read, 0x01 - nothing received
+ */
+uint8_t USART_ReadChar(uint8_t __USARTType__, uint16_t *data)
+{
+	const USART_PortRegistersType *usart = &gUSART_Ports[__USARTType__ & 0x01];
+	uint8_t status = REG_READ(*usart->RegA);
+
+	if(!(status & RECEIVE_COMPLETE_FLAG))
+		return 0x01;
+
+	*data = (REG_READ(*usart->RegB) & RECEIVE_DATA_BIT8) << 7;
+	*data |= REG_READ(*usart->Data) & 0xFF;
+	*data |= (status & FRAME_ERROR_FLAG) ? USART_RX_FRAME_ERROR : 0x0000;
+	*data |= (status & DATA_OVERRUN_FLAG) ? USART_RX_OVERRUN : 0x0000;
+	*data |= (status & PARITY_ERROR_FLAG) ? USART_RX_PARITY_ERROR : 0x0000;
+	return 0x00;
+}
+
+/*
+ * @name   	USART_SetReceiveInterrupt(uint8_t, uint8_t)
+ * @brief	This function is to enable or disable the receive interrupt of the given USART
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			enable        - 1 to enable, 0 to disable
+ * @retval	previous state, to restore it
+ */
+uint8_t USART_SetReceiveInterrupt(uint8_t __USARTType__, uint8_t enable)
+{
+	const USART_PortRegistersType *usart = &gUSART_Ports[__USARTType__ & 0x01];
+	uint8_t previous = (REG_READ(*usart->RegB) & RECEIVE_INTERRUPT_ENABLE) ? 1 : 0;
+
+	if(enable)
+		REG_SET(*usart->RegB, RECEIVE_INTERRUPT_ENABLE);
+	else
+		REG_CLEAR(*usart->RegB, RECEIVE_INTERRUPT_ENABLE);
+	return previous;
 }
 
 /*
@@ -192,82 +515,519 @@ void USART_EnableInterrupt(USARTCommunicationType irq_enable)
 {
 	SREG = SREG | GLOBAL_INTERRUPT_FLAG;		//Enable the Global interrupt first
 
-	*RegB = *RegB | (irq_enable << 3);
+	REG_SET(*RegB, (irq_enable << 3));
 }
 
 /*
- * @name   	USART0RX_IRQHandler()
- * @brief	This function is a interrupt service routine to handle the USART0 interrupt
- * @param  	NONE
- * @note	In this function the received data will be copied to a buffer gReceived_Data. After 127 data being received the buffer will
- * 			start filling again only after buffer is emptied!
- * 			If the Enter Key is pressed, the gReceive_Buffer_Full flag will be set, Buffer needs to be emptied for new data to be received.
+ * @name   	USART_RegisterReceiveHook(uint8_t, USART_ReceiveHookType)
+ * @brief	This function is to register the function called with every data received by the USART
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			hook          - function called from the receive ISR, NULL to go back to the receive buffer
+ * @note	The hook is executed in interrupt context, it has to be short! (store the data and post a task)
  * @retval	NONE
  */
-USART0RX_IRQHandler()
+void USART_RegisterReceiveHook(uint8_t __USARTType__, USART_ReceiveHookType hook)
 {
-	uint16_t ch;
-	ch = USART_GetChar();
+	uint8_t sreg = SREG;
+
+	cli();
+	gUSART_ReceiveHook[__USARTType__ & 0x01] = hook;
+	SREG = sreg;
+}
+
+/*
+ * @name   	USART_GetStatistics(uint8_t, USART_StatisticsType *)
+ * @brief	This function is to take a snapshot of the receive counters
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			statistics    - where the counters are copied
+ * @note	The counters are copied with the interrupts disabled, so they belong together
+ * @retval	NONE
+ */
+void USART_GetStatistics(uint8_t __USARTType__, USART_StatisticsType *statistics)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	*statistics = gUSART_Statistics[__USARTType__ & 0x01];
+	SREG = sreg;
+}
+
+/*
+ * @name   	USART_ResetStatistics(uint8_t)
+ * @brief	This function is to set the receive counters to 0
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * @retval	NONE
+ */
+void USART_ResetStatistics(uint8_t __USARTType__)
+{
+	volatile USART_StatisticsType *statistics = &gUSART_Statistics[__USARTType__ & 0x01];
+	uint8_t sreg = SREG;
+
+	cli();
+	statistics->Received = 0;
+	statistics->FrameErrors = 0;
+	statistics->Overruns = 0;
+	statistics->ParityErrors = 0;
+	statistics->BufferOverflows = 0;
+	SREG = sreg;
+}
+
+/*
+ * @name   	USART_SetMultiProcessorMode(uint8_t, uint8_t)
+ * @brief	This function is to set or clear MPCMn without touching the other bits of UCSRnA
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			enable        - 1 to ignore the data frames, 0 to receive all the frames
+ * @note	TXCn is cleared by writing one to it, so only U2Xn is written back
+ * @retval	NONE
+ */
+static inline void USART_SetMultiProcessorMode(uint8_t __USARTType__, uint8_t enable)
+{
+	const USART_PortRegistersType *usart = &gUSART_Ports[__USARTType__];
+
+	REG_WRITE(*usart->RegA, (REG_READ(*usart->RegA) & DOUBLE_SPEED_BIT) | (enable ? MULTI_PROCESSOR_MODE_BIT : 0x00));
+}
+
+/*
+ * @name   	USART_EnableAddressFilter(uint8_t, uint8_t)
+ * @brief	This function is to enable the multi-processor mode with the address of this node
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			address       - address of this node, anything but USART_BROADCAST_ADDRESS
+ * @note	USART has to be configured with NINE data bits and the receive interrupt enabled
+ * @retval	NONE
+ */
+void USART_EnableAddressFilter(uint8_t __USARTType__, uint8_t address)
+{
+	uint8_t sreg = SREG;
+
+	__USARTType__ &= 0x01;
+	cli();
+	gUSART_NodeAddress[__USARTType__] = address;
+	gUSART_AddressFilter[__USARTType__] = 1;
+	USART_SetMultiProcessorMode(__USARTType__, 1);		// wait for the next address frame
+	SREG = sreg;
+}
+
+/*
+ * @name   	USART_DisableAddressFilter(uint8_t)
+ * @brief	This function is to go back to receiving all the frames
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * @retval	NONE
+ */
+void USART_DisableAddressFilter(uint8_t __USARTType__)
+{
+	uint8_t sreg = SREG;
+
+	__USARTType__ &= 0x01;
+	cli();
+	gUSART_AddressFilter[__USARTType__] = 0;
+	USART_SetMultiProcessorMode(__USARTType__, 0);
+	SREG = sreg;
+}
+
+/*
+ * @name   	USART_SendAddressed(uint8_t, uint8_t, const uint8_t *, uint16_t)
+ * @brief	This function is to send a packet to one node (or all with USART_BROADCAST_ADDRESS) in the multi-processor mode
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			address       - address of the node
+ * 			data          - data frames of the packet
+ * 			length        - number of data frames
+ * @note	The function returns when the last data is in the transmit buffer
+ * @retval	NONE
+ */
+void USART_SendAddressed(uint8_t __USARTType__, uint8_t address, const uint8_t *data, uint16_t length)
+{
+	const USART_PortRegistersType *usart = &gUSART_Ports[__USARTType__ & 0x01];
+	uint16_t i;
+
+	while(!(REG_READ(*usart->RegA) & DATA_REGISTER_EMPTY_FLAG))
+		;
+	REG_SET(*usart->RegB, TRANSMIT_DATA_BIT8);
+	REG_WRITE(*usart->Data, address);
 
-	if((gIndex < 127) && (ch != 0x0D) && (gReceive_Buffer_Full != 1))
+	for(i = 0; i < length; i++)
 	{
-		gReceived_Data[gIndex] = ch;
-		gIndex++;
+		while(!(REG_READ(*usart->RegA) & DATA_REGISTER_EMPTY_FLAG))
+			;
+		if(i == 0)
+			REG_CLEAR(*usart->RegB, TRANSMIT_DATA_BIT8);
+		REG_WRITE(*usart->Data, data[i]);
+	}
+	REG_CLEAR(*usart->RegB, TRANSMIT_DATA_BIT8);
+}
+
+/*
+ * @name   	USART_Transmit(uint8_t, const uint8_t *, uint16_t, USART_TransmitSourceType, USART_TransmitCompleteHookType)
+ * @brief	This function is the common part of USART_StartTransmit() and USART_StartTransmitSource()
+ * @retval	0x00 - transmission started, 0x01 - previous transmission is still running
+ */
+static uint8_t USART_Transmit(uint8_t __USARTType__, const uint8_t *data, uint16_t length, USART_TransmitSourceType source,
+							  USART_TransmitCompleteHookType complete)
+{
+	const USART_PortRegistersType *usart;
+	volatile USART_TransmitType *transmit;
+	uint8_t sreg = SREG;
+
+	__USARTType__ &= 0x01;
+	usart = &gUSART_Ports[__USARTType__];
+	transmit = &gUSART_Transmit[__USARTType__];
+
+	cli();
+	if(transmit->Busy)
+	{
+		SREG = sreg;
+		return 0x01;
+	}
+	transmit->Buffer = data;
+	transmit->Source = source;
+	transmit->Length = length;
+	transmit->Index = 0;
+	transmit->Complete = complete;
+	transmit->Busy = 1;
+
+	if(transmit->RS485)
+	{
+		transmit->Receiver = REG_READ(*usart->RegB) & RECEIVER_ENABLE;
+		REG_CLEAR(*usart->RegB, RECEIVER_ENABLE);			// mask the local echo
+		GPIO_Write(transmit->DEPort, transmit->DEPin, GPIO_PIN_SET);
+	}
+
+	REG_CLEAR(*usart->RegB, TRANSMIT_DATA_BIT8);
+	REG_SET(*usart->RegB, DATA_EMPTY_INTERRUPT_ENABLE);
+	SREG = sreg;
+	return 0x00;
+}
+
+/*
+ * @name   	USART_StartTransmit(uint8_t, const uint8_t *, uint16_t, USART_TransmitCompleteHookType)
+ * @brief	This function is to start the interrupt driven transmission of a buffer
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			data          - data to be sent, has to stay valid until the complete hook is called
+ * 			length        - number of bytes
+ * 			complete      - called from the TXC ISR after the last stop bit, can be NULL
+ * @note	Global interrupts have to be enabled. In RS-485 mode DE is set here, before the first byte.
+ * @retval	0x00 - transmission started
+ * 			0x01 - previous transmission is still running
+ * 			0x02 - nothing to send
+ */
+uint8_t USART_StartTransmit(uint8_t __USARTType__, const uint8_t *data, uint16_t length, USART_TransmitCompleteHookType complete)
+{
+	if((data == NULL) || (length == 0))
+		return 0x02;
+
+	return USART_Transmit(__USARTType__, data, length, NULL, complete);
+}
+
+/*
+ * @name   	USART_StartTransmitSource(uint8_t, USART_TransmitSourceType, USART_TransmitCompleteHookType)
+ * @brief	This function is to start the interrupt driven transmission of bytes produced one by one
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			source        - called from the UDRE ISR for every byte, returns 1 with the last byte
+ * 			complete      - called from the TXC ISR after the last stop bit, can be NULL
+ * @note	source has to be short, it runs once per byte in interrupt context
+ * @retval	0x00 - transmission started
+ * 			0x01 - previous transmission is still running
+ * 			0x02 - no source
+ */
+uint8_t USART_StartTransmitSource(uint8_t __USARTType__, USART_TransmitSourceType source, USART_TransmitCompleteHookType complete)
+{
+	if(source == NULL)
+		return 0x02;
+
+	return USART_Transmit(__USARTType__, NULL, 0, source, complete);
+}
+
+/*
+ * @name   	USART_IsTransmitBusy(uint8_t)
+ * @brief	This function is to check if USART_StartTransmit() can be called
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * @retval	1 - transmission is running (until the TXC ISR), 0 - idle
+ */
+uint8_t USART_IsTransmitBusy(uint8_t __USARTType__)
+{
+	return gUSART_Transmit[__USARTType__ & 0x01].Busy;
+}
+
+/*
+ * @name   	USART_EnableRS485(uint8_t, ports, pins)
+ * @brief	This function is to enable the RS-485 half duplex mode of USART_StartTransmit()
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			GPIOx, pin    - GPIO connected to the driver enable (DE) of the transceiver, active high
+ * @note	The pin is configured as output and set low (receive).
+ * @retval	NONE
+ */
+void USART_EnableRS485(uint8_t __USARTType__, ports GPIOx, pins pin)
+{
+	volatile USART_TransmitType *transmit = &gUSART_Transmit[__USARTType__ & 0x01];
+	uint8_t sreg = SREG;
+
+	GPIO_Write(GPIOx, pin, GPIO_PIN_RESET);
+	GPIO_Config(GPIOx, pin, OUTPUT);
+
+	cli();
+	transmit->DEPort = GPIOx;
+	transmit->DEPin = pin;
+	transmit->RS485 = 1;
+	SREG = sreg;
+}
+
+/*
+ * @name   	USART_DisableRS485(uint8_t)
+ * @brief	This function is to stop driving the DE pin
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * @note	Has to be called while no transmission is running
+ * @retval	NONE
+ */
+void USART_DisableRS485(uint8_t __USARTType__)
+{
+	gUSART_Transmit[__USARTType__ & 0x01].RS485 = 0;
+}
+
+/*
+ * @name   	USART_DataEmptyIRQ(uint8_t)
+ * @brief	This function is the common part of the data register empty ISRs
+ * @param  	__USARTType__ - USART which raised the interrupt
+ * @note	TXCn is cleared after the last byte is written to UDRn: it can only be set again when that byte has been
+ * 			sent, so a gap between two bytes does not end the transmission early.
+ * @retval	NONE
+ */
+static inline void USART_DataEmptyIRQ(uint8_t __USARTType__)
+{
+	const USART_PortRegistersType *usart = &gUSART_Ports[__USARTType__];
+	volatile USART_TransmitType *transmit = &gUSART_Transmit[__USARTType__];
+
+	uint8_t data;
+	uint8_t last;
+
+	if(transmit->Source != NULL)
+	{
+		last = transmit->Source(__USARTType__, &data);
 	}
 	else
 	{
-		gReceive_Buffer_Full = 1;
+		data = transmit->Buffer[transmit->Index];
+		transmit->Index++;
+		last = (transmit->Index >= transmit->Length);
+	}
+	REG_WRITE(*usart->Data, data);
+
+	if(last)
+	{
+		REG_WRITE(*usart->RegB, (REG_READ(*usart->RegB) & (uint8_t)~DATA_EMPTY_INTERRUPT_ENABLE) | TRANSMIT_INTERRUPT_ENABLE);
+		REG_WRITE(*usart->RegA, (REG_READ(*usart->RegA) & (DOUBLE_SPEED_BIT | MULTI_PROCESSOR_MODE_BIT)) | TRANSMIT_COMPLETE_FLAG);
 	}
 }
 
 /*
- * @name   	USART1RX_IRQHandler()
- * @brief	This function is a interrupt service routine to handle the USART1 interrupt
- * @param  	NONE
- * @note	In this function the received data will be copied to a buffer gReceived_Data. After 127 data being received the buffer will
- * 			start filling again only after buffer is emptied!
- * 			If the Enter Key is pressed, the gReceive_Buffer_Full flag will be set, Buffer needs to be emptied for new data to be received.
+ * @name   	USART_TransmitCompleteIRQ(uint8_t)
+ * @brief	This function is the common part of the transmit complete ISRs
+ * @param  	__USARTType__ - USART which raised the interrupt
+ * @note	The last stop bit has left: DE is released and the receiver is enabled again before the hook is called
  * @retval	NONE
  */
-USART1RX_IRQHandler()
+static inline void USART_TransmitCompleteIRQ(uint8_t __USARTType__)
 {
+	const USART_PortRegistersType *usart = &gUSART_Ports[__USARTType__];
+	volatile USART_TransmitType *transmit = &gUSART_Transmit[__USARTType__];
+
+	REG_CLEAR(*usart->RegB, TRANSMIT_INTERRUPT_ENABLE);
+
+	if(transmit->RS485)
+	{
+		GPIO_Write(transmit->DEPort, transmit->DEPin, GPIO_PIN_RESET);
+		if(transmit->Receiver)
+			REG_SET(*usart->RegB, RECEIVER_ENABLE);
+	}
+
+	transmit->Busy = 0;
+	if(transmit->Complete != NULL)
+		transmit->Complete(__USARTType__);
+}
+
+/*
+ * @name   	USART_ReceiveIRQ(uint8_t)
+ * @brief	This function is the common part of the receive ISRs
+ * @param  	__USARTType__ - USART which raised the interrupt
+ * @note	In this function the received data will be given to the registered hook or put into the receive buffer,
+ * 			unless USART_GetChar() is waiting for it on this USART.
+ * 			FEn, DORn and UPEn belong to the data in UDRn, so they are read before it and stored in the word as USART_RX_ERRORS.
+ * 			The carriage return is stored as well and sets gReceive_Buffer_Full, the data after it keeps on being received.
+ * 			When the buffer is full the data is dropped (BufferOverflows) and gReceive_Buffer_Full is set.
+ * @retval	NONE
+ */
+static inline void USART_ReceiveIRQ(uint8_t __USARTType__)
+{
+	const USART_PortRegistersType *usart = &gUSART_Ports[__USARTType__];
+	USART_StatisticsType *statistics = &gUSART_Statistics[__USARTType__];
+	uint8_t status;
 	uint16_t ch;
-	ch = USART_GetChar();
 
-	if((gIndex < 127) && (ch != 0x0D) && (gReceive_Buffer_Full == 0))
+	if(gUSART_GetCharWaiting[__USARTType__])
 	{
-		gReceived_Data[gIndex] = ch;
-		gIndex++;
+		REG_CLEAR(*usart->RegB, RECEIVE_INTERRUPT_ENABLE);	// only the wake up of USART_GetChar(), it reads the data
+		return;
 	}
-	else
+
+	//Error flags and 9th bit have to be read before the data register
+	status = REG_READ(*usart->RegA);
+	ch = (REG_READ(*usart->RegB) & RECEIVE_DATA_BIT8) << 7;
+	ch |= REG_READ(*usart->Data) & 0xFF;
+
+	statistics->Received++;
+	if(status & (FRAME_ERROR_FLAG | DATA_OVERRUN_FLAG | PARITY_ERROR_FLAG))
 	{
+		if(status & FRAME_ERROR_FLAG)
+		{
+			ch |= USART_RX_FRAME_ERROR;
+			statistics->FrameErrors++;
+		}
+		if(status & DATA_OVERRUN_FLAG)
+		{
+			ch |= USART_RX_OVERRUN;
+			statistics->Overruns++;
+		}
+		if(status & PARITY_ERROR_FLAG)
+		{
+			ch |= USART_RX_PARITY_ERROR;
+			statistics->ParityErrors++;
+		}
+	}
+
+	//Multi-processor mode: only address frames reach here while MPCMn is set
+	if(gUSART_AddressFilter[__USARTType__] && (ch & USART_ADDRESS_FRAME))
+	{
+		if(((ch & 0xFF) != gUSART_NodeAddress[__USARTType__]) && ((ch & 0xFF) != USART_BROADCAST_ADDRESS))
+		{
+			USART_SetMultiProcessorMode(__USARTType__, 1);	// packet for another node
+			return;
+		}
+		USART_SetMultiProcessorMode(__USARTType__, 0);		// receive the data frames of this packet
+	}
+
+	if(gUSART_ReceiveHook[__USARTType__] != NULL)
+	{
+		gUSART_ReceiveHook[__USARTType__](__USARTType__, ch);
+	}
+	else if(USART_Receive_Put(&gUSART_Received, ch) != 0x00)
+	{
+		statistics->BufferOverflows++;
 		gReceive_Buffer_Full = 1;
 	}
+	else if(ch == 0x0D)
+	{
+		gReceive_Buffer_Full = 1;		// a line is complete
+	}
+}
+
+/*
+ * @name   	USART0RX_IRQHandler()
+ * @brief	This function is a interrupt service routine to handle the USART0 interrupt
+ * @param  	NONE
+ * @note	See USART_ReceiveIRQ()
+ * @retval	NONE
+ */
+USART0RX_IRQHandler()
+{
+	POWER_WAKE_STAMP();
+	PROFILE_ENTER(ePROFILE_USART0_RX);
+	USART_ReceiveIRQ(USART0);
+	PROFILE_EXIT(ePROFILE_USART0_RX);
+}
+
+/*
+ * @name   	USART1RX_IRQHandler()
+ * @brief	This function is a interrupt service routine to handle the USART1 interrupt
+ * @param  	NONE
+ * @note	See USART_ReceiveIRQ()
+ * @retval	NONE
+ */
+USART1RX_IRQHandler()
+{
+	POWER_WAKE_STAMP();
+	PROFILE_ENTER(ePROFILE_USART1_RX);
+	USART_ReceiveIRQ(USART1);
+	PROFILE_EXIT(ePROFILE_USART1_RX);
+}
+
+/*
+ * @name   	USART0UDRE_IRQHandler()
+ * @brief	This function is a interrupt service routine to send the next byte of USART_StartTransmit() on USART0
+ * @param  	NONE
+ * @note	See USART_DataEmptyIRQ()
+ * @retval	NONE
+ */
+USART0UDRE_IRQHandler()
+{
+	USART_DataEmptyIRQ(USART0);
+}
+
+/*
+ * @name   	USART1UDRE_IRQHandler()
+ * @brief	This function is a interrupt service routine to send the next byte of USART_StartTransmit() on USART1
+ * @param  	NONE
+ * @note	See USART_DataEmptyIRQ()
+ * @retval	NONE
+ */
+USART1UDRE_IRQHandler()
+{
+	USART_DataEmptyIRQ(USART1);
+}
+
+/*
+ * @name   	USART0TX_IRQHandler()
+ * @brief	This function is a interrupt service routine to end the transmission of USART0
+ * @param  	NONE
+ * @note	See USART_TransmitCompleteIRQ()
+ * @retval	NONE
+ */
+USART0TX_IRQHandler()
+{
+	USART_TransmitCompleteIRQ(USART0);
+}
+
+/*
+ * @name   	USART1TX_IRQHandler()
+ * @brief	This function is a interrupt service routine to end the transmission of USART1
+ * @param  	NONE
+ * @note	See USART_TransmitCompleteIRQ()
+ * @retval	NONE
+ */
+USART1TX_IRQHandler()
+{
+	USART_TransmitCompleteIRQ(USART1);
 }
 
 /*
  * @name   	USART_ClearReceiveBuffer()
- * @brief	This function is to empty the receive buffer so that new data can be read.
+ * @brief	This function is to empty the receive buffer, the data is echoed with USART_PutChar()
  * @param  	None
  * @note	This function has to be called by the developer once the gReceive_Buffer_Full is set!
  * @retval	NONE
  */
 void USART_ClearReceiveBuffer()
 {
+	uint16_t data;
+
 	if(gReceive_Buffer_Full != 0)
 	{
-		uint8_t i;
-
-		for(i = 0; i<gIndex; i++)
-		{
-			USART_PutChar(gReceived_Data[i]);
-		}
-
-		gReceive_Buffer_Full = 0;	//Once the buffer is emptied the flag and the index should be reset!
-		gIndex = 0;
+		gReceive_Buffer_Full = 0;
+		while(USART_Receive_Get(&gUSART_Received, &data) == 0x00)
+			USART_PutChar(data);
 	}
 }
 
+/*
+ * @name   	USART_ReadReceiveBuffer(uint16_t *)
+ * @brief	This function is to read the oldest data of the receive buffer
+ * @param  	data - received data (9th bit in bit 8, USART_RX_ERRORS)
+ * @note	Lock free: the receive ISR keeps on filling the buffer meanwhile
+ * @retval	0x00 - data has been read
+ * 			0x01 - receive buffer is empty
+ */
+uint8_t USART_ReadReceiveBuffer(uint16_t *data)
+{
+	return USART_Receive_Get(&gUSART_Received, data);
+}
+
 /*
  * @name   	USART_FlushReceiveBuffer()
  * @brief	This function is to flush the receive buffer.
@@ -277,9 +1037,6 @@ void USART_ClearReceiveBuffer()
  */
 void USART_FlushReceiveBuffer()
 {
-	gReceive_Buffer_Full = 0;		// reset the receive complete flag and the index for receive buffer!
-	gIndex = 0;
+	gReceive_Buffer_Full = 0;		// reset the receive complete flag and drop the received data!
+	USART_Receive_Flush(&gUSART_Received);
 }
-/*
- * Function to Check for the parity, and Parity bit after the data bits!
- */
@@ -0,0 +1,157 @@
+/**
+  ******************************************************************************
+  * @file    atmega644p_usart_autobaud.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file has the auto-baud detection of the USART receivers
+  * @Note	 The peer sends the sync byte 0x55 ('U'). On the line (LSB first) it is
+  *			 start 1 0 1 0 1 0 1 0 stop, so from the falling edge of the start bit to the
+  *			 rising edge of the stop bit there are 9 edges, one bit time apart.
+  *			 Input capture (ICP1) is on PD6 and not on a RXD pin, so the RXD pin is polled
+  *			 with the interrupts disabled and every edge is time stamped with the Timer1 cycle
+  *			 counter. The falling edge of the start bit is caught by the same tight loop as the
+  *			 other 9 edges, so all of them have the same polling latency and it cancels out.
+  *			 bit time = (last edge - first edge) / 9, every single bit is checked to be within
+  *			 +-25% of it, so other bytes and noise are rejected and the next falling edge is tried.
+  *			 The measured rate is rounded to a standard rate (USART_AUTOBAUD_SNAP_ERROR), then
+  *			 USARTInit() selects the best UBRR/U2X pair for it.
+  *			 A stream of 0x55 bytes is a square wave, so the measurement is right even when it
+  *			 starts in the middle of a byte.
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Fill the USART_StructureType as for USARTInit() (the baud rate is not used)
+  * 2. Call USART_AutoBaud() and let the peer send a few 0x55 bytes
+  * 3. On success the USART is configured and USART_BaudRate of the structure is the detected rate.
+  *    The first bytes after the sync bytes can have frame errors if the peer sends without a pause.
+  ******************************************************************************
+  */
+
+/*----------------------------------- Includes -------------------------------*/
+#include "atmega644p_usart.h"
+#include "atmega644p_timer.h"
+
+/*---------------------------------- Defines ----------------------------------*/
+#define AUTOBAUD_EDGES				9
+#define AUTOBAUD_MAX_BIT_CYCLES		(F_CPU / USART_AUTOBAUD_MIN_RATE)
+#define AUTOBAUD_CYCLES_PER_MS		(F_CPU / 1000UL)
+#define AUTOBAUD_WAIT_CYCLES		(F_CPU / 4000UL)	// 250us windows with the interrupts disabled for the start bit
+
+/*---------------------------------- Typedefs ----------------------------------*/
+typedef struct
+{
+	volatile uint8_t	*RegB;
+	volatile uint8_t	*Pin;		// PINx of the RXD pin
+	uint8_t				Mask;
+}USART_AutoBaudPinType;
+
+/*---------------------------------- Global Variables ----------------------------------*/
+static const USART_AutoBaudPinType gUSART_AutoBaudPins[2] =
+{
+	{ &(UCSR0B), &(PIND), 0x01 },		// RXD0 -> PD0
+	{ &(UCSR1B), &(PIND), 0x04 },		// RXD1 -> PD2
+};
+
+/*---------------------------------- Function and Hooks ----------------------------------*/
+
+/*
+ * @name   	USART_MeasureBit(const USART_AutoBaudPinType *, uint32_t *)
+ * @brief	This function is to wait for the falling edge of the start bit and time the 9 edges of the sync byte after it
+ * @param  	pin      - RXD pin of the USART
+ * 			duration - cycles spent in the function
+ * @note	Called with the interrupts disabled and the line idle (high). The start bit is waited for at most
+ * 			AUTOBAUD_WAIT_CYCLES, so the interrupts are not kept disabled for long while the line stays idle.
+ * @retval	bit time in cycles, 0 if there is no start bit or the edges are not the ones of the sync byte
+ */
+static uint16_t USART_MeasureBit(const USART_AutoBaudPinType *pin, uint32_t *duration)
+{
+	uint16_t width[AUTOBAUD_EDGES];
+	uint16_t last, now, limit;
+	uint32_t total = 0;
+	uint16_t bit;
+	uint8_t level = 1;			// idle line, the first edge is the falling edge of the start bit
+	uint8_t edge;
+
+	*duration = 0;
+	last = TIMER1_GetCount();
+	if(!(REG_READ(*pin->Pin) & pin->Mask))
+		return 0;				// not idle, the start bit has been missed
+
+	for(edge = 0; edge <= AUTOBAUD_EDGES; edge++)
+	{
+		limit = (edge == 0) ? AUTOBAUD_WAIT_CYCLES : AUTOBAUD_MAX_BIT_CYCLES;
+		do
+		{
+			now = TIMER1_GetCount();
+			if((uint16_t)(now - last) >= limit)
+			{
+				*duration += (uint16_t)(now - last);
+				return 0;			// no start bit yet, or the line stays: not the sync byte or too slow
+			}
+		} while(((REG_READ(*pin->Pin) & pin->Mask) ? 1 : 0) == level);
+
+		*duration += (uint16_t)(now - last);
+		if(edge != 0)
+		{
+			width[edge - 1] = now - last;
+			total += width[edge - 1];
+		}
+		last = now;
+		level ^= 1;
+	}
+
+	bit = (total + (AUTOBAUD_EDGES / 2)) / AUTOBAUD_EDGES;
+	for(edge = 0; edge < AUTOBAUD_EDGES; edge++)
+	{
+		if((width[edge] < bit - (bit / 4)) || (width[edge] > bit + (bit / 4)))
+			return 0;
+	}
+	return bit;
+}
+
+/*
+ * @name   	USART_AutoBaud(uint8_t, USART_StructureType *, uint16_t)
+ * @brief	This function is to detect the baud rate of the peer from the sync byte and configure the USART with it
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			USARTConfig   - configuration of the USART, USART_BaudRate is set to the detected rate
+ * 			timeout       - time to wait for the sync byte in ms
+ * @note	The receiver is disabled while measuring. The interrupts are disabled for the duration of one sync byte
+ * 			(at most 9 bit times) and, while the line is idle, in windows of AUTOBAUD_WAIT_CYCLES waiting for its start bit.
+ * @retval	0x00 - detected, the USART is configured
+ * 			0x01 - no sync byte within the timeout, the USART is left disabled
+ */
+uint8_t USART_AutoBaud(uint8_t __USARTType__, USART_StructureType *USARTConfig, uint16_t timeout)
+{
+	const USART_AutoBaudPinType *pin = &gUSART_AutoBaudPins[__USARTType__ & 0x01];
+	uint32_t limit = (uint32_t)timeout * AUTOBAUD_CYCLES_PER_MS;
+	TIMER1_StopwatchType stopwatch;
+	uint32_t elapsed, duration;
+	uint16_t bit;
+	uint8_t sreg;
+
+	REG_WRITE(*pin->RegB, 0x00);			// RXD is a plain input pin now
+	TIMER1_StartStopwatch(&stopwatch);
+
+	while(TIMER1_ReadStopwatch(&stopwatch) < limit)
+	{
+		if(!(REG_READ(*pin->Pin) & pin->Mask))
+			continue;						// wait for the idle (high) line first
+
+		elapsed = TIMER1_ReadStopwatch(&stopwatch);
+		sreg = SREG;
+		cli();
+		bit = USART_MeasureBit(pin, &duration);
+		SREG = sreg;
+		TIMER1_StartStopwatch(&stopwatch);	// the 16 bit counter may have wrapped meanwhile
+		stopwatch.Elapsed = elapsed + duration;
+
+		if(bit != 0)
+		{
+			USARTConfig->USART_BaudRate = USART_NearestStandardBaudRate((F_CPU + (bit / 2)) / bit, USART_AUTOBAUD_SNAP_ERROR);
+			USARTInit(__USARTType__, *USARTConfig);
+			return 0x00;
+		}
+	}
+	return 0x01;
+}
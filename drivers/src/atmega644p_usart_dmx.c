@@ -0,0 +1,371 @@
+/**
+  ******************************************************************************
+  * @file    atmega644p_usart_dmx.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file has the DMX512 transmitter and receiver on the USARTs
+  * @Note	 Transmit: the BREAK is a 0x00 sent at USART_DMX_BREAK_BAUD_RATE, its 9 low bits are
+  *			 the BREAK and its 2 stop bits the MAB. UBRRn can only be changed when the shift register
+  *			 is empty, so every packet is two interrupt driven transmissions (USART_StartTransmit()):
+  *			 + the BREAK byte, its complete hook (TXC ISR) switches to 250kbaud and starts the slots
+  *			 + start code and slots from the UDRE ISR, the complete hook starts the next BREAK
+  *			 The CPU only runs one UDRE ISR per slot (44us). The universe is double buffered: the
+  *			 application writes the buffer which is not sent and commits it, the buffers are swapped
+  *			 at the start of the next packet, so a packet is never a mix of two updates.
+  *			 Receive: a BREAK is received as 0x00 with a frame error (the stop bit is low). The slots
+  *			 after it are stored by the receive ISR straight into the buffer, the packet is given to the
+  *			 application at the next BREAK or when the buffer is full (double buffered, no copy).
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Call USART_DMXInit() with the USART and TRANSMIT, RECEIVE or BOTH, it returns the actual baud rate
+  * 2. Transmitter: fill two buffers (start code in [0], slot n in [n]) and call USART_DMX_StartTransmit(),
+  *    the first buffer is sent continuously. To change the levels write the buffer returned by
+  *    USART_DMX_GetTransmitBuffer() (NULL while the previous commit is pending) and call USART_DMX_CommitTransmitBuffer().
+  *    Every slot of the new buffer has to be written, it has the levels of the commit before the last one.
+  * 3. Receiver: call USART_DMX_StartReceive() with two buffers and optionally a hook (called from the receive ISR).
+  *    USART_DMX_Receive() returns the last packet (start code in [0]), call USART_DMX_Release() when done with it.
+  * 4. For a RS-485 transceiver call USART_EnableRS485() with the driver enable pin before starting the transmitter
+  * -> USARTInit() has to be called to use the USART as an USART again
+  ******************************************************************************
+  */
+
+/*----------------------------------- Includes -------------------------------*/
+#include "atmega644p_usart_dmx.h"
+
+/*---------------------------------- Defines ----------------------------------*/
+#define DMX_BREAK_DATA				0x00
+
+/*---------------------------------- Typedefs ----------------------------------*/
+typedef struct
+{
+	volatile uint8_t	*RegA;
+	volatile uint8_t	*RegB;
+	volatile uint8_t	*BRRH;
+	volatile uint8_t	*BRRL;
+}USART_DMX_RegistersType;
+
+typedef struct
+{
+	uint8_t				*Buffer[2];
+	uint16_t			Length;
+	uint8_t				Active;			// buffer which is sent
+	volatile uint8_t	Pending;		// the other buffer has been committed
+	volatile uint8_t	Running;
+	volatile uint8_t	Stop;
+	USART_BaudType		Break;			// UBRRn/U2Xn of the BREAK
+	USART_BaudType		Slots;			// UBRRn/U2Xn of the slots
+}USART_DMX_TransmitType;
+
+typedef struct
+{
+	uint8_t				*Buffer[2];
+	uint16_t			Size;
+	uint16_t			Length[2];
+	uint16_t			Index;
+	uint8_t				Write;			// buffer of the ISR
+	volatile uint8_t	Ready;			// buffer 1 - Write has a packet
+	uint8_t				Receiving;		// a BREAK has been seen, slots are stored
+	USART_DMX_ReceivedHookType	Hook;
+	USART_DMX_StatisticsType	Statistics;
+}USART_DMX_ReceiveType;
+
+/*---------------------------------- Global Variables ----------------------------------*/
+static const USART_DMX_RegistersType gUSART_DMX[2] =
+{
+	{ &(UCSR0A), &(UCSR0B), &(UBRR0H), &(UBRR0L) },
+	{ &(UCSR1A), &(UCSR1B), &(UBRR1H), &(UBRR1L) },
+};
+
+static USART_DMX_TransmitType gUSART_DMX_Transmit[2];
+static USART_DMX_ReceiveType gUSART_DMX_Receive[2];
+static const uint8_t gUSART_DMX_Break = DMX_BREAK_DATA;
+
+/*---------------------------------- Function and Hooks ----------------------------------*/
+
+/*
+ * @name   	USART_DMX_SetBaud(uint8_t, const USART_BaudType *)
+ * @brief	This function is to switch the baud rate between the BREAK and the slots
+ * @note	Only called when the transmitter is idle (TXC), writing UBRRnL updates the prescaler immediately
+ */
+static inline void USART_DMX_SetBaud(uint8_t __USARTType__, const USART_BaudType *baud)
+{
+	const USART_DMX_RegistersType *dmx = &gUSART_DMX[__USARTType__];
+
+	REG_WRITE(*dmx->RegA, baud->DoubleSpeed ? DOUBLE_SPEED_BIT : 0x00);
+	REG_WRITE(*dmx->BRRH, (baud->UBRR >> 8) & 0xFF);
+	REG_WRITE(*dmx->BRRL, baud->UBRR & 0xFF);
+}
+
+static void USART_DMX_SendBreak(uint8_t __USARTType__);
+
+/*
+ * @name   	USART_DMX_PacketSent(uint8_t)
+ * @brief	Complete hook of the slots (TXC ISR): the next packet starts with its BREAK
+ */
+static void USART_DMX_PacketSent(uint8_t __USARTType__)
+{
+	USART_DMX_TransmitType *transmit = &gUSART_DMX_Transmit[__USARTType__];
+
+	if(transmit->Stop)
+	{
+		transmit->Running = 0;
+		return;
+	}
+	USART_DMX_SendBreak(__USARTType__);
+}
+
+/*
+ * @name   	USART_DMX_BreakSent(uint8_t)
+ * @brief	Complete hook of the BREAK (TXC ISR): the MAB is on the line, the slots are started at 250kbaud
+ */
+static void USART_DMX_BreakSent(uint8_t __USARTType__)
+{
+	USART_DMX_TransmitType *transmit = &gUSART_DMX_Transmit[__USARTType__];
+
+	if(transmit->Pending)
+	{
+		transmit->Active ^= 0x01;
+		transmit->Pending = 0;
+	}
+	USART_DMX_SetBaud(__USARTType__, &transmit->Slots);
+	USART_StartTransmit(__USARTType__, transmit->Buffer[transmit->Active], transmit->Length, USART_DMX_PacketSent);
+}
+
+/*
+ * @name   	USART_DMX_SendBreak(uint8_t)
+ * @brief	This function starts a packet: 0x00 at the BREAK baud rate
+ */
+static void USART_DMX_SendBreak(uint8_t __USARTType__)
+{
+	USART_DMX_SetBaud(__USARTType__, &gUSART_DMX_Transmit[__USARTType__].Break);
+	USART_StartTransmit(__USARTType__, &gUSART_DMX_Break, 1, USART_DMX_BreakSent);
+}
+
+/*
+ * @name   	USART_DMX_Publish(uint8_t, USART_DMX_ReceiveType *)
+ * @brief	Gives the received packet to the application
+ */
+static void USART_DMX_Publish(uint8_t __USARTType__, USART_DMX_ReceiveType *receive)
+{
+	if(receive->Ready)
+	{
+		receive->Statistics.Dropped++;						// previous packet is still used, the ISR keeps its buffer
+		return;
+	}
+	receive->Length[receive->Write] = receive->Index;
+	receive->Write ^= 0x01;
+	receive->Ready = 1;
+	receive->Statistics.Packets++;
+	if(receive->Hook != NULL)
+		receive->Hook(__USARTType__);
+}
+
+/*
+ * @name   	USART_DMX_ReceiveHook(uint8_t, uint16_t)
+ * @brief	Receive hook of the USART: BREAK detection and storage of the slots
+ * @note	A BREAK longer than one character is received once, the receiver waits for the line to be high
+ */
+static void USART_DMX_ReceiveHook(uint8_t __USARTType__, uint16_t data)
+{
+	USART_DMX_ReceiveType *receive = &gUSART_DMX_Receive[__USARTType__];
+
+	if((data & USART_RX_FRAME_ERROR) && ((data & USART_RX_DATA) == DMX_BREAK_DATA))
+	{
+		if(receive->Receiving && (receive->Index != 0))
+			USART_DMX_Publish(__USARTType__, receive);		// packet with less slots than the buffer
+		receive->Index = 0;
+		receive->Receiving = 1;
+		return;
+	}
+	if(!receive->Receiving)
+		return;												// wait for the next BREAK
+
+	if(data & USART_RX_ERRORS)
+	{
+		receive->Statistics.Errors++;
+		receive->Receiving = 0;
+		return;
+	}
+	receive->Buffer[receive->Write][receive->Index] = data & 0xFF;
+	receive->Index++;
+	if(receive->Index >= receive->Size)
+	{
+		USART_DMX_Publish(__USARTType__, receive);			// no need to wait for the next BREAK
+		receive->Receiving = 0;
+	}
+}
+
+/*
+ * @name   	USART_DMXInit(uint8_t, USARTCommunicationType)
+ * @brief	This function is to configure USARTx for DMX512: 250kbaud, 8N2
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			direction     - TRANSMIT, RECEIVE or BOTH
+ * @retval	Actual baud rate of the slots
+ */
+uint32_t USART_DMXInit(uint8_t __USARTType__, USARTCommunicationType direction)
+{
+	USART_DMX_TransmitType *transmit = &gUSART_DMX_Transmit[__USARTType__ & 0x01];
+	USART_StructureType config;
+
+	config.USART_BaudRate = USART_DMX_BAUD_RATE;
+	config.USART_Parity = NOPARITY;
+	config.USART_StopBits = TWOSTOPBIT;
+	config.USART_DataBits = EIGHT;
+	config.USART_Modes = ASYNCHRONOUS;
+	config.USART_Communication = direction;
+
+	USART_CalculateBaud(USART_DMX_BREAK_BAUD_RATE, ASYNCHRONOUS, &transmit->Break);
+	USART_CalculateBaud(USART_DMX_BAUD_RATE, ASYNCHRONOUS, &transmit->Slots);
+
+	return USARTInit(__USARTType__ & 0x01, config);
+}
+
+/*
+ * @name   	USART_DMX_StartTransmit(uint8_t, uint8_t *, uint8_t *, uint16_t)
+ * @brief	This function is to start sending the packets continuously
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			buffer0       - first buffer, sent from the first packet on
+ * 			buffer1       - second buffer, written by the application
+ * 			length        - bytes of each buffer: start code and slots, USART_DMX_MIN_LENGTH to USART_DMX_MAX_LENGTH
+ * @note	Global interrupts have to be enabled
+ * @retval	0x00 - transmitter is running
+ * 			0x01 - the USART is still sending
+ * 			0x02 - wrong length
+ */
+uint8_t USART_DMX_StartTransmit(uint8_t __USARTType__, uint8_t *buffer0, uint8_t *buffer1, uint16_t length)
+{
+	USART_DMX_TransmitType *transmit = &gUSART_DMX_Transmit[__USARTType__ & 0x01];
+
+	if((length < USART_DMX_MIN_LENGTH) || (length > USART_DMX_MAX_LENGTH))
+		return 0x02;
+	if(transmit->Running || USART_IsTransmitBusy(__USARTType__))
+		return 0x01;
+
+	transmit->Buffer[0] = buffer0;
+	transmit->Buffer[1] = buffer1;
+	transmit->Length = length;
+	transmit->Active = 0;
+	transmit->Pending = 0;
+	transmit->Stop = 0;
+	transmit->Running = 1;
+	USART_DMX_SendBreak(__USARTType__ & 0x01);
+	return 0x00;
+}
+
+/*
+ * @name   	USART_DMX_StopTransmit(uint8_t)
+ * @brief	This function is to stop the transmitter after the current packet
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ */
+void USART_DMX_StopTransmit(uint8_t __USARTType__)
+{
+	gUSART_DMX_Transmit[__USARTType__ & 0x01].Stop = 1;
+}
+
+/*
+ * @name   	USART_DMX_GetTransmitBuffer(uint8_t)
+ * @brief	This function returns the buffer which the application can write
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * @retval	buffer which is not sent, NULL while a committed buffer waits for the next packet
+ */
+uint8_t* USART_DMX_GetTransmitBuffer(uint8_t __USARTType__)
+{
+	USART_DMX_TransmitType *transmit = &gUSART_DMX_Transmit[__USARTType__ & 0x01];
+	uint8_t sreg = SREG;
+	uint8_t *buffer = NULL;
+
+	cli();
+	if(!transmit->Pending)
+		buffer = transmit->Buffer[transmit->Active ^ 0x01];
+	SREG = sreg;
+	return buffer;
+}
+
+/*
+ * @name   	USART_DMX_CommitTransmitBuffer(uint8_t)
+ * @brief	This function is to send the buffer of USART_DMX_GetTransmitBuffer() from the next packet on
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ */
+void USART_DMX_CommitTransmitBuffer(uint8_t __USARTType__)
+{
+	gUSART_DMX_Transmit[__USARTType__ & 0x01].Pending = 1;
+}
+
+/*
+ * @name   	USART_DMX_StartReceive(uint8_t, uint8_t *, uint8_t *, uint16_t, USART_DMX_ReceivedHookType)
+ * @brief	This function is to start receiving packets
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			buffer0       - first buffer
+ * 			buffer1       - second buffer
+ * 			size          - bytes of each buffer (start code and slots), upto USART_DMX_MAX_LENGTH.
+ * 			                The slots after the buffer are not stored.
+ * 			hook          - called from the receive ISR when a packet is ready, can be NULL
+ * @note	Replaces the receive hook of the USART and enables the receive interrupt.
+ * 			The first packet is taken after the first BREAK.
+ */
+void USART_DMX_StartReceive(uint8_t __USARTType__, uint8_t *buffer0, uint8_t *buffer1, uint16_t size, USART_DMX_ReceivedHookType hook)
+{
+	USART_DMX_ReceiveType *receive = &gUSART_DMX_Receive[__USARTType__ & 0x01];
+	uint8_t sreg = SREG;
+
+	cli();
+	receive->Buffer[0] = buffer0;
+	receive->Buffer[1] = buffer1;
+	receive->Size = (size > USART_DMX_MAX_LENGTH) ? USART_DMX_MAX_LENGTH : size;
+	receive->Index = 0;
+	receive->Write = 0;
+	receive->Ready = 0;
+	receive->Receiving = 0;
+	receive->Hook = hook;
+	receive->Statistics.Packets = 0;
+	receive->Statistics.Errors = 0;
+	receive->Statistics.Dropped = 0;
+	SREG = sreg;
+
+	USART_RegisterReceiveHook(__USARTType__ & 0x01, USART_DMX_ReceiveHook);
+	USART_SetReceiveInterrupt(__USARTType__ & 0x01, 1);
+}
+
+/*
+ * @name   	USART_DMX_Receive(uint8_t, uint16_t *)
+ * @brief	This function returns the last received packet
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			length        - bytes of the packet: start code and slots
+ * @retval	packet, NULL if there is none. It is valid until USART_DMX_Release().
+ */
+const uint8_t* USART_DMX_Receive(uint8_t __USARTType__, uint16_t *length)
+{
+	USART_DMX_ReceiveType *receive = &gUSART_DMX_Receive[__USARTType__ & 0x01];
+	uint8_t buffer;
+
+	if(!receive->Ready)
+		return NULL;
+
+	buffer = receive->Write ^ 0x01;
+	*length = receive->Length[buffer];
+	return receive->Buffer[buffer];
+}
+
+/*
+ * @name   	USART_DMX_Release(uint8_t)
+ * @brief	This function gives the buffer of USART_DMX_Receive() back to the receive ISR
+ */
+void USART_DMX_Release(uint8_t __USARTType__)
+{
+	gUSART_DMX_Receive[__USARTType__ & 0x01].Ready = 0;
+}
+
+/*
+ * @name   	USART_DMX_GetStatistics(uint8_t, USART_DMX_StatisticsType *)
+ * @brief	This function copies the receive counters of the USART
+ */
+void USART_DMX_GetStatistics(uint8_t __USARTType__, USART_DMX_StatisticsType *statistics)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	*statistics = gUSART_DMX_Receive[__USARTType__ & 0x01].Statistics;
+	SREG = sreg;
+}
@@ -0,0 +1,280 @@
+/**
+  ******************************************************************************
+  * @file    atmega644p_usart_idle.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file has the idle line framing of the USART receivers: a frame ends
+  *			 when the line has been silent for a timeout (e.g. 3.5 characters of Modbus RTU),
+  *			 not on a delimiter byte.
+  * @Note	 Every received byte re-arms a compare unit of the free running Timer2 (clk/128):
+  *			 USART0 uses OCR2A and USART1 uses OCR2B. When the compare matches the line has been
+  *			 idle for the timeout and the bytes received so far are published as one frame.
+  *			 A timeout longer than 256 ticks lets the compare match pass (timeout - 1) / 256 times
+  *			 before the frame is closed, the compare register is never written again.
+  *			 The frame buffers are given by the caller, two of them: the receive ISR fills one
+  *			 while the application works on the other one (no copy). The Timer2 ticks add upto
+  *			 one tick (8us at 16MHz) to the timeout, one more when it is a multiple of 256 ticks.
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Configure the USART with USARTInit() and enable the receive interrupt
+  * 2. Call USART_EnableIdleFrames() with two buffers of the same size, the timeout in us (0 -> 3.5 characters)
+  *    and optionally a hook called from the Timer2 ISR when a frame is ready (e.g. to post a scheduler task)
+  * 3. USART_ReceiveIdleFrame() returns the frame (no copy) and its status (overflow / line errors),
+  *    call USART_ReleaseIdleFrame() when done with it
+  * 4. USART_DisableIdleFrames() goes back to the receive buffer of atmega644p_usart.c
+  ******************************************************************************
+  */
+
+/*----------------------------------- Includes -------------------------------*/
+#include "atmega644p_usart.h"
+#include "atmega644p_timer.h"
+
+/*---------------------------------- Defines ----------------------------------*/
+#define IDLE_CYCLES_PER_US			(F_CPU / 1000000UL)
+#define IDLE_CHARACTERS_X10			35		// default timeout: 3.5 characters
+
+/*---------------------------------- Typedefs ----------------------------------*/
+typedef struct
+{
+	uint8_t						*Buffer[2];
+	uint16_t					Size;
+	uint16_t					Length[2];
+	uint8_t						Status[2];		// USART_IDLE_FRAME_OVERFLOW / USART_IDLE_FRAME_LINE_ERROR
+	uint8_t						Write;			// buffer of the ISR
+	volatile uint8_t			Ready;			// buffer 1 - Write has a frame
+	uint16_t					Ticks;			// timeout in Timer2 ticks
+	uint8_t						Rounds;			// compare matches to let pass before the timeout
+	USART_IdleFrameHookType		Hook;
+	uint16_t					Dropped;		// frames lost because the application did not release the previous one
+}USART_IdleFrameType;
+
+typedef struct
+{
+	volatile uint8_t	*Compare;		// OCR2A / OCR2B
+	uint8_t				Interrupt;		// OCIE2A / OCIE2B, OCF2A / OCF2B
+}USART_IdleTimerType;
+
+/*---------------------------------- Global Variables ----------------------------------*/
+static USART_IdleFrameType gUSART_IdleFrame[2];
+
+static const USART_IdleTimerType gUSART_IdleTimer[2] =
+{
+	{ &(OCR2A), TIMER2_COMPARE_A_INTERRUPT },
+	{ &(OCR2B), TIMER2_COMPARE_B_INTERRUPT },
+};
+
+/*---------------------------------- Function and Hooks ----------------------------------*/
+
+/*
+ * @name   	USART_IdleReceiveHook(uint8_t, uint16_t)
+ * @brief	Receive hook of the USART: stores the byte and restarts the timeout
+ * @param  	__USARTType__ - USART0 or USART1
+ * 			data          - received word with the USART_RX_ERRORS flags
+ * @retval	-
+ * @note	Called from the receive ISR, so Timer2 cannot interrupt the re-arming.
+ */
+static void USART_IdleReceiveHook(uint8_t __USARTType__, uint16_t data)
+{
+	USART_IdleFrameType *frame = &gUSART_IdleFrame[__USARTType__];
+	const USART_IdleTimerType *timer = &gUSART_IdleTimer[__USARTType__];
+	uint16_t *length = &frame->Length[frame->Write];
+
+	if(*length < frame->Size)
+	{
+		frame->Buffer[frame->Write][*length] = data & 0xFF;
+		(*length)++;
+	}
+	else
+	{
+		frame->Status[frame->Write] |= USART_IDLE_FRAME_OVERFLOW;
+	}
+	if(data & USART_RX_ERRORS)
+		frame->Status[frame->Write] |= USART_IDLE_FRAME_LINE_ERROR;
+
+	//Compare matches first after (Ticks - 1) % 256 + 1 ticks, then every 256 ticks (Ticks % 256 is never 0)
+	frame->Rounds = (frame->Ticks - 1) >> 8;
+	REG_WRITE(*(timer->Compare), REG_READ(TCNT2) + (uint8_t)(((frame->Ticks - 1) & 0xFF) + 1));
+	REG_WRITE(TIFR2, timer->Interrupt);			// a match of the previous byte must not close the frame, cleared by writing one
+	REG_SET(TIMSK2, timer->Interrupt);
+}
+
+/*
+ * @name   	USART_IdleTimeout(uint8_t)
+ * @brief	Compare match of Timer2: closes the frame once the line has been idle for the timeout
+ * @param  	__USARTType__ - USART0 or USART1
+ * @retval	-
+ */
+static void USART_IdleTimeout(uint8_t __USARTType__)
+{
+	USART_IdleFrameType *frame = &gUSART_IdleFrame[__USARTType__];
+
+	if(frame->Rounds != 0)
+	{
+		frame->Rounds--;
+		return;
+	}
+	REG_CLEAR(TIMSK2, gUSART_IdleTimer[__USARTType__].Interrupt);
+
+	if(frame->Ready)
+	{
+		frame->Dropped++;										// previous frame is still used, the ISR keeps its buffer
+	}
+	else
+	{
+		frame->Write ^= 0x01;
+		frame->Ready = 1;
+		if(frame->Hook != NULL)
+			frame->Hook(__USARTType__);
+	}
+	frame->Length[frame->Write] = 0;
+	frame->Status[frame->Write] = 0;
+}
+
+/*
+ * @name   	TIMER2_COMPA_IRQHandler()
+ * @brief	Idle line timeout of USART0
+ */
+TIMER2_COMPA_IRQHandler()
+{
+	USART_IdleTimeout(USART0);
+}
+
+/*
+ * @name   	TIMER2_COMPB_IRQHandler()
+ * @brief	Idle line timeout of USART1
+ */
+TIMER2_COMPB_IRQHandler()
+{
+	USART_IdleTimeout(USART1);
+}
+
+/*
+ * @name   	USART_CharacterTime(uint8_t)
+ * @brief	This function is to calculate the time of one character on the line with the current configuration
+ * @param  	__USARTType__ - USART0 or USART1
+ * @retval	Character time in us: start bit, data bits, parity bit and stop bits at the achieved baud rate
+ */
+uint16_t USART_CharacterTime(uint8_t __USARTType__)
+{
+	volatile uint8_t *regB = (__USARTType__ & 0x01) ? &(UCSR1B) : &(UCSR0B);
+	volatile uint8_t *regC = (__USARTType__ & 0x01) ? &(UCSR1C) : &(UCSR0C);
+	uint8_t config = REG_READ(*regC);
+	uint8_t bits;
+	USART_BaudType baud;
+
+	USART_GetBaud(__USARTType__, &baud);
+	if(baud.BaudRate == 0)
+		return 0;
+
+	bits = (REG_READ(*regB) & 0x04) ? 9 : 5 + ((config >> 1) & 0x03);	// UCSZn2 set -> 9 data bits
+	bits += 1;															// start bit
+	if(config & 0x20)
+		bits += 1;														// UPMn1: parity bit
+	bits += (config & TWOSTOPBIT) ? 2 : 1;
+
+	return ((uint32_t)bits * 1000000UL + baud.BaudRate - 1) / baud.BaudRate;
+}
+
+/*
+ * @name   	USART_EnableIdleFrames(uint8_t, uint8_t *, uint8_t *, uint16_t, uint16_t, USART_IdleFrameHookType)
+ * @brief	This function is to receive frames delimited by an idle line
+ * @param  	__USARTType__ - USART0 or USART1
+ * 			buffer0       - first frame buffer
+ * 			buffer1       - second frame buffer
+ * 			size          - bytes of each buffer, longer frames are cut (USART_IDLE_FRAME_OVERFLOW)
+ * 			timeout       - idle time in us which ends a frame, 0 -> 3.5 characters (USART_CharacterTime())
+ * 			hook          - called from the Timer2 ISR when a frame is ready, can be NULL
+ * @retval	-
+ * @note	Replaces the receive hook of the USART and starts Timer2. USARTInit() has to be called before,
+ * 			for the default timeout. Timeouts upto 0xFFFF us are possible (8191 ticks).
+ */
+void USART_EnableIdleFrames(uint8_t __USARTType__, uint8_t *buffer0, uint8_t *buffer1, uint16_t size, uint16_t timeout, USART_IdleFrameHookType hook)
+{
+	USART_IdleFrameType *frame = &gUSART_IdleFrame[__USARTType__ & 0x01];
+	uint8_t sreg = SREG;
+
+	if(timeout == 0)
+		timeout = ((uint32_t)USART_CharacterTime(__USARTType__) * IDLE_CHARACTERS_X10 + 9) / 10;
+
+	cli();
+	REG_CLEAR(TIMSK2, gUSART_IdleTimer[__USARTType__ & 0x01].Interrupt);
+	frame->Buffer[0] = buffer0;
+	frame->Buffer[1] = buffer1;
+	frame->Size = size;
+	frame->Length[0] = frame->Length[1] = 0;
+	frame->Status[0] = frame->Status[1] = 0;
+	frame->Write = 0;
+	frame->Ready = 0;
+	frame->Hook = hook;
+	frame->Dropped = 0;
+	//Rounded up and one more tick: the counter can be just before its next tick when the timeout is armed
+	frame->Ticks = ((uint32_t)timeout * IDLE_CYCLES_PER_US + TIMER2_PRESCALAR - 1) / TIMER2_PRESCALAR + 1;
+	if((frame->Ticks & 0xFF) == 0)
+		frame->Ticks++;						// a compare armed 256 ticks away equals TCNT2 when written, one more tick instead
+	SREG = sreg;
+
+	TIMER2_StartFreeRunning();
+	USART_RegisterReceiveHook(__USARTType__ & 0x01, USART_IdleReceiveHook);
+}
+
+/*
+ * @name   	USART_DisableIdleFrames(uint8_t)
+ * @brief	This function is to stop the idle line framing, the receive buffer is used again
+ * @param  	__USARTType__ - USART0 or USART1
+ * @retval	-
+ * @note	Timer2 keeps running, the other USART may still use it
+ */
+void USART_DisableIdleFrames(uint8_t __USARTType__)
+{
+	USART_RegisterReceiveHook(__USARTType__ & 0x01, NULL);
+	REG_CLEAR(TIMSK2, gUSART_IdleTimer[__USARTType__ & 0x01].Interrupt);
+}
+
+/*
+ * @name   	USART_ReceiveIdleFrame(uint8_t, uint16_t *, uint8_t *)
+ * @brief	This function is to get the last frame
+ * @param  	__USARTType__ - USART0 or USART1
+ * 			length        - number of bytes of the frame
+ * 			status        - USART_IDLE_FRAME_OVERFLOW / USART_IDLE_FRAME_LINE_ERROR, can be NULL
+ * @retval	frame, NULL if there is no frame. It is valid until USART_ReleaseIdleFrame().
+ */
+const uint8_t* USART_ReceiveIdleFrame(uint8_t __USARTType__, uint16_t *length, uint8_t *status)
+{
+	USART_IdleFrameType *frame = &gUSART_IdleFrame[__USARTType__ & 0x01];
+	uint8_t buffer;
+
+	if(!frame->Ready)
+		return NULL;
+
+	buffer = frame->Write ^ 0x01;
+	*length = frame->Length[buffer];
+	if(status != NULL)
+		*status = frame->Status[buffer];
+	return frame->Buffer[buffer];
+}
+
+/*
+ * @name   	USART_ReleaseIdleFrame(uint8_t)
+ * @brief	This function gives the buffer of the frame returned by USART_ReceiveIdleFrame() back to the ISR
+ */
+void USART_ReleaseIdleFrame(uint8_t __USARTType__)
+{
+	gUSART_IdleFrame[__USARTType__ & 0x01].Ready = 0;
+}
+
+/*
+ * @name   	USART_GetIdleFramesDropped(uint8_t)
+ * @brief	This function returns the frames lost because the previous frame was not released in time
+ */
+uint16_t USART_GetIdleFramesDropped(uint8_t __USARTType__)
+{
+	uint8_t sreg = SREG;
+	uint16_t dropped;
+
+	cli();
+	dropped = gUSART_IdleFrame[__USARTType__ & 0x01].Dropped;
+	SREG = sreg;
+	return dropped;
+}
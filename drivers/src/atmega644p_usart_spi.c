@@ -0,0 +1,150 @@
+/**
+  ******************************************************************************
+  * @file    atmega644p_usart_spi.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file has the USART Master SPI mode (MSPIM) configuration and the data transfer
+  * @Note	 SCK frequency = F_CPU / (2 * (UBRRn + 1)) => UBRRn = (F_CPU / (2 * rate)) - 1
+  * 		 The divider is rounded up, so the SCK frequency is never above the requested one.
+  *			 Transmit and receive buffers of the USART are double buffered: the burst transfer keeps
+  *			 two bytes in flight, so the next byte is already in UDRn when the current one is shifted
+  *			 out and there is no gap between the bytes. Never more than two bytes are in flight, so the
+  *			 2 byte receive FIFO cannot overflow.
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Call USART_SPIInit() with the USART and the SPI configuration, it returns the actual SCK frequency
+  * 2. Select the slave with GPIO_Write() (slave select pin is not handled by this driver)
+  * 3. Call USART_SPI_Transfer() for one byte or USART_SPI_TransferBuffer() for a burst
+  * 4. Deselect the slave
+  * -> USARTInit() has to be called to use the USART as an USART again
+  ******************************************************************************
+  */
+
+/*----------------------------------- Includes -------------------------------*/
+#include "atmega644p_usart_spi.h"
+
+/*---------------------------------- Defines ----------------------------------*/
+#define MSPIM_MODE_SELECT			0xC0	// UMSELn1:0 = 11 in UCSRnC
+
+/*---------------------------------- Typedefs ----------------------------------*/
+typedef struct
+{
+	volatile uint8_t	*RegA;
+	volatile uint8_t	*RegB;
+	volatile uint8_t	*RegC;
+	volatile uint8_t	*BRRH;
+	volatile uint8_t	*BRRL;
+	volatile uint8_t	*Data;
+	volatile uint8_t	*ClockDDR;		// DDR of the XCKn pin
+	uint8_t				ClockPin;
+}USART_SPI_RegistersType;
+
+/*---------------------------------- Global Variables ----------------------------------*/
+static const USART_SPI_RegistersType gUSART_SPI[2] =
+{
+	{ &(UCSR0A), &(UCSR0B), &(UCSR0C), &(UBRR0H), &(UBRR0L), &(UDR0), &(DDRB), 0x01 },	// XCK0 -> PB0
+	{ &(UCSR1A), &(UCSR1B), &(UCSR1C), &(UBRR1H), &(UBRR1L), &(UDR1), &(DDRD), 0x10 },	// XCK1 -> PD4
+};
+
+/*---------------------------------- Function and Hooks ----------------------------------*/
+
+/*
+ * @name   	USART_SPIInit(uint8_t, USART_SPI_StructureType)
+ * @brief	This function is to configure USARTx as SPI master
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			SPIConfig     - clock rate, SPI mode and data order
+ * @note	Sequence is from the datasheet: UBRRn has to be 0 while the mode is changed and it is
+ *			written only after the transmitter has been enabled.
+ * @retval	Actual SCK frequency in Hz
+ */
+uint32_t USART_SPIInit(uint8_t __USARTType__, USART_SPI_StructureType SPIConfig)
+{
+	const USART_SPI_RegistersType *spi = &gUSART_SPI[__USARTType__ & 0x01];
+	uint32_t divider;
+	uint16_t BaudRateRegValue;
+
+	if(SPIConfig.USART_SPI_ClockRate == 0)
+		SPIConfig.USART_SPI_ClockRate = 1;
+
+	// Rounded up: SCK never runs faster than requested
+	divider = (F_CPU + (2 * SPIConfig.USART_SPI_ClockRate) - 1) / (2 * SPIConfig.USART_SPI_ClockRate);
+	if(divider == 0)
+		divider = 1;
+	if(divider > 4096)
+		divider = 4096;	// UBRRn is 12 bits
+	BaudRateRegValue = divider - 1;
+
+	REG_WRITE(*spi->BRRH, 0x00);
+	REG_WRITE(*spi->BRRL, 0x00);
+	REG_WRITE(*spi->RegB, 0x00);
+
+	REG_SET(*spi->ClockDDR, spi->ClockPin);		// XCKn as output -> master mode
+	REG_WRITE(*spi->RegC, MSPIM_MODE_SELECT | SPIConfig.USART_SPI_DataOrder | SPIConfig.USART_SPI_Mode);
+	REG_WRITE(*spi->RegB, BOTH);				// Receiver and transmitter, no interrupt
+
+	REG_WRITE(*spi->BRRH, (BaudRateRegValue >> 8) & 0x0F);
+	REG_WRITE(*spi->BRRL, BaudRateRegValue & 0xFF);
+
+	return F_CPU / (2 * divider);
+}
+
+/*
+ * @name   	USART_SPI_Transfer(uint8_t, uint8_t)
+ * @brief	This function is to send one byte and return the byte received at the same time
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			data          - byte to be sent
+ * @retval	received byte
+ */
+uint8_t USART_SPI_Transfer(uint8_t __USARTType__, uint8_t data)
+{
+	const USART_SPI_RegistersType *spi = &gUSART_SPI[__USARTType__ & 0x01];
+
+	while(!(REG_READ(*spi->RegA) & DATA_REGISTER_EMPTY_FLAG))
+		;
+	REG_WRITE(*spi->Data, data);
+
+	while(!(REG_READ(*spi->RegA) & RECEIVE_COMPLETE_FLAG))
+		;
+	return REG_READ(*spi->Data);
+}
+
+/*
+ * @name   	USART_SPI_TransferBuffer(uint8_t, const uint8_t *, uint8_t *, uint16_t)
+ * @brief	This function is to transfer a burst of bytes without gap between them
+ * @param  	__USARTType__ - can have the values USART0 or USART1
+ * 			transmit      - bytes to be sent, NULL to send USART_SPI_DUMMY_BYTE (read only transfer)
+ * 			receive       - where the received bytes are stored, NULL to drop them (write only transfer)
+ * 			length        - number of bytes
+ * @note	transmit and receive can be the same buffer (in place transfer)
+ * @retval	None
+ */
+void USART_SPI_TransferBuffer(uint8_t __USARTType__, const uint8_t *transmit, uint8_t *receive, uint16_t length)
+{
+	const USART_SPI_RegistersType *spi = &gUSART_SPI[__USARTType__ & 0x01];
+	uint16_t txIndex = 0;
+	uint16_t rxIndex = 0;
+	uint8_t status;
+	uint8_t data;
+
+	while(rxIndex < length)
+	{
+		status = REG_READ(*spi->RegA);
+
+		// Keep UDRn fed, but not more than 2 bytes ahead of the receiver
+		if((txIndex < length) && ((txIndex - rxIndex) < 2) && (status & DATA_REGISTER_EMPTY_FLAG))
+		{
+			REG_WRITE(*spi->Data, (transmit != NULL) ? transmit[txIndex] : USART_SPI_DUMMY_BYTE);
+			txIndex++;
+		}
+
+		if(status & RECEIVE_COMPLETE_FLAG)
+		{
+			data = REG_READ(*spi->Data);
+			if(receive != NULL)
+				receive[rxIndex] = data;
+			rxIndex++;
+		}
+	}
+}
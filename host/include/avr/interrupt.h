@@ -0,0 +1,25 @@
+/**
+  ******************************************************************************
+  * @file    interrupt.h (host shim)
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Host replacement for <avr/interrupt.h>.
+  * @note    ISR(USART0_RX_vect) becomes a plain function void USART0_RX_vect(void)
+  *          which the host code can call to simulate the interrupt.
+  ******************************************************************************
+  */
+
+#ifndef __HOST_AVR_INTERRUPT_H
+#define __HOST_AVR_INTERRUPT_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/io.h>
+
+/* Defines -------------------------------------------------------------------*/
+#define ISR(vector, ...)	void vector(void); void vector(void)
+
+#define sei()				(SREG |= 0x80)
+#define cli()				(SREG &= 0x7F)
+
+#endif // __HOST_AVR_INTERRUPT_H
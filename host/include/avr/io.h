@@ -0,0 +1,70 @@
+/**
+  ******************************************************************************
+  * @file    io.h (host shim)
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Host replacement for <avr/io.h>. Every I/O register of the atmega644p
+  *          which is used by the drivers is a plain RAM variable here, so that the
+  *          common/ and drivers/ code can be compiled and run on a Linux machine.
+  * @note    Registers are defined in host/src/host_io.c
+  ******************************************************************************
+  */
+
+#ifndef __HOST_AVR_IO_H
+#define __HOST_AVR_IO_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Defines -------------------------------------------------------------------*/
+#ifndef HOST_BUILD
+#define HOST_BUILD		1
+#endif // HOST_BUILD
+
+#define _BV(bit)		(1 << (bit))
+
+/* exported registers --------------------------------------------------------*/
+//GPIO
+extern volatile uint8_t PINA, DDRA, PORTA;
+extern volatile uint8_t PINB, DDRB, PORTB;
+extern volatile uint8_t PINC, DDRC, PORTC;
+extern volatile uint8_t PIND, DDRD, PORTD;
+
+//Status register, sleep mode control
+extern volatile uint8_t SREG;
+extern volatile uint8_t SMCR;
+
+//Pin change interrupts
+extern volatile uint8_t PCICR, PCIFR;
+extern volatile uint8_t PCMSK0, PCMSK1, PCMSK2, PCMSK3;
+
+//USART0
+extern volatile uint8_t UCSR0A, UCSR0B, UCSR0C;
+extern volatile uint8_t UBRR0H, UBRR0L;
+extern volatile uint8_t UDR0;
+
+//USART1
+extern volatile uint8_t UCSR1A, UCSR1B, UCSR1C;
+extern volatile uint8_t UBRR1H, UBRR1L;
+extern volatile uint8_t UDR1;
+
+//TWI
+extern volatile uint8_t TWBR, TWSR, TWAR, TWDR, TWCR, TWAMR;
+
+//Timer0
+extern volatile uint8_t TCCR0A, TCCR0B, TCNT0, OCR0A, OCR0B;
+extern volatile uint8_t TIMSK0, TIFR0;
+
+//Timer1
+extern volatile uint8_t TCCR1A, TCCR1B, TCCR1C;
+extern volatile uint8_t TCNT1L, TCNT1H;
+extern volatile uint8_t OCR1AL, OCR1AH, OCR1BL, OCR1BH;
+extern volatile uint8_t ICR1L, ICR1H;
+extern volatile uint8_t TIMSK1, TIFR1;
+
+//Timer2
+extern volatile uint8_t TCCR2A, TCCR2B, TCNT2, OCR2A, OCR2B;
+extern volatile uint8_t TIMSK2, TIFR2, ASSR;
+
+#endif // __HOST_AVR_IO_H
@@ -0,0 +1,12 @@
+/**
+  ******************************************************************************
+  * @file    iomxx4.h (host shim)
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Host replacement for "avr/iomxx4.h". All the registers are already
+  *          declared by the host <avr/io.h>.
+  ******************************************************************************
+  */
+
+#include <avr/io.h>
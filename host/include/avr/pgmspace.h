@@ -0,0 +1,26 @@
+/**
+  ******************************************************************************
+  * @file    pgmspace.h (host shim)
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Host replacement for <avr/pgmspace.h>. There is only one address space
+  *          on the host: PROGMEM data is const data and pgm_read_xxx() are plain reads.
+  ******************************************************************************
+  */
+
+#ifndef __HOST_AVR_PGMSPACE_H
+#define __HOST_AVR_PGMSPACE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Defines -------------------------------------------------------------------*/
+#define PROGMEM
+#define PSTR(s)					(s)
+
+#define pgm_read_byte(addr)		(*(const uint8_t *)(addr))
+#define pgm_read_word(addr)		(*(const uint16_t *)(addr))
+#define pgm_read_dword(addr)	(*(const uint32_t *)(addr))
+
+#endif // __HOST_AVR_PGMSPACE_H
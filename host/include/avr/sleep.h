@@ -0,0 +1,35 @@
+/**
+  ******************************************************************************
+  * @file    sleep.h (host shim)
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Host replacement for <avr/sleep.h>. The sleep mode is stored in SMCR,
+  *          sleep_cpu() runs the pending ISRs of the models and returns (as if one of
+  *          them woke the CPU up), so a blocking call sleeping on a flag sees it set.
+  ******************************************************************************
+  */
+
+#ifndef __HOST_AVR_SLEEP_H
+#define __HOST_AVR_SLEEP_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/io.h>
+
+extern void Host_ServiceInterrupts(void);
+
+/* Defines -------------------------------------------------------------------*/
+#define SLEEP_MODE_IDLE			0x00
+#define SLEEP_MODE_ADC			0x02
+#define SLEEP_MODE_PWR_DOWN		0x04
+#define SLEEP_MODE_PWR_SAVE		0x06
+#define SLEEP_MODE_STANDBY		0x0C
+#define SLEEP_MODE_EXT_STANDBY	0x0E
+
+#define set_sleep_mode(mode)	(SMCR = (SMCR & 0x01) | (mode))
+#define sleep_enable()			(SMCR |= 0x01)
+#define sleep_disable()			(SMCR &= 0xFE)
+#define sleep_cpu()				Host_ServiceInterrupts()
+#define sleep_mode()			do { sleep_enable(); sleep_cpu(); sleep_disable(); } while(0)
+
+#endif // __HOST_AVR_SLEEP_H
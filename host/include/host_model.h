@@ -0,0 +1,98 @@
+/**
+  ******************************************************************************
+  * @file    host_model.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Simulated peripherals used by the host build of the drivers.
+  *          + USART0/USART1 : byte FIFO for receive and transmit, MISO queue in Master SPI mode
+  *          + TWI           : replays a list of status codes (TWSR) and data (TWDR)
+  *          + Timer1        : TCNT1 follows the monotonic clock of the host at F_CPU
+  *          + Timer2        : TCNT2 follows the same clock
+  *                            compare match interrupts of Timer1 and Timer2
+  *          + Pin           : toggles an input pin (PINx) at given times, e.g. a serial line,
+  *                            pin change interrupts
+  *          + SRAM          : heap and stack area, __brkval and SP set by the test
+  * @note    The drivers access the peripherals through REG_READ()/REG_WRITE() of
+  *          atmega644p_reg.h, these calls end up in the models. Interrupts are not
+  *          asynchronous on the host: Host_ServiceInterrupts() has to be called by
+  *          the test or benchmark program to run the pending ISRs.
+  ******************************************************************************
+  *
+  *					HOW TO USE
+  * 1. Configure the driver as on the target (USARTInit(), I2CInit() ...)
+  * 2. USART: push received bytes with HostUSART_Receive(), pop the transmitted
+  *    bytes with HostUSART_Transmitted()
+  * 3. TWI: load the bus events with HostTWI_Load() and start the communication
+  * 4. Call Host_ServiceInterrupts() to run the ISRs until nothing is pending
+  *
+  ******************************************************************************
+  */
+
+#ifndef __HOST_MODEL_H
+#define __HOST_MODEL_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <avr/io.h>
+
+/* Defines -------------------------------------------------------------------*/
+#define HOST_USART_FIFO_SIZE		256		// must be a power of 2
+
+//Error bits of a received word, reported in UCSRnA while the word is at the head of the FIFO
+#define HOST_USART_RX_FRAME_ERROR	0x1000	// -> FEn
+#define HOST_USART_RX_OVERRUN		0x0800	// -> DORn
+#define HOST_USART_RX_PARITY_ERROR	0x0400	// -> UPEn
+
+/* Typedefs and structure ----------------------------------------------------*/
+typedef struct
+{
+	uint8_t		Status;		// value of TWSR once the bus operation completes
+	uint8_t		Data;		// value of TWDR for the data received states
+}HostTWI_EventType;
+
+/* exported functions ------------------------------------------------------------------*/
+//USART model
+void HostUSART_Reset(uint8_t);
+uint16_t HostUSART_Receive(uint8_t, const uint8_t *, uint16_t);
+uint8_t HostUSART_ReceiveWord(uint8_t, uint16_t);
+uint16_t HostUSART_Transmitted(uint8_t, uint8_t *, uint16_t);
+uint16_t HostUSART_TransmittedCount(uint8_t);
+uint16_t HostUSART_Miso(uint8_t, const uint8_t *, uint16_t);
+void HostUSART_Loopback(uint8_t, uint8_t);
+uint8_t HostUSART_ReadRegister(volatile uint8_t *, uint8_t *);
+uint8_t HostUSART_WriteRegister(volatile uint8_t *, uint8_t);
+uint8_t HostUSART_ServiceInterrupts(void);
+
+//TWI model
+void HostTWI_Load(const HostTWI_EventType *, uint16_t);
+uint16_t HostTWI_Remaining(void);
+uint16_t HostTWI_Transmitted(uint8_t *, uint16_t);
+uint8_t HostTWI_WriteRegister(volatile uint8_t *, uint8_t);
+uint8_t HostTWI_ServiceInterrupts(void);
+
+//Timer1/Timer2 model
+uint8_t HostTimer_ReadRegister(volatile uint8_t *, uint8_t *);
+uint8_t HostTimer_WriteRegister(volatile uint8_t *, uint8_t);
+uint8_t HostTimer_ServiceInterrupts(void);
+uint64_t HostTimer_Cycles(void);
+
+//Pin model: a waveform on one input pin, timed with the Timer1 clock
+#define HOST_PIN_MAX_EDGES		64
+void HostPin_Waveform(volatile uint8_t *, uint8_t, const uint32_t *, uint8_t);
+uint8_t HostPin_Busy(void);
+uint8_t HostPin_ReadRegister(volatile uint8_t *, uint8_t *);
+uint8_t HostPin_ServiceInterrupts(void);
+
+//SRAM model: free RAM between the heap and the stack
+#define HOST_SRAM_SIZE			1024
+uint8_t* HostSRAM_HeapStart(void);
+uint8_t* HostSRAM_End(void);
+uint8_t* HostSRAM_StackPointer(void);
+uint8_t* HostSRAM_Break(void);
+void HostSRAM_Use(uint16_t, uint16_t);
+
+//All the models
+void Host_ServiceInterrupts(void);
+
+#endif // __HOST_MODEL_H
@@ -0,0 +1,17 @@
+/**
+  ******************************************************************************
+  * @file    delay.h (host shim)
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Host replacement for <util/delay.h>. Delays return immediately.
+  ******************************************************************************
+  */
+
+#ifndef __HOST_UTIL_DELAY_H
+#define __HOST_UTIL_DELAY_H
+
+#define _delay_ms(ms)		((void)(ms))
+#define _delay_us(us)		((void)(us))
+
+#endif // __HOST_UTIL_DELAY_H
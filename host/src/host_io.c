@@ -0,0 +1,110 @@
+/**
+  ******************************************************************************
+  * @file    host_io.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Storage for the I/O registers declared in host/include/avr/io.h and
+  *          the register access functions used by REG_READ()/REG_WRITE()
+  * @note    Reset values are taken from the datasheet. UDRE is set in UCSRnA so
+  *          that the transmit functions of the USART driver never block.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <avr/io.h>
+#include "atmega644p_reg.h"
+#include "host_model.h"
+
+/*---------------------------------- Registers ----------------------------------*/
+volatile uint8_t PINA, DDRA, PORTA;
+volatile uint8_t PINB, DDRB, PORTB;
+volatile uint8_t PINC, DDRC, PORTC;
+volatile uint8_t PIND, DDRD, PORTD;
+
+volatile uint8_t SREG;
+volatile uint8_t SMCR;
+
+volatile uint8_t PCICR, PCIFR;
+volatile uint8_t PCMSK0, PCMSK1, PCMSK2, PCMSK3;
+
+volatile uint8_t UCSR0A = 0x20, UCSR0B, UCSR0C = 0x06;
+volatile uint8_t UBRR0H, UBRR0L;
+volatile uint8_t UDR0;
+
+volatile uint8_t UCSR1A = 0x20, UCSR1B, UCSR1C = 0x06;
+volatile uint8_t UBRR1H, UBRR1L;
+volatile uint8_t UDR1;
+
+volatile uint8_t TWBR, TWSR = 0xF8, TWAR = 0xFE, TWDR = 0xFF, TWCR, TWAMR;
+
+volatile uint8_t TCCR0A, TCCR0B, TCNT0, OCR0A, OCR0B;
+volatile uint8_t TIMSK0, TIFR0;
+
+volatile uint8_t TCCR1A, TCCR1B, TCCR1C;
+volatile uint8_t TCNT1L, TCNT1H;
+volatile uint8_t OCR1AL, OCR1AH, OCR1BL, OCR1BH;
+volatile uint8_t ICR1L, ICR1H;
+volatile uint8_t TIMSK1, TIFR1;
+
+volatile uint8_t TCCR2A, TCCR2B, TCNT2, OCR2A, OCR2B;
+volatile uint8_t TIMSK2, TIFR2, ASSR;
+
+/*---------------------------------- Function and Hooks ----------------------------------*/
+
+/*
+ * @name	HostReg_Read
+ * @brief	Read access of REG_READ(), the peripheral models get the first chance to answer
+ * @param	reg - address of the register
+ * @retval	value of the register
+ */
+uint8_t HostReg_Read(volatile uint8_t *reg)
+{
+	uint8_t value;
+
+	if(HostUSART_ReadRegister(reg, &value))
+		return value;
+	if(HostTimer_ReadRegister(reg, &value))
+		return value;
+	if(HostPin_ReadRegister(reg, &value))
+		return value;
+
+	return *reg;
+}
+
+/*
+ * @name	HostReg_Write
+ * @brief	Write access of REG_WRITE(), registers without a model are plain memory
+ * @param	reg   - address of the register
+ *			value - value to be written
+ */
+void HostReg_Write(volatile uint8_t *reg, uint8_t value)
+{
+	if(HostUSART_WriteRegister(reg, value))
+		return;
+	if(HostTWI_WriteRegister(reg, value))
+		return;
+	if(HostTimer_WriteRegister(reg, value))
+		return;
+
+	*reg = value;
+}
+
+/*
+ * @name	Host_ServiceInterrupts
+ * @brief	Runs the pending ISRs of all the models until nothing is pending anymore
+ * @note	Global interrupts (I bit of SREG) have to be enabled, as on the target
+ */
+void Host_ServiceInterrupts(void)
+{
+	uint8_t pending;
+	uint8_t rounds = 0;
+
+	do
+	{
+		pending = HostUSART_ServiceInterrupts();
+		pending |= HostTWI_ServiceInterrupts();
+		pending |= HostTimer_ServiceInterrupts();
+		pending |= HostPin_ServiceInterrupts();
+	}while(pending && (++rounds < 64));	// an ISR which never clears its source must not hang the host
+}
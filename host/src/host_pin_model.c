@@ -0,0 +1,144 @@
+/**
+  ******************************************************************************
+  * @file    host_pin_model.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Host model of a waveform on one input pin.
+  * @Note	 HostPin_Waveform() takes the times of the edges in cycles after the call.
+  *			 Reading the PINx register returns the level of the pin at the current time
+  *			 of the host clock (HostTimer_Cycles()), the other bits are left as they are.
+  *			 After the last edge the pin keeps its last level.
+  *			 Pin change interrupts: HostPin_ServiceInterrupts() compares PINA..PIND with their
+  *			 previous values and runs PCINTn_vect for the toggled pins enabled in PCMSKn/PCICR.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <avr/interrupt.h>
+#include "host_model.h"
+
+/*---------------------------------- Global Variables ----------------------------------*/
+static volatile uint8_t *gHostPin_Register = NULL;
+static uint8_t gHostPin_Mask;
+static uint64_t gHostPin_Start;
+static uint32_t gHostPin_Edges[HOST_PIN_MAX_EDGES];
+static uint8_t gHostPin_Count;
+static uint8_t gHostPin_Previous[4];				// PINA..PIND at the last service
+
+void PCINT0_vect(void) __attribute__((weak));
+void PCINT1_vect(void) __attribute__((weak));
+void PCINT2_vect(void) __attribute__((weak));
+void PCINT3_vect(void) __attribute__((weak));
+
+/*---------------------------------- Function and Hooks ----------------------------------*/
+
+/*
+ * @name	HostPin_Waveform
+ * @brief	Starts a waveform on a pin
+ * @param	reg   - PINx register
+ *			mask  - pin of the register
+ *			edges - time of every edge in cycles from now, increasing
+ *			count - number of edges, upto HOST_PIN_MAX_EDGES
+ * @note	The pin starts at its current level in reg and toggles at every edge
+ */
+void HostPin_Waveform(volatile uint8_t *reg, uint8_t mask, const uint32_t *edges, uint8_t count)
+{
+	uint8_t i;
+
+	if(count > HOST_PIN_MAX_EDGES)
+		count = HOST_PIN_MAX_EDGES;
+	for(i = 0; i < count; i++)
+		gHostPin_Edges[i] = edges[i];
+
+	gHostPin_Count = count;
+	gHostPin_Mask = mask;
+	gHostPin_Register = reg;
+	gHostPin_Start = HostTimer_Cycles();
+}
+
+/*
+ * @name	HostPin_Update
+ * @brief	Updates the pin in its register to the current time
+ * @retval	0x01 - the waveform is still running
+ */
+static uint8_t HostPin_Update(void)
+{
+	uint64_t elapsed;
+
+	if(gHostPin_Register == NULL)
+		return 0x00;
+
+	elapsed = HostTimer_Cycles() - gHostPin_Start;
+	while((gHostPin_Count != 0) && (elapsed >= gHostPin_Edges[0]))
+	{
+		uint8_t i;
+
+		*gHostPin_Register ^= gHostPin_Mask;
+		for(i = 1; i < gHostPin_Count; i++)
+			gHostPin_Edges[i - 1] = gHostPin_Edges[i];
+		gHostPin_Count--;
+	}
+	if(gHostPin_Count == 0)
+	{
+		gHostPin_Register = NULL;
+		return 0x00;
+	}
+	return 0x01;
+}
+
+/*
+ * @name	HostPin_Busy
+ * @retval	0x01 - edges of the waveform are still to come
+ */
+uint8_t HostPin_Busy(void)
+{
+	return HostPin_Update();
+}
+
+/*
+ * @name	HostPin_ReadRegister
+ * @brief	Read access to the PINx register of the waveform
+ * @retval	0x01 - register belongs to the model and *value is updated, 0x00 - other register
+ */
+uint8_t HostPin_ReadRegister(volatile uint8_t *reg, uint8_t *value)
+{
+	if((gHostPin_Register == NULL) || (reg != gHostPin_Register))
+		return 0x00;
+
+	HostPin_Update();
+	*value = *reg;
+	return 0x01;
+}
+
+/*
+ * @name	HostPin_ServiceInterrupts
+ * @brief	Runs the pin change ISRs of the pins which have toggled since the last call
+ * @retval	0x01 - an ISR has been executed, 0x00 - nothing pending
+ */
+uint8_t HostPin_ServiceInterrupts(void)
+{
+	static volatile uint8_t * const pin[4] = { &PINA, &PINB, &PINC, &PIND };
+	static volatile uint8_t * const mask[4] = { &PCMSK0, &PCMSK1, &PCMSK2, &PCMSK3 };
+	static void (* const isr[4])(void) = { PCINT0_vect, PCINT1_vect, PCINT2_vect, PCINT3_vect };
+	uint8_t pending = 0x00;
+	uint8_t changed;
+	uint8_t i;
+
+	HostPin_Update();
+	for(i = 0; i < 4; i++)
+	{
+		changed = (*pin[i] ^ gHostPin_Previous[i]) & *mask[i];
+		gHostPin_Previous[i] = *pin[i];
+		if(changed && (PCICR & (1 << i)))
+			PCIFR |= (1 << i);
+		if((PCIFR & PCICR & (1 << i)) && (SREG & 0x80) && isr[i])
+		{
+			PCIFR &= ~(1 << i);					// cleared by the hardware when the ISR is executed
+			cli();	isr[i]();	sei();
+			pending = 0x01;
+		}
+	}
+	return pending;
+}
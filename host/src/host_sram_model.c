@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file    host_sram_model.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Host model of the SRAM between the end of the static data and RAMEND.
+  * @Note	 On the target the heap grows up from __heap_start and the stack grows down
+  *			 from RAMEND. Here both live in one array of HOST_SRAM_SIZE bytes: the test sets
+  *			 the heap (__brkval) and the stack depth (SP) with HostSRAM_Use(), which also
+  *			 writes into the used bytes as malloc() and the pushes would do.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include "host_model.h"
+
+/*---------------------------------- Global Variables ----------------------------------*/
+static uint8_t gHostSRAM[HOST_SRAM_SIZE];
+static uint16_t gHostSRAM_Heap = 0;			// bytes below the break, 0 -> malloc() never called
+static uint16_t gHostSRAM_Stack = 0;		// bytes pushed below RAMEND
+
+/*---------------------------------- Function and Hooks ----------------------------------*/
+
+/*
+ * @name	HostSRAM_HeapStart
+ * @brief	Address of __heap_start
+ */
+uint8_t* HostSRAM_HeapStart(void)
+{
+	return &gHostSRAM[0];
+}
+
+/*
+ * @name	HostSRAM_End
+ * @brief	Address of RAMEND, the last byte of the SRAM
+ */
+uint8_t* HostSRAM_End(void)
+{
+	return &gHostSRAM[HOST_SRAM_SIZE - 1];
+}
+
+/*
+ * @name	HostSRAM_StackPointer
+ * @brief	Value of SP: the next byte to be pushed
+ */
+uint8_t* HostSRAM_StackPointer(void)
+{
+	return &gHostSRAM[HOST_SRAM_SIZE - 1 - gHostSRAM_Stack];
+}
+
+/*
+ * @name	HostSRAM_Break
+ * @brief	Value of __brkval, NULL as long as the heap is not used
+ */
+uint8_t* HostSRAM_Break(void)
+{
+	return gHostSRAM_Heap ? &gHostSRAM[gHostSRAM_Heap] : NULL;
+}
+
+/*
+ * @name	HostSRAM_Use
+ * @brief	Sets the size of the heap and the depth of the stack
+ * @param	heap  - bytes below the break
+ *			stack - bytes below RAMEND
+ * @note	The used bytes are overwritten with 0x00. Bytes which are given back (smaller heap
+ *			or stack) keep their content, as on the target.
+ */
+void HostSRAM_Use(uint16_t heap, uint16_t stack)
+{
+	uint16_t i;
+
+	if(heap + stack > HOST_SRAM_SIZE)
+		return;
+
+	for(i = 0; i < heap; i++)
+		gHostSRAM[i] = 0x00;
+	for(i = 0; i < stack; i++)
+		gHostSRAM[HOST_SRAM_SIZE - 1 - i] = 0x00;
+
+	gHostSRAM_Heap = heap;
+	gHostSRAM_Stack = stack;
+}
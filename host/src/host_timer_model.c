@@ -0,0 +1,261 @@
+/**
+  ******************************************************************************
+  * @file    host_timer_model.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Host model of the Timer1 and Timer2 counters.
+  * @Note	 Once a clock source is selected in TCCR1B, TCNT1 counts at F_CPU divided
+  *			 by the prescalar, using the monotonic clock of the host. So the cycle
+  *			 counts measured on the host are the host execution time expressed in
+  *			 cycles of the target clock. Reading TCNT1L latches TCNT1H as on the target.
+  *			 TCNT2 counts the same way (TCCR2B). The compare matches of both timers which
+  *			 have passed are found whenever the model is accessed (counter read, OCRnx or
+  *			 TIFRn write, service), they set OCFnx and run TIMERn_COMPx_vect.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <time.h>
+#include <avr/interrupt.h>
+#include "host_model.h"
+
+/*---------------------------------- Global Variables ----------------------------------*/
+static uint8_t gTCNT1H_Latch = 0;
+static uint64_t gTimer1_Checked = 0;			// ticks of Timer1 upto which the compare matches are known
+static uint64_t gTimer2_Checked = 0;			// same for Timer2
+
+void TIMER1_COMPA_vect(void) __attribute__((weak));
+void TIMER1_COMPB_vect(void) __attribute__((weak));
+void TIMER2_COMPA_vect(void) __attribute__((weak));
+void TIMER2_COMPB_vect(void) __attribute__((weak));
+
+/*---------------------------------- Function and Hooks ----------------------------------*/
+
+/*
+ * @name	HostTimer_Cycles
+ * @brief	Current time of the host in cycles of the target clock (F_CPU)
+ */
+uint64_t HostTimer_Cycles(void)
+{
+	struct timespec now;
+	uint64_t nanoseconds;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	nanoseconds = (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+
+	return nanoseconds * (uint64_t)(F_CPU / 1000000UL) / 1000ULL;
+}
+
+/*
+ * @name	HostTimer_Count
+ * @brief	Counter value of Timer1 for the current time of the host
+ */
+static uint16_t HostTimer_Count(void)
+{
+	static const uint16_t prescalar[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+	uint16_t divider = prescalar[TCCR1B & 0x07];
+
+	if(divider == 0)
+		return ((uint16_t)TCNT1H << 8) | TCNT1L;	// stopped or external clock: counter does not move
+
+	return (uint16_t)(HostTimer_Cycles() / divider);
+}
+
+/*
+ * @name	HostTimer1_Ticks
+ * @brief	Ticks of Timer1 for the current time of the host, 0 when it is stopped
+ */
+static uint64_t HostTimer1_Ticks(void)
+{
+	static const uint16_t prescalar[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+	uint16_t divider = prescalar[TCCR1B & 0x07];
+
+	if(divider == 0)
+		return 0;
+
+	return HostTimer_Cycles() / divider;
+}
+
+/*
+ * @name	HostTimer1_Update
+ * @brief	Sets OCF1A/OCF1B for the compare matches since the last update
+ */
+static void HostTimer1_Update(void)
+{
+	uint64_t now = HostTimer1_Ticks();
+	uint32_t next;
+
+	if(now == 0)
+		return;
+	if((gTimer1_Checked != 0) && (now > gTimer1_Checked))
+	{
+		next = (uint16_t)((((uint16_t)OCR1AH << 8) | OCR1AL) - (uint16_t)gTimer1_Checked);
+		if((now - gTimer1_Checked) >= (next ? next : 65536))
+			TIFR1 |= 0x02;
+		next = (uint16_t)((((uint16_t)OCR1BH << 8) | OCR1BL) - (uint16_t)gTimer1_Checked);
+		if((now - gTimer1_Checked) >= (next ? next : 65536))
+			TIFR1 |= 0x04;
+	}
+	gTimer1_Checked = now;
+}
+
+/*
+ * @name	HostTimer2_Ticks
+ * @brief	Ticks of Timer2 for the current time of the host, 0 when it is stopped
+ */
+static uint64_t HostTimer2_Ticks(void)
+{
+	static const uint16_t prescalar[8] = { 0, 1, 8, 32, 64, 128, 256, 1024 };
+	uint16_t divider = prescalar[TCCR2B & 0x07];
+
+	if(divider == 0)
+		return 0;
+
+	return HostTimer_Cycles() / divider;
+}
+
+/*
+ * @name	HostTimer2_Matched
+ * @brief	Checks whether TCNT2 has left the compare value in (from, to]
+ * @note	OCF2x is set at the timer clock after TCNT2 equals OCR2x, so a compare written
+ *			equal to TCNT2 matches at the next tick, not one turn later.
+ */
+static uint8_t HostTimer2_Matched(uint8_t compare, uint64_t from, uint64_t to)
+{
+	uint8_t next = compare - (uint8_t)from;
+
+	return ((to - from) > next) ? 0x01 : 0x00;
+}
+
+/*
+ * @name	HostTimer2_Update
+ * @brief	Sets OCF2A/OCF2B for the compare matches since the last update
+ */
+static void HostTimer2_Update(void)
+{
+	uint64_t now = HostTimer2_Ticks();
+
+	if(now == 0)
+		return;
+	if((gTimer2_Checked != 0) && (now > gTimer2_Checked))
+	{
+		if(HostTimer2_Matched(OCR2A, gTimer2_Checked, now))
+			TIFR2 |= 0x02;
+		if(HostTimer2_Matched(OCR2B, gTimer2_Checked, now))
+			TIFR2 |= 0x04;
+	}
+	gTimer2_Checked = now;
+}
+
+/*
+ * @name	HostTimer_ReadRegister
+ * @brief	Read access to TCNT1L/TCNT1H and TCNT2
+ * @retval	0x01 - register belongs to the model and *value is updated, 0x00 - not a timer register
+ */
+uint8_t HostTimer_ReadRegister(volatile uint8_t *reg, uint8_t *value)
+{
+	uint16_t count;
+
+	if(reg == &TCNT1L)
+	{
+		HostTimer1_Update();
+		count = HostTimer_Count();
+		gTCNT1H_Latch = count >> 8;
+		*value = count & 0xFF;
+		return 0x01;
+	}
+	if(reg == &TCNT1H)
+	{
+		*value = gTCNT1H_Latch;
+		return 0x01;
+	}
+	if(reg == &TIFR1)
+	{
+		HostTimer1_Update();
+		*value = TIFR1;
+		return 0x01;
+	}
+	if(reg == &TCNT2)
+	{
+		HostTimer2_Update();
+		*value = (TCCR2B & 0x07) ? (uint8_t)gTimer2_Checked : TCNT2;
+		return 0x01;
+	}
+	if(reg == &TIFR2)
+	{
+		HostTimer2_Update();
+		*value = TIFR2;
+		return 0x01;
+	}
+	return 0x00;
+}
+
+/*
+ * @name	HostTimer_WriteRegister
+ * @brief	Write access to OCR1A/OCR1B, OCR2A/OCR2B and TIFR1/TIFR2 (flags are cleared by writing one)
+ * @retval	0x01 - register belongs to the model, 0x00 - not a timer register
+ */
+uint8_t HostTimer_WriteRegister(volatile uint8_t *reg, uint8_t value)
+{
+	if((reg == &OCR1AH) || (reg == &OCR1AL) || (reg == &OCR1BH) || (reg == &OCR1BL) || (reg == &TIFR1))
+	{
+		HostTimer1_Update();
+		if(reg == &TIFR1)
+			TIFR1 &= ~value;
+		else
+			*reg = value;
+		return 0x01;
+	}
+	if((reg != &OCR2A) && (reg != &OCR2B) && (reg != &TIFR2))
+		return 0x00;
+
+	HostTimer2_Update();						// matches before the write belong to the old value
+	if(reg == &TIFR2)
+		TIFR2 &= ~value;
+	else
+		*reg = value;
+	return 0x01;
+}
+
+/*
+ * @name	HostTimer_ServiceInterrupts
+ * @brief	Runs TIMER1_COMPx_vect/TIMER2_COMPx_vect for the enabled compare matches
+ * @retval	0x01 - an ISR has been executed, 0x00 - nothing pending
+ */
+uint8_t HostTimer_ServiceInterrupts(void)
+{
+	uint8_t pending = 0x00;
+
+	HostTimer1_Update();
+	HostTimer2_Update();
+	if(!(SREG & 0x80))
+		return 0x00;
+
+	if((TIFR1 & TIMSK1 & 0x02) && TIMER1_COMPA_vect)
+	{
+		TIFR1 &= ~0x02;							// cleared by the hardware when the ISR is executed
+		cli();	TIMER1_COMPA_vect();	sei();
+		pending = 0x01;
+	}
+	if((TIFR1 & TIMSK1 & 0x04) && TIMER1_COMPB_vect)
+	{
+		TIFR1 &= ~0x04;
+		cli();	TIMER1_COMPB_vect();	sei();
+		pending = 0x01;
+	}
+
+	if((TIFR2 & TIMSK2 & 0x02) && TIMER2_COMPA_vect)
+	{
+		TIFR2 &= ~0x02;							// cleared by the hardware when the ISR is executed
+		cli();	TIMER2_COMPA_vect();	sei();
+		pending = 0x01;
+	}
+	if((TIFR2 & TIMSK2 & 0x04) && TIMER2_COMPB_vect)
+	{
+		TIFR2 &= ~0x04;
+		cli();	TIMER2_COMPB_vect();	sei();
+		pending = 0x01;
+	}
+	return pending;
+}
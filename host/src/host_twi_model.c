@@ -0,0 +1,149 @@
+/**
+  ******************************************************************************
+  * @file    host_twi_model.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Host model of the TWI (I2C) peripheral.
+  * @Note	 The model does not simulate the bus, it replays a list of events given
+  *			 by HostTWI_Load(). An operation is started when the driver writes TWCR
+  *			 with TWINT (clearing the flag) or with TWSTA while the bus is idle. The
+  *			 operation completes in the next HostTWI_ServiceInterrupts(): the next
+  *			 event is copied into TWSR (and TWDR for the data received states),
+  *			 TWINT is set and TWI_vect is executed if TWIE is set.
+  *			 The value of TWDR at the start of every operation is recorded so that
+  *			 the transmitted address and data can be checked with HostTWI_Transmitted().
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <avr/interrupt.h>
+#include "host_model.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define TWINT_BIT			0x80
+#define TWSTA_BIT			0x20
+#define TWEN_BIT			0x04
+#define TWIE_BIT			0x01
+#define TX_LOG_SIZE			256
+
+#define MAX_ISR_CALLS		1024
+
+/*---------------------------------- Global Variables ----------------------------------*/
+static const HostTWI_EventType *gEvents = NULL;
+static uint16_t gEventCount = 0;
+static uint16_t gEventIndex = 0;
+static uint8_t gBusy = 0;
+
+static uint8_t gTxLog[TX_LOG_SIZE];
+static uint16_t gTxHead = 0;
+static uint16_t gTxTail = 0;
+
+void TWI_vect(void) __attribute__((weak));
+
+/*---------------------------------- Function and Hooks ----------------------------------*/
+
+/*
+ * @name	HostTWI_Load
+ * @brief	Sets the list of bus events which will be replayed
+ * @param	events - list of TWSR/TWDR values, one per bus operation
+ *			count  - number of events
+ */
+void HostTWI_Load(const HostTWI_EventType *events, uint16_t count)
+{
+	gEvents = events;
+	gEventCount = count;
+	gEventIndex = 0;
+	gBusy = 0;
+	gTxHead = gTxTail = 0;
+	TWSR = 0xF8;	// No relevant state information
+}
+
+/*
+ * @name	HostTWI_Remaining
+ * @brief	Number of events not yet replayed
+ */
+uint16_t HostTWI_Remaining(void)
+{
+	return gEventCount - gEventIndex;
+}
+
+/*
+ * @name	HostTWI_Transmitted
+ * @brief	Copies the recorded TWDR values (address and data bytes sent on the bus)
+ * @retval	Number of bytes copied
+ */
+uint16_t HostTWI_Transmitted(uint8_t *data, uint16_t length)
+{
+	uint16_t count = 0;
+
+	while((gTxTail != gTxHead) && (count < length))
+	{
+		data[count++] = gTxLog[gTxTail % TX_LOG_SIZE];
+		gTxTail++;
+	}
+	return count;
+}
+
+/*
+ * @name	HostTWI_WriteRegister
+ * @brief	Write access to TWCR
+ * @retval	0x01 - TWCR has been handled by the model, 0x00 - not a TWI register of the model
+ */
+uint8_t HostTWI_WriteRegister(volatile uint8_t *reg, uint8_t value)
+{
+	uint8_t start;
+
+	if(reg != &TWCR)
+		return 0x00;
+
+	//Writing one to TWINT clears the flag and starts the next operation
+	start = ((value & TWINT_BIT) && (TWCR & TWINT_BIT)) || ((value & TWSTA_BIT) && !(TWCR & TWINT_BIT) && !gBusy);
+	TWCR = value & (uint8_t)~TWINT_BIT;
+
+	if(start && (value & TWEN_BIT) && (gEventIndex < gEventCount))
+	{
+		gTxLog[gTxHead % TX_LOG_SIZE] = TWDR;
+		gTxHead++;
+		gBusy = 1;
+	}
+	return 0x01;
+}
+
+/*
+ * @name	HostTWI_ServiceInterrupts
+ * @brief	Completes the pending bus operations and runs TWI_vect
+ * @retval	0x01 - at least one operation has been completed, 0x00 - bus is idle
+ */
+uint8_t HostTWI_ServiceInterrupts(void)
+{
+	uint8_t executed = 0;
+	uint16_t calls;
+
+	for(calls = 0; (calls < MAX_ISR_CALLS) && gBusy; calls++)
+	{
+		const HostTWI_EventType *event = &gEvents[gEventIndex++];
+
+		gBusy = 0;
+		TWSR = event->Status;
+		switch(event->Status)
+		{
+			case 0x50: case 0x58:	//Master receive data
+			case 0x80: case 0x88:	//Slave receive data
+			case 0x90: case 0x98:	//General call data
+				TWDR = event->Data;
+				break;
+			default:
+				break;
+		}
+		TWCR |= TWINT_BIT;
+		executed = 1;
+
+		if((TWCR & TWIE_BIT) && (SREG & 0x80) && TWI_vect)
+		{
+			cli();	TWI_vect();	sei();
+		}
+	}
+	return executed;
+}
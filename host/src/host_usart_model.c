@@ -0,0 +1,369 @@
+/**
+  ******************************************************************************
+  * @file    host_usart_model.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Host model of USART0 and USART1.
+  * @Note	 + Transmit is instantaneous: a write to UDRn is stored in the transmit
+  *			   FIFO, UDREn stays set. TXCn is set when the interrupts are serviced (the byte has been
+  *			   shifted out), so that clearing TXCn after writing UDRn behaves as on the target.
+  *			   While TXCIEn is cleared, TXCn is also set when UCSRnA is polled.
+  *			 + RXCn is set as long as the receive FIFO is not empty. RXB8n (UCSRnB)
+  *			   and FEn/DORn/UPEn (UCSRnA) describe the word at the head of the FIFO,
+  *			   reading UDRn removes it.
+  *			 + Bits of UCSRnB/UCSRnC/UBRRn are stored as they are written.
+  *			 + Multi-processor mode (MPCMn set): data frames (bit 8 = 0) at the head of the receive
+  *			   FIFO are dropped before they are seen, like the receiver ignores them.
+  *			 + Receiver disabled (RXENn = 0): received words are lost. HostUSART_Loopback() echoes
+  *			   the transmitted bytes to the receiver like a half duplex bus.
+  *			 + Master SPI mode (UMSELn = 11 in UCSRnC): every byte written to UDRn clocks
+  *			   in one byte, taken from the MISO queue (HostUSART_Miso()) or 0xFF.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <avr/interrupt.h>
+#include "host_model.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define RXC_FLAG		0x80
+#define TXC_FLAG		0x40
+#define UDRE_FLAG		0x20
+#define ERROR_FLAGS		0x1C	// FEn, DORn and UPEn
+#define RXB8_BIT		0x02
+#define TXB8_BIT		0x01
+#define RXCIE_BIT		0x80
+#define TXCIE_BIT		0x40
+#define UDRIE_BIT		0x20
+#define RXEN_BIT		0x10
+
+#define MPCM_BIT		0x01
+
+#define MSPIM_MODE		0xC0	// UMSELn1:0 of UCSRnC
+
+#define MAX_ISR_CALLS	(HOST_USART_FIFO_SIZE * 4)	// protection against an ISR which never clears its source
+
+/* Typedefs and structure ----------------------------------------------------*/
+typedef struct
+{
+	volatile uint8_t	*RegA;
+	volatile uint8_t	*RegB;
+	volatile uint8_t	*Data;
+	volatile uint8_t	*RegC;
+	uint16_t			Rx[HOST_USART_FIFO_SIZE];
+	uint16_t			RxHead;
+	uint16_t			RxTail;
+	uint16_t			Tx[HOST_USART_FIFO_SIZE];
+	uint16_t			TxHead;
+	uint16_t			TxTail;
+	uint8_t				Shifting;		// TXCn is set at the next service
+	uint8_t				Loopback;		// transmitted bytes are received (half duplex bus)
+	uint8_t				Miso[HOST_USART_FIFO_SIZE];
+	uint16_t			MisoHead;
+	uint16_t			MisoTail;
+}HostUSART_ModelType;
+
+/*---------------------------------- Global Variables ----------------------------------*/
+static HostUSART_ModelType gHostUSART[2] =
+{
+	{ .RegA = &UCSR0A, .RegB = &UCSR0B, .Data = &UDR0, .RegC = &UCSR0C },
+	{ .RegA = &UCSR1A, .RegB = &UCSR1B, .Data = &UDR1, .RegC = &UCSR1C },
+};
+
+//ISRs of the drivers, weak so that the model links without the USART driver
+void USART0_RX_vect(void) __attribute__((weak));
+void USART1_RX_vect(void) __attribute__((weak));
+void USART0_UDRE_vect(void) __attribute__((weak));
+void USART1_UDRE_vect(void) __attribute__((weak));
+void USART0_TX_vect(void) __attribute__((weak));
+void USART1_TX_vect(void) __attribute__((weak));
+
+/*---------------------------------- Function and Hooks ----------------------------------*/
+
+/*
+ * @name	HostUSART_Find
+ * @brief	Returns the model which owns the register, NULL if it is not a USART register
+ */
+static HostUSART_ModelType* HostUSART_Find(volatile uint8_t *reg)
+{
+	uint8_t port;
+
+	for(port = 0; port < 2; port++)
+	{
+		if((reg == gHostUSART[port].RegA) || (reg == gHostUSART[port].RegB) || (reg == gHostUSART[port].Data))
+			return &gHostUSART[port];
+	}
+	return NULL;
+}
+
+/*
+ * @name	HostUSART_FilterFrames
+ * @brief	Drops the data frames at the head of the receive FIFO while MPCMn is set
+ * @note	The frames are filtered between the ISRs and when UDRn/UCSRnB are read instead of when they are
+ *			received, so a packet given at once with HostUSART_Receive() behaves as if the ISR was fast enough.
+ */
+static void HostUSART_FilterFrames(HostUSART_ModelType *usart)
+{
+	while((*usart->RegA & MPCM_BIT) && (usart->RxTail != usart->RxHead) &&
+		  !(usart->Rx[usart->RxTail & (HOST_USART_FIFO_SIZE - 1)] & 0x0100))
+	{
+		usart->RxTail++;
+	}
+}
+
+/*
+ * @name	HostUSART_Reset
+ * @brief	Empties both FIFOs of the port and sets the registers to their reset value
+ * @param	port - USART0 or USART1
+ */
+void HostUSART_Reset(uint8_t port)
+{
+	HostUSART_ModelType *usart = &gHostUSART[port & 0x01];
+
+	usart->RxHead = usart->RxTail = 0;
+	usart->TxHead = usart->TxTail = 0;
+	usart->MisoHead = usart->MisoTail = 0;
+	usart->Shifting = 0;
+	usart->Loopback = 0;
+	*usart->RegA = UDRE_FLAG;
+	*usart->RegB = 0x00;
+}
+
+/*
+ * @name	HostUSART_ReceiveWord
+ * @brief	Puts one word on the receive line of the port
+ * @param	port - USART0 or USART1
+ *			word - data (9 bits) with the optional HOST_USART_RX_xxx error bits
+ * @note	The word is lost when the receiver is disabled (RXENn = 0), as on the line
+ * @retval	0x00 - Succeed, 0x01 - receive FIFO is full
+ */
+uint8_t HostUSART_ReceiveWord(uint8_t port, uint16_t word)
+{
+	HostUSART_ModelType *usart = &gHostUSART[port & 0x01];
+
+	if(!(*usart->RegB & RXEN_BIT))
+		return 0x00;
+	if((uint16_t)(usart->RxHead - usart->RxTail) >= HOST_USART_FIFO_SIZE)
+		return 0x01;
+
+	usart->Rx[usart->RxHead & (HOST_USART_FIFO_SIZE - 1)] = word;
+	usart->RxHead++;
+	return 0x00;
+}
+
+/*
+ * @name	HostUSART_Receive
+ * @brief	Puts the bytes on the receive line of the port
+ * @retval	Number of bytes accepted by the receive FIFO
+ */
+uint16_t HostUSART_Receive(uint8_t port, const uint8_t *data, uint16_t length)
+{
+	uint16_t count;
+
+	for(count = 0; count < length; count++)
+	{
+		if(HostUSART_ReceiveWord(port, data[count]))
+			break;
+	}
+	return count;
+}
+
+/*
+ * @name	HostUSART_Loopback
+ * @brief	Connects the transmitter to the receiver of the port, like the local echo of a RS-485 bus
+ * @param	port   - USART0 or USART1
+ *			enable - 1 to receive every transmitted byte, 0 to disconnect
+ */
+void HostUSART_Loopback(uint8_t port, uint8_t enable)
+{
+	gHostUSART[port & 0x01].Loopback = enable;
+}
+
+/*
+ * @name	HostUSART_Miso
+ * @brief	Bytes returned by the SPI slave in Master SPI mode, one per transmitted byte
+ * @retval	Number of bytes accepted by the MISO queue
+ */
+uint16_t HostUSART_Miso(uint8_t port, const uint8_t *data, uint16_t length)
+{
+	HostUSART_ModelType *usart = &gHostUSART[port & 0x01];
+	uint16_t count;
+
+	for(count = 0; (count < length) && ((uint16_t)(usart->MisoHead - usart->MisoTail) < HOST_USART_FIFO_SIZE); count++)
+	{
+		usart->Miso[usart->MisoHead & (HOST_USART_FIFO_SIZE - 1)] = data[count];
+		usart->MisoHead++;
+	}
+	return count;
+}
+
+/*
+ * @name	HostUSART_Transmitted
+ * @brief	Removes up to length bytes from the transmit FIFO of the port
+ * @retval	Number of bytes copied to data
+ */
+uint16_t HostUSART_Transmitted(uint8_t port, uint8_t *data, uint16_t length)
+{
+	HostUSART_ModelType *usart = &gHostUSART[port & 0x01];
+	uint16_t count = 0;
+
+	while((usart->TxTail != usart->TxHead) && (count < length))
+	{
+		data[count++] = usart->Tx[usart->TxTail & (HOST_USART_FIFO_SIZE - 1)] & 0xFF;
+		usart->TxTail++;
+	}
+	return count;
+}
+
+/*
+ * @name	HostUSART_TransmittedCount
+ * @brief	Number of bytes waiting in the transmit FIFO of the port
+ */
+uint16_t HostUSART_TransmittedCount(uint8_t port)
+{
+	return (uint16_t)(gHostUSART[port & 0x01].TxHead - gHostUSART[port & 0x01].TxTail);
+}
+
+/*
+ * @name	HostUSART_ReadRegister
+ * @brief	Read access to UCSRnA, UCSRnB or UDRn
+ * @retval	0x01 - register belongs to the model and *value is updated, 0x00 - not a USART register
+ */
+uint8_t HostUSART_ReadRegister(volatile uint8_t *reg, uint8_t *value)
+{
+	HostUSART_ModelType *usart = HostUSART_Find(reg);
+	uint16_t head;
+
+	if(usart == NULL)
+		return 0x00;
+
+	//UCSRnA is also read by the ISR before it updates MPCMn, so the filter is not applied to it
+	if(reg != usart->RegA)
+		HostUSART_FilterFrames(usart);
+	head = (usart->RxTail != usart->RxHead) ? usart->Rx[usart->RxTail & (HOST_USART_FIFO_SIZE - 1)] : 0x0000;
+
+	if(reg == usart->RegA)
+	{
+		//Without TXCIEn the program polls TXCn: the byte has been shifted out meanwhile
+		if(usart->Shifting && !(*usart->RegB & TXCIE_BIT))
+		{
+			usart->Shifting = 0;
+			*reg |= TXC_FLAG;
+		}
+		*value = (*reg & (uint8_t)~(RXC_FLAG | ERROR_FLAGS)) | UDRE_FLAG;
+		if((usart->RxTail != usart->RxHead) && ((head & 0x0100) || !(*reg & MPCM_BIT)))
+		{
+			*value |= RXC_FLAG;
+			*value |= (head & HOST_USART_RX_FRAME_ERROR) ? 0x10 : 0x00;
+			*value |= (head & HOST_USART_RX_OVERRUN) ? 0x08 : 0x00;
+			*value |= (head & HOST_USART_RX_PARITY_ERROR) ? 0x04 : 0x00;
+		}
+	}
+	else if(reg == usart->RegB)
+	{
+		*value = (*reg & (uint8_t)~RXB8_BIT) | ((head & 0x0100) ? RXB8_BIT : 0x00);
+	}
+	else
+	{
+		*value = head & 0xFF;
+		if(usart->RxTail != usart->RxHead)
+			usart->RxTail++;
+	}
+	return 0x01;
+}
+
+/*
+ * @name	HostUSART_WriteRegister
+ * @brief	Write access to UCSRnA, UCSRnB or UDRn
+ * @retval	0x01 - register belongs to the model, 0x00 - not a USART register
+ */
+uint8_t HostUSART_WriteRegister(volatile uint8_t *reg, uint8_t value)
+{
+	HostUSART_ModelType *usart = HostUSART_Find(reg);
+	uint8_t port;
+
+	if(usart == NULL)
+		return 0x00;
+	port = (usart == &gHostUSART[0]) ? 0 : 1;
+
+	if(reg == usart->RegA)
+	{
+		//TXCn is cleared by writing one to it, RXCn/UDREn/errors are read only
+		*reg = (*reg & (uint8_t)~(0x03 | ((value & TXC_FLAG) ? TXC_FLAG : 0x00))) | (value & 0x03);
+	}
+	else if(reg == usart->RegB)
+	{
+		*reg = value;
+	}
+	else
+	{
+		if((uint16_t)(usart->TxHead - usart->TxTail) >= HOST_USART_FIFO_SIZE)
+			usart->TxTail++;	// FIFO is full: oldest byte is lost, the latest output is kept
+		usart->Tx[usart->TxHead & (HOST_USART_FIFO_SIZE - 1)] = value | ((*usart->RegB & TXB8_BIT) ? 0x0100 : 0x0000);
+		usart->TxHead++;
+		usart->Shifting = 1;
+		if(usart->Loopback)
+			HostUSART_ReceiveWord(port, usart->Tx[(usart->TxHead - 1) & (HOST_USART_FIFO_SIZE - 1)]);
+
+		if((*usart->RegC & MSPIM_MODE) == MSPIM_MODE)
+		{
+			uint8_t miso = 0xFF;
+
+			if(usart->MisoTail != usart->MisoHead)
+				miso = usart->Miso[usart->MisoTail++ & (HOST_USART_FIFO_SIZE - 1)];
+			HostUSART_ReceiveWord(port, miso);
+		}
+	}
+	return 0x01;
+}
+
+/*
+ * @name	HostUSART_ServiceInterrupts
+ * @brief	Runs the USART ISRs whose flag and enable bit are set
+ * @retval	0x01 - at least one ISR has been executed, 0x00 - nothing was pending
+ */
+uint8_t HostUSART_ServiceInterrupts(void)
+{
+	static void (* const rxISR[2])(void) = { USART0_RX_vect, USART1_RX_vect };
+	static void (* const udreISR[2])(void) = { USART0_UDRE_vect, USART1_UDRE_vect };
+	static void (* const txISR[2])(void) = { USART0_TX_vect, USART1_TX_vect };
+	uint8_t executed = 0;
+	uint16_t calls;
+	uint8_t port;
+
+	for(port = 0; port < 2; port++)
+	{
+		HostUSART_ModelType *usart = &gHostUSART[port];
+
+		for(calls = 0; calls < MAX_ISR_CALLS && (SREG & 0x80); calls++)
+		{
+			HostUSART_FilterFrames(usart);
+			if(usart->Shifting)
+			{
+				usart->Shifting = 0;
+				*usart->RegA |= TXC_FLAG;
+			}
+			if((*usart->RegB & RXCIE_BIT) && (usart->RxTail != usart->RxHead) && rxISR[port])
+			{
+				cli();	rxISR[port]();	sei();
+			}
+			else if((*usart->RegB & UDRIE_BIT) && udreISR[port])
+			{
+				cli();	udreISR[port]();	sei();
+			}
+			else if((*usart->RegB & TXCIE_BIT) && (*usart->RegA & TXC_FLAG) && txISR[port])
+			{
+				*usart->RegA &= (uint8_t)~TXC_FLAG;		//cleared by hardware when the ISR is executed
+				cli();	txISR[port]();	sei();
+			}
+			else
+			{
+				break;
+			}
+			executed = 1;
+		}
+	}
+	return executed;
+}
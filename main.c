@@ -12,14 +12,115 @@ Requirement:
 #include "main.h"
 
 
-//unsigned char c = '0';
+#if (USE_USART_BAREMETAL > 0)
+unsigned char c = '0';
+#endif //USE_USART_BAREMETAL
 uint16_t ch;
 uint8_t byte;
 uint8_t i2c_error;
 uint8_t i2c_state = 0x00;
 uint32_t address;       //Always use variables with _t in embedded word!
+
+#if (INCLUDE_SCHEDULER > 0)
+/******************************************************************
+                SCHEDULER TASKS
+*******************************************************************/
+volatile uint16_t gEchoChar;    // mailbox between the USART receive hook and the echo task
+volatile uint8_t gI2CStatus;    // last status served by the I2C ISR
+volatile uint8_t gButtonPins;   // PINB when the button changed
+
+void USART_ReceivedEvent(uint8_t usart, uint16_t data)
+{
+    (void)usart;
+    gEchoChar = data;
+    Scheduler_Post(TASK_USART_ECHO);
+}
+
+void I2C_Event(uint8_t status)
+{
+    gI2CStatus = status;
+    Scheduler_Post(TASK_I2C_EVENT);
+}
+
+void GPIO_ButtonEvent(ports port, uint8_t pinValues)
+{
+    (void)port;
+    gButtonPins = pinValues;
+    Scheduler_Post(TASK_GPIO_BUTTON);
+}
+
+void Task_USARTEcho(void)
+{
+#if (INCLUDE_MEMORY_USAGE > 0)
+    if(gEchoChar == MEMORY_DUMP_KEY)
+    {
+        Memory_Dump(Print_GetConsole());
+        return;
+    }
+#endif //INCLUDE_MEMORY_USAGE
+    USART_PutChar(gEchoChar);
+}
+
+void Task_I2CEvent(void)
+{
+    if(I2C_GetCommunicationError())
+        print("\n\rI2C error %x (status %x)", (uint32_t)I2C_GetCommunicationError(), (uint32_t)gI2CStatus);
+}
+
+void Task_GPIOButton(void)
+{
+    print("\n\rButton is %s", (gButtonPins & PIN_ONE) ? "released" : "pressed");
+}
+
+void Task_GPIOBlink(void)
+{
+    GPIO_Write(GPIOB, PIN_ZERO, GPIO_Read(GPIOB, PIN_ZERO) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+    Scheduler_PostDelayed(TASK_GPIO_BLINK, GPIO_BLINK_PERIOD_MS);   // Instead of _delay_ms(), CPU sleeps in between
+}
+#endif //INCLUDE_SCHEDULER
+
 int main(void)
 {
+#if (INCLUDE_SCHEDULER > 0)
+    /******************************************************************
+                    SCHEDULER: USART, I2C and GPIO in one image
+    *******************************************************************/
+    USART_StructureType USART_Scheduler;
+
+    USART_Scheduler.USART_BaudRate = 19200;
+    USART_Scheduler.USART_Communication = BOTH;
+    USART_Scheduler.USART_DataBits = EIGHT;
+    USART_Scheduler.USART_Modes = ASYNCHRONOUS;
+    USART_Scheduler.USART_Parity = NOPARITY;
+    USART_Scheduler.USART_StopBits = ONESTOPBIT;
+    USARTInit(USART1, USART_Scheduler);
+
+    Scheduler_Init();
+    Scheduler_AddTask(TASK_USART_ECHO, Task_USARTEcho);
+    Scheduler_AddTask(TASK_I2C_EVENT, Task_I2CEvent);
+    Scheduler_AddTask(TASK_GPIO_BUTTON, Task_GPIOButton);
+    Scheduler_AddTask(TASK_GPIO_BLINK, Task_GPIOBlink);
+
+    USART_RegisterReceiveHook(USART1, USART_ReceivedEvent);
+    USART_EnableInterrupt(RECEIVE);
+    I2C_RegisterEventHook(I2C_Event);
+
+    GPIO_Config(GPIOB, PIN_ZERO, OUTPUT);   // LED
+    GPIO_Config(GPIOB, PIN_ONE, INPUT);     // Button, pull-up enabled
+    GPIO_RegisterPinChangeHook(GPIOB, PIN_ONE, GPIO_ButtonEvent);
+
+#if (INCLUDE_TRACE > 0)
+    Trace_Init();
+    Trace_Dump(Print_GetConsole());     // records of the run before the reset
+#endif //INCLUDE_TRACE
+#if (INCLUDE_MEMORY_USAGE > 0)
+    Memory_Init(NULL);
+#endif //INCLUDE_MEMORY_USAGE
+    print("\n\rScheduler is running");
+    Scheduler_Post(TASK_GPIO_BLINK);
+    Scheduler_Run();
+#endif //INCLUDE_SCHEDULER
+
     /******************************************************************
                     GPIO TEST
     *******************************************************************/
@@ -89,7 +190,22 @@ int main(void)
 
     USARTInit(USART1, USART_Config);
     //USART_EnableInterrupt(RECEIVE);
+#if (INCLUDE_BAUD_NEGOTIATION > 0)
+    BaudNegotiate_Respond(USART1, &USART_Config, BAUD_NEGOTIATION_MAX_RATE, BAUD_NEGOTIATION_WINDOW_MS);
+    print("\n\rUSART is Configured at Baud Rate %d\n\r", (int32_t)USART_Config.USART_BaudRate);
+#else
     print("\n\rUSART is Configured at Baud Rate 19200\n\r");
+#endif //INCLUDE_BAUD_NEGOTIATION
+#if (INCLUDE_PROFILE > 0)
+    Profile_Init();
+#endif //INCLUDE_PROFILE
+#if (INCLUDE_TRACE > 0)
+    Trace_Init();
+    Trace_Dump(Print_GetConsole());     // records of the run before the reset
+#endif //INCLUDE_TRACE
+#if (INCLUDE_MEMORY_USAGE > 0)
+    Memory_Init(NULL);
+#endif //INCLUDE_MEMORY_USAGE
 
     /*while(1)
     {
@@ -214,8 +330,7 @@ int main(void)
 		print("\n\rConfigured the I2C as Slave\n");
 		I2C_TransmitBufferFill("BUG");		// Incase if slave is requested to transmit!
 
-		while(I2C_GetSlaveDirection() == 0xFF)
-			; //Wait until any master address this as slave
+		I2C_WaitForAddress();	//Sleep in power-down until any master address this as slave
 
 		if(I2C_GetSlaveDirection() != 0x01)	//receive mode
 		{
@@ -234,9 +349,16 @@ int main(void)
 		}
     }*/
 
+#if (INCLUDE_PROFILE > 0)
+    Profile_Dump();
+#endif //INCLUDE_PROFILE
+#if (INCLUDE_MEMORY_USAGE > 0)
+    Memory_Dump(Print_GetConsole());
+#endif //INCLUDE_MEMORY_USAGE
     while(1)
     {
-
+        cli();
+        Power_Sleep(SLEEP_MODE_IDLE);   // Nothing left to do, the ISRs keep on serving the USART and I2C
     }
     #endif //USE_I2C_DRIVER
     return 0;
@@ -22,6 +22,12 @@
 #include "printf_code.h"
 #include "scanf_code.h"
 #include "atmega644p_i2c.h"
+#include "profile.h"
+#include "trace.h"
+#include "memory_usage.h"
+#include "power.h"
+#include "scheduler.h"
+#include "baud_negotiate.h"
 
 /*******************************************************************************
     GPIO #defines
@@ -53,6 +59,14 @@
 #define USE_USART_DRIVER 1
 #endif // USE_USART_DRIVER
 
+//Runtime baud rate negotiation after reset (see common/baud_negotiate.h), the link starts at 19200
+#ifndef INCLUDE_BAUD_NEGOTIATION
+#define INCLUDE_BAUD_NEGOTIATION 0
+#endif // INCLUDE_BAUD_NEGOTIATION
+
+#define BAUD_NEGOTIATION_MAX_RATE   1000000     // highest rate accepted from the tool
+#define BAUD_NEGOTIATION_WINDOW_MS  500         // time the tool has to propose after reset
+
 /*******************************************************************************
     I2C #defines
 *******************************************************************************/
@@ -67,3 +81,41 @@
 #ifndef USE_I2C_DRIVER
 #define USE_I2C_DRIVER 1
 #endif // USE_I2C_DRIVER
+
+/*******************************************************************************
+    Profiling #defines (Timer1 cycle counter, see common/profile.h)
+*******************************************************************************/
+#ifndef INCLUDE_PROFILE
+#define INCLUDE_PROFILE 0
+#endif // INCLUDE_PROFILE
+
+/*******************************************************************************
+    Trace #defines (post-mortem ring in .noinit, see common/trace.h)
+*******************************************************************************/
+#ifndef INCLUDE_TRACE
+#define INCLUDE_TRACE 0
+#endif // INCLUDE_TRACE
+
+/*******************************************************************************
+    SRAM usage #defines (stack/heap high-water marks, see common/memory_usage.h)
+*******************************************************************************/
+#ifndef INCLUDE_MEMORY_USAGE
+#define INCLUDE_MEMORY_USAGE 0
+#endif // INCLUDE_MEMORY_USAGE
+
+#define MEMORY_DUMP_KEY     '?'     // received by the echo task -> Memory_Dump()
+
+/*******************************************************************************
+    Scheduler #defines (one image serving USART, I2C and GPIO, see common/scheduler.h)
+*******************************************************************************/
+#ifndef INCLUDE_SCHEDULER
+#define INCLUDE_SCHEDULER 0
+#endif // INCLUDE_SCHEDULER
+
+//Priorities of the tasks, 0 is the highest one
+#define TASK_USART_ECHO     0
+#define TASK_I2C_EVENT      1
+#define TASK_GPIO_BUTTON    2
+#define TASK_GPIO_BLINK     3
+
+#define GPIO_BLINK_PERIOD_MS    500
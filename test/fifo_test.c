@@ -0,0 +1,258 @@
+/**
+  ******************************************************************************
+  * @file    fifo_test.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Host test of the FIFO of common/fifo.h
+  *			 + full/empty at the smallest and the largest size (1 and 128)
+  *			 + Head/Tail running past 255
+  *			 + PeekWrite/PeekRead upto and across the end of the buffer
+  *			 + partial Write/Read (more asked than room or elements)
+  *			 + Flush
+  * @note	 Built and run with "make test", the exit code is 1 when a check fails.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "fifo.h"
+#include "test.h"
+
+/* Defines -------------------------------------------------------------------*/
+FIFO_DEFINE(One, uint8_t, 1)
+FIFO_DEFINE(Big, uint16_t, 128)
+FIFO_DEFINE(Small, uint8_t, 8)
+FIFO_DEFINE(Mid, uint16_t, 16)
+
+/* Functions -----------------------------------------------------------------*/
+
+/*
+ * @name	Test_SizeOne
+ * @brief	Single slot: full after one Put, empty after one Get, 300 times so that Head/Tail wrap
+ */
+static void Test_SizeOne(void)
+{
+	One_FifoType fifo;
+	uint8_t value, *block;
+	unsigned i;
+
+	One_Init(&fifo);
+	TEST_CHECK(One_Count(&fifo) == 0);
+	TEST_CHECK(One_Free(&fifo) == 1);
+	TEST_CHECK(One_Get(&fifo, &value) == 0x01);
+	TEST_CHECK(One_PeekRead(&fifo, &block) == 0);
+
+	for(i = 0; i < 300; i++)
+	{
+		TEST_CHECK(One_Put(&fifo, (uint8_t)i) == 0x00);
+		TEST_CHECK(One_Put(&fifo, 0xEE) == 0x01);
+		TEST_CHECK(One_Count(&fifo) == 1);
+		TEST_CHECK(One_Free(&fifo) == 0);
+		TEST_CHECK(One_PeekWrite(&fifo, &block) == 0);
+		TEST_CHECK((One_Get(&fifo, &value) == 0x00) && (value == (uint8_t)i));
+		TEST_CHECK(One_Get(&fifo, &value) == 0x01);
+		TEST_CHECK(One_Count(&fifo) == 0);
+	}
+	TEST_CHECK(fifo.Head == (uint8_t)300);
+}
+
+/*
+ * @name	Test_SizeMax
+ * @brief	128 slots: all of them are used, the 129th Put fails, the order is kept
+ */
+static void Test_SizeMax(void)
+{
+	static Big_FifoType fifo;
+	uint16_t value, *block;
+	unsigned i, round;
+
+	Big_Init(&fifo);
+	for(round = 0; round < 3; round++)		// Head = 0, 128, 0 (after 256): the count is never 0 when full
+	{
+		for(i = 0; i < 128; i++)
+		{
+			TEST_CHECK(Big_Free(&fifo) == 128 - i);
+			TEST_CHECK(Big_Put(&fifo, (uint16_t)(0x1000 * round + i)) == 0x00);
+		}
+		TEST_CHECK(Big_Count(&fifo) == 128);
+		TEST_CHECK(Big_Free(&fifo) == 0);
+		TEST_CHECK(Big_Put(&fifo, 0xFFFF) == 0x01);
+		TEST_CHECK(Big_PeekWrite(&fifo, &block) == 0);
+		TEST_CHECK(Big_PeekRead(&fifo, &block) == 128);
+
+		for(i = 0; i < 128; i++)
+			TEST_CHECK((Big_Get(&fifo, &value) == 0x00) && (value == 0x1000 * round + i));
+		TEST_CHECK(Big_Count(&fifo) == 0);
+		TEST_CHECK(Big_Free(&fifo) == 128);
+		TEST_CHECK(Big_Get(&fifo, &value) == 0x01);
+	}
+}
+
+/*
+ * @name	Test_IndexWrap
+ * @brief	Head/Tail around 255 -> 0: count, full and the order across the 8 bit wrap
+ */
+static void Test_IndexWrap(void)
+{
+	Small_FifoType fifo;
+	uint8_t value, expected = 0, next = 0;
+	unsigned i, k;
+
+	Small_Init(&fifo);
+	fifo.Head = 0xFC;
+	fifo.Tail = 0xFC;
+	for(i = 0; i < 8; i++)
+		TEST_CHECK(Small_Put(&fifo, next++) == 0x00);
+	TEST_CHECK(fifo.Head == 0x04);
+	TEST_CHECK(Small_Count(&fifo) == 8);
+	TEST_CHECK(Small_Put(&fifo, 0xEE) == 0x01);
+	for(i = 0; i < 8; i++)
+		TEST_CHECK((Small_Get(&fifo, &value) == 0x00) && (value == expected++));
+	TEST_CHECK(Small_Get(&fifo, &value) == 0x01);
+
+	//Uneven producer/consumer steps over many wraps of the indexes
+	for(i = 0; i < 1000; i++)
+	{
+		for(k = 0; k < 1 + (i % 5); k++)
+		{
+			if(Small_Put(&fifo, next) == 0x00)
+				next++;
+		}
+		TEST_CHECK(Small_Count(&fifo) == (uint8_t)(next - expected));
+		for(k = 0; k < 1 + (i % 3); k++)
+		{
+			if(Small_Get(&fifo, &value) == 0x00)
+				TEST_CHECK(value == expected++);
+		}
+		TEST_CHECK(Small_Count(&fifo) + Small_Free(&fifo) == 8);
+	}
+}
+
+/*
+ * @name	Test_PeekWrap
+ * @brief	PeekWrite/PeekRead stop at the end of the buffer, the rest follows from Buffer[0]
+ */
+static void Test_PeekWrap(void)
+{
+	Mid_FifoType fifo;
+	uint16_t *block, value;
+	uint8_t i;
+
+	Mid_Init(&fifo);
+	for(i = 0; i < 10; i++)
+		Mid_Put(&fifo, 0);
+	for(i = 0; i < 10; i++)
+		Mid_Get(&fifo, &value);
+
+	//Producer: 6 slots upto the end, then 10 from the start
+	TEST_CHECK(Mid_PeekWrite(&fifo, &block) == 6);
+	TEST_CHECK(block == &fifo.Buffer[10]);
+	for(i = 0; i < 6; i++)
+		block[i] = 100 + i;
+	Mid_CommitWrite(&fifo, 6);
+	TEST_CHECK(Mid_PeekWrite(&fifo, &block) == 10);
+	TEST_CHECK(block == &fifo.Buffer[0]);
+	for(i = 0; i < 4; i++)
+		block[i] = 106 + i;
+	Mid_CommitWrite(&fifo, 4);
+	TEST_CHECK(Mid_Count(&fifo) == 10);
+	TEST_CHECK(Mid_PeekWrite(&fifo, &block) == 6);
+
+	//Consumer: 6 upto the end, then a partial commit of the 4 from the start
+	TEST_CHECK(Mid_PeekRead(&fifo, &block) == 6);
+	TEST_CHECK(block == &fifo.Buffer[10]);
+	for(i = 0; i < 6; i++)
+		TEST_CHECK(block[i] == 100 + i);
+	Mid_CommitRead(&fifo, 6);
+	TEST_CHECK(Mid_PeekRead(&fifo, &block) == 4);
+	TEST_CHECK((block == &fifo.Buffer[0]) && (block[0] == 106));
+	Mid_CommitRead(&fifo, 1);
+	TEST_CHECK(Mid_PeekRead(&fifo, &block) == 3);
+	TEST_CHECK(block[0] == 107);
+	TEST_CHECK((Mid_Get(&fifo, &value) == 0x00) && (value == 107));
+	Mid_CommitRead(&fifo, 2);
+	TEST_CHECK(Mid_PeekRead(&fifo, &block) == 0);
+	TEST_CHECK(Mid_Free(&fifo) == 16);
+}
+
+/*
+ * @name	Test_PartialCopy
+ * @brief	Write/Read copy what fits, also in two pieces across the end of the buffer
+ */
+static void Test_PartialCopy(void)
+{
+	Mid_FifoType fifo;
+	uint16_t data[40], out[40];
+	uint8_t i;
+
+	for(i = 0; i < 40; i++)
+		data[i] = 0x200 + i;
+
+	Mid_Init(&fifo);
+	TEST_CHECK(Mid_Write(&fifo, data, 20) == 16);
+	TEST_CHECK(Mid_Write(&fifo, data, 1) == 0);
+	TEST_CHECK(Mid_Read(&fifo, out, 5) == 5);
+	for(i = 0; i < 5; i++)
+		TEST_CHECK(out[i] == 0x200 + i);
+
+	//5 slots free, at the start of the buffer
+	TEST_CHECK(Mid_Write(&fifo, &data[20], 10) == 5);
+	TEST_CHECK(Mid_Read(&fifo, out, 40) == 16);
+	for(i = 0; i < 11; i++)
+		TEST_CHECK(out[i] == 0x205 + i);
+	for(i = 0; i < 5; i++)
+		TEST_CHECK(out[11 + i] == 0x214 + i);
+	TEST_CHECK(Mid_Read(&fifo, out, 1) == 0);
+	TEST_CHECK(Mid_Read(&fifo, out, 0) == 0);
+
+	//Tail at 5: a full write is copied in two pieces, a read of 3 leaves 13
+	TEST_CHECK(Mid_Write(&fifo, data, 16) == 16);
+	TEST_CHECK(Mid_Read(&fifo, out, 3) == 3);
+	TEST_CHECK(Mid_Count(&fifo) == 13);
+	TEST_CHECK(Mid_Read(&fifo, &out[3], 13) == 13);
+	for(i = 0; i < 16; i++)
+		TEST_CHECK(out[i] == 0x200 + i);
+}
+
+/*
+ * @name	Test_Flush
+ * @brief	Flush drops the elements, the FIFO keeps working afterwards
+ */
+static void Test_Flush(void)
+{
+	Small_FifoType fifo;
+	uint8_t value, i;
+
+	Small_Init(&fifo);
+	Small_Flush(&fifo);
+	TEST_CHECK(Small_Count(&fifo) == 0);
+
+	for(i = 0; i < 5; i++)
+		Small_Put(&fifo, i);
+	Small_Flush(&fifo);
+	TEST_CHECK(Small_Count(&fifo) == 0);
+	TEST_CHECK(Small_Free(&fifo) == 8);
+	TEST_CHECK(Small_Get(&fifo, &value) == 0x01);
+
+	//Full and across the wrap of the buffer
+	for(i = 0; i < 8; i++)
+		TEST_CHECK(Small_Put(&fifo, 10 + i) == 0x00);
+	Small_Flush(&fifo);
+	TEST_CHECK(Small_Free(&fifo) == 8);
+	TEST_CHECK(Small_Put(&fifo, 0x42) == 0x00);
+	TEST_CHECK((Small_Get(&fifo, &value) == 0x00) && (value == 0x42));
+	TEST_CHECK(Small_Get(&fifo, &value) == 0x01);
+}
+
+int main(void)
+{
+	Test_SizeOne();
+	Test_SizeMax();
+	Test_IndexWrap();
+	Test_PeekWrap();
+	Test_PartialCopy();
+	Test_Flush();
+
+	return TEST_RESULT("fifo_test");
+}
@@ -0,0 +1,539 @@
+/**
+  ******************************************************************************
+  * @file    model_test.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Host test of the drivers through the register models of host/
+  *			 + USART_CalculateBaud(): UBRRn/U2Xn, error and tolerance of the three modes
+  *			 + USART receive ISR: FEn/DORn/UPEn of the model reach the hook and the statistics
+  *			 + TWI master: address and data on the bus, NACK of the address, device discovery
+  *			 + I2C print stream: one transmission per print_to(), cut at the buffer and at 255 characters
+  *			 + frame.c: payloads sent and received back through the loopback, a corrupted frame
+  *			 + idle line frames: a timeout of a multiple of 256 Timer2 ticks does not close the frame early
+  *			 + modbus_rtu.c: requests in, responses with a correct CRC out, exceptions, broadcast
+  *			 + scheduler.c: priorities out of range are refused, not wrapped into another task
+  *			 + memory_usage.c: heap and stack peaks of the SRAM model, the guard check and its hook
+  * @note	 Built against the host library and run with "make test", the exit code is 1 when a
+  *			 check fails. The ISRs run only in Host_ServiceInterrupts().
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+#include "host_model.h"
+#include "atmega644p_usart.h"
+#include "atmega644p_i2c.h"
+#include "frame.h"
+#include "modbus_rtu.h"
+#include "crc16.h"
+#include "printf_code.h"
+#include "scheduler.h"
+#include "memory_usage.h"
+#include "test.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define TEST_MODBUS_ADDRESS		17
+#define TEST_MODBUS_WAIT		(F_CPU / 100UL)		// 10ms of Timer cycles: t3.5 at 9600 baud and the response
+
+/* Global Variables ----------------------------------------------------------*/
+static uint16_t gTest_Words[8];
+static uint8_t gTest_WordCount;
+static uint8_t gTest_FramesReady;
+
+static uint16_t gTest_Holding[4] = { 100, 101, 102, 103 };
+static const uint16_t gTest_Input[2] = { 7, 8 };
+static uint8_t gTest_Coils[1] = { 0xA5 };
+static uint8_t gTest_Written;
+static uint8_t gTest_TaskRuns;
+static uint8_t gTest_Collisions;
+static uint16_t gTest_FreeLeft;
+
+/* Functions -----------------------------------------------------------------*/
+
+static void Test_ReceiveHook(uint8_t port, uint16_t data)
+{
+	(void)port;
+	if(gTest_WordCount < sizeof(gTest_Words) / sizeof(gTest_Words[0]))
+		gTest_Words[gTest_WordCount++] = data;
+}
+
+static void Test_FrameReady(uint8_t port)
+{
+	(void)port;
+	gTest_FramesReady++;
+}
+
+static void Test_ModbusWritten(uint8_t function, uint16_t address, uint16_t count)
+{
+	(void)function;
+	(void)address;
+	(void)count;
+	gTest_Written++;
+}
+
+static void Test_Task(void)
+{
+	gTest_TaskRuns++;
+}
+
+static void Test_Collision(uint16_t left)
+{
+	gTest_Collisions++;
+	gTest_FreeLeft = left;
+}
+
+/*
+ * @name	Test_CalculateBaud
+ * @brief	Values of the ATmega644P datasheet tables at 16MHz
+ */
+static void Test_CalculateBaud(void)
+{
+	USART_BaudType baud;
+
+	TEST_CHECK(USART_CalculateBaud(19200, ASYNCHRONOUS, &baud) == 0x00);
+	TEST_CHECK((baud.UBRR == 51) && (baud.DoubleSpeed == 0) && (baud.BaudRate == 19231) && (baud.Error == 16));
+
+	//115200: U2X is closer (+2.1% instead of -3.5%) but still out of the double speed tolerance
+	TEST_CHECK(USART_CalculateBaud(115200, ASYNCHRONOUS, &baud) == 0x01);
+	TEST_CHECK((baud.UBRR == 16) && (baud.DoubleSpeed == 1) && (baud.Error == 212));
+
+	TEST_CHECK(USART_CalculateBaud(250000, ASYNCHRONOUS, &baud) == 0x00);
+	TEST_CHECK((baud.UBRR == 3) && (baud.DoubleSpeed == 0) && (baud.Error == 0));
+	TEST_CHECK(USART_CalculateBaud(2000000, ASYNCHRONOUS, &baud) == 0x00);
+	TEST_CHECK((baud.UBRR == 0) && (baud.DoubleSpeed == 1));
+	TEST_CHECK(USART_CalculateBaud(3000000, ASYNCHRONOUS, &baud) == 0x01);
+
+	TEST_CHECK(USART_CalculateBaud(19200, DOUBLESPEEDASYNC, &baud) == 0x00);
+	TEST_CHECK((baud.UBRR == 103) && (baud.DoubleSpeed == 1));
+	TEST_CHECK(USART_CalculateBaud(300, DOUBLESPEEDASYNC, &baud) == 0x01);		// UBRRn is 12 bits
+
+	TEST_CHECK(USART_CalculateBaud(1000000, SYNCRONOUS, &baud) == 0x00);
+	TEST_CHECK((baud.UBRR == 7) && (baud.Error == 0));
+
+	TEST_CHECK(USART_CalculateBaud(0, ASYNCHRONOUS, &baud) == 0x02);
+}
+
+/*
+ * @name	Test_ReceiveErrors
+ * @brief	Error bits of the model are reported with the data and counted
+ */
+static void Test_ReceiveErrors(void)
+{
+	USART_StructureType config = { 115200, NOPARITY, ONESTOPBIT, EIGHT, ASYNCHRONOUS, BOTH };
+	USART_StatisticsType statistics;
+
+	HostUSART_Reset(USART0);
+	USARTInit(USART0, config);
+	USART_ResetStatistics(USART0);
+	USART_EnableInterrupt(RECEIVE);
+	USART_RegisterReceiveHook(USART0, Test_ReceiveHook);
+	gTest_WordCount = 0;
+
+	HostUSART_ReceiveWord(USART0, 'a');
+	HostUSART_ReceiveWord(USART0, 'b' | HOST_USART_RX_FRAME_ERROR);
+	HostUSART_ReceiveWord(USART0, 'c' | HOST_USART_RX_OVERRUN | HOST_USART_RX_PARITY_ERROR);
+	HostUSART_ReceiveWord(USART0, 'd');
+	Host_ServiceInterrupts();
+
+	TEST_CHECK(gTest_WordCount == 4);
+	TEST_CHECK(gTest_Words[0] == 'a');
+	TEST_CHECK(gTest_Words[1] == ('b' | USART_RX_FRAME_ERROR));
+	TEST_CHECK(gTest_Words[2] == ('c' | USART_RX_OVERRUN | USART_RX_PARITY_ERROR));
+	TEST_CHECK(gTest_Words[3] == 'd');
+	TEST_CHECK((gTest_Words[3] & USART_RX_ERRORS) == 0);
+
+	USART_GetStatistics(USART0, &statistics);
+	TEST_CHECK(statistics.Received == 4);
+	TEST_CHECK(statistics.FrameErrors == 1);
+	TEST_CHECK(statistics.Overruns == 1);
+	TEST_CHECK(statistics.ParityErrors == 1);
+	TEST_CHECK(statistics.BufferOverflows == 0);
+
+	USART_ResetStatistics(USART0);
+	USART_GetStatistics(USART0, &statistics);
+	TEST_CHECK(statistics.Received == 0);
+	USART_RegisterReceiveHook(USART0, NULL);
+}
+
+/*
+ * @name	Test_TWIMaster
+ * @brief	Master transmitter: START, SLA+W and the data, then a NACK of the address
+ */
+static void Test_TWIMaster(void)
+{
+	static const HostTWI_EventType write[] = { { 0x08, 0 }, { 0x18, 0 }, { 0x28, 0 }, { 0x28, 0 }, { 0x28, 0 }, { 0xF8, 0 } };
+	static const HostTWI_EventType nack[] = { { 0x08, 0 }, { 0x20, 0 }, { 0xF8, 0 } };
+	I2C_StructureType i2c;
+	uint8_t bus[16];
+
+	I2C_InitStructureDefault(&i2c);
+	TEST_CHECK(I2CInit(&i2c) == 0x00);
+	HostTWI_Transmitted(bus, sizeof(bus));
+
+	I2C_UpdateSlaveAddress(0x39);
+	I2C_TransmitBufferFill("BUG");
+	HostTWI_Load(write, sizeof(write) / sizeof(write[0]));
+	I2C_StartCommunication();
+	Host_ServiceInterrupts();
+
+	//TWDR at every operation: its value at the START, SLA+W, the data, then the last byte again at the STOP
+	TEST_CHECK(HostTWI_Transmitted(bus, sizeof(bus)) == 6);
+	TEST_CHECK((bus[1] == (0x39 << 1)) && (bus[2] == 'B') && (bus[3] == 'U') && (bus[4] == 'G'));
+	TEST_CHECK(HostTWI_Remaining() == 0);
+	TEST_CHECK(I2C_GetCommunicationError() == 0x00);
+
+	I2C_FlushTransmitBuffer();
+	I2C_TransmitBufferFill("X");
+	HostTWI_Load(nack, sizeof(nack) / sizeof(nack[0]));
+	I2C_StartCommunication();
+	Host_ServiceInterrupts();
+	TEST_CHECK(I2C_GetCommunicationError() == 0x10);		// also printed on the console
+	TEST_CHECK(HostTWI_Remaining() == 0);
+	Host_ServiceInterrupts();
+}
+
+/*
+ * @name	Test_I2CStream
+ * @brief	A print_to() longer than the buffer is cut, never sent as a second transmission during the first
+ */
+static void Test_I2CStream(void)
+{
+	static const HostTWI_EventType write[] = { { 0x08, 0 }, { 0x18, 0 }, { 0x28, 0 }, { 0x28, 0 }, { 0x28, 0 }, { 0x28, 0 },
+											   { 0x28, 0 }, { 0x28, 0 }, { 0x28, 0 }, { 0x28, 0 }, { 0xF8, 0 } };
+	static char text[I2C_MAX_TRANSMIT_LENGTH + 2];
+	Print_StreamType stream;
+	I2C_StructureType i2c;
+	char buffer[9];
+	uint8_t bus[16];
+
+	I2C_InitStructureDefault(&i2c);
+	I2CInit(&i2c);
+	I2C_UpdateSlaveAddress(0x39);
+	HostTWI_Transmitted(bus, sizeof(bus));
+
+	Print_I2CStream(&stream, buffer, sizeof(buffer));
+	HostTWI_Load(write, sizeof(write) / sizeof(write[0]));
+	TEST_CHECK(print_to(&stream, "0123456789ABCDEF%d", (int32_t)42) == 18);		// dropped characters counted
+	Host_ServiceInterrupts();
+	TEST_CHECK(HostTWI_Transmitted(bus, sizeof(bus)) == 11);						// START, SLA+W, 8 bytes, STOP
+	TEST_CHECK((bus[1] == (0x39 << 1)) && (memcmp(&bus[2], "01234567", 8) == 0));
+	TEST_CHECK(HostTWI_Remaining() == 0);
+
+	//The transmit buffer takes upto 255 characters
+	memset(text, 'x', I2C_MAX_TRANSMIT_LENGTH + 1);
+	text[I2C_MAX_TRANSMIT_LENGTH + 1] = '\0';
+	TEST_CHECK(I2C_TransmitBufferFill(text) == 0x11);
+	text[I2C_MAX_TRANSMIT_LENGTH] = '\0';
+	TEST_CHECK(I2C_TransmitBufferFill(text) == 0x00);
+	I2C_FlushTransmitBuffer();
+}
+
+/*
+ * @name	Test_TWIDiscovery
+ * @brief	START, SLA+W and STOP for every address except the own one, the ACKed ones are printed
+ */
+static void Test_TWIDiscovery(void)
+{
+	USART_StructureType config = { 19200, NOPARITY, ONESTOPBIT, EIGHT, ASYNCHRONOUS, BOTH };
+	static HostTWI_EventType events[3 * TOTAL_POSSIBLE_DEVICES];
+	static char text[HOST_USART_FIFO_SIZE + 1];
+	uint16_t count = 0, length, i;
+	uint8_t address;
+
+	for(address = 0; address < TOTAL_POSSIBLE_DEVICES; address++)
+	{
+		if(I2C_UpdateSlaveAddress(address) != 0x00)
+			continue;		// not addressed by the discovery either
+		events[count++].Status = 0x08;
+		events[count++].Status = ((address == 0x39) || (address == 0x7A)) ? 0x18 : 0x20;
+		events[count++].Status = 0xF8;
+	}
+	TEST_CHECK(count > 3 * (TOTAL_POSSIBLE_DEVICES - 8));
+
+	HostTWI_Load(events, count);
+	TEST_CHECK(I2C_DiscoverConnectedDevices() == 0x00);
+	TEST_CHECK(HostTWI_Remaining() == 0);
+
+	//The model keeps the latest output: the last rows of the table
+	USARTInit(USART0, config);
+	HostUSART_Transmitted(USART0, (uint8_t *)text, HOST_USART_FIFO_SIZE);
+	TEST_CHECK(I2C_PrintDescoveredDevices() == 0x00);
+	Host_ServiceInterrupts();
+	length = HostUSART_Transmitted(USART0, (uint8_t *)text, HOST_USART_FIFO_SIZE);
+	text[length] = '\0';
+	TEST_CHECK(strstr(text, "0x7a") != NULL);
+	TEST_CHECK(strstr(text, "0x7b") == NULL);
+
+	for(i = 1; i < count; i += 3)
+		events[i].Status = 0x20;
+	HostTWI_Load(events, count);
+	TEST_CHECK(I2C_DiscoverConnectedDevices() == 0x0D);
+	TEST_CHECK(HostTWI_Remaining() == 0);
+}
+
+/*
+ * @name	Test_FrameRoundTrip
+ * @brief	Every length upto FRAME_MAX_PAYLOAD, with and without zeros, comes back unchanged
+ */
+static void Test_FrameRoundTrip(void)
+{
+	USART_StructureType config = { 115200, NOPARITY, ONESTOPBIT, EIGHT, ASYNCHRONOUS, BOTH };
+	static const uint8_t broken[] = { 0x03, 'a', 'b', 0x02, 'c', FRAME_DELIMITER };
+	Frame_StatisticsType statistics;
+	uint8_t payload[FRAME_MAX_PAYLOAD], wire[2 * FRAME_MAX_PAYLOAD];
+	const uint8_t *received;
+	uint16_t length, i;
+	uint8_t size, pattern, zeros, got;
+
+	HostUSART_Reset(USART1);
+	USARTInit(USART1, config);
+	USART_EnableInterrupt(RECEIVE);
+	sei();
+	HostUSART_Loopback(USART1, 1);
+	Frame_Init(USART1, Test_FrameReady);
+	gTest_FramesReady = 0;
+
+	for(pattern = 0; pattern < 3; pattern++)
+	{
+		for(size = 1; size <= FRAME_MAX_PAYLOAD; size++)
+		{
+			for(i = 0; i < size; i++)
+				payload[i] = (pattern == 0) ? 0x00 : (pattern == 1) ? (uint8_t)(1 + i) : (uint8_t)(i * 37);
+
+			TEST_CHECK(Frame_Send(USART1, payload, size, NULL) == 0x00);
+			Host_ServiceInterrupts();
+
+			length = HostUSART_Transmitted(USART1, wire, sizeof(wire));
+			for(i = 0, zeros = 0; i + 1 < length; i++)
+				zeros += (wire[i] == FRAME_DELIMITER);
+			TEST_CHECK((length > size) && (wire[length - 1] == FRAME_DELIMITER) && (zeros == 0));
+
+			received = Frame_Receive(USART1, &got);
+			TEST_CHECK((received != NULL) && (got == size) && (memcmp(received, payload, size) == 0));
+			Frame_Release(USART1);
+		}
+	}
+	TEST_CHECK(Frame_Send(USART1, payload, 0, NULL) == 0x02);
+	TEST_CHECK(gTest_FramesReady == 3 * FRAME_MAX_PAYLOAD);
+
+	HostUSART_Loopback(USART1, 0);
+	HostUSART_Receive(USART1, broken, sizeof(broken));
+	Host_ServiceInterrupts();
+	TEST_CHECK(Frame_Receive(USART1, &got) == NULL);
+
+	Frame_GetStatistics(USART1, &statistics);
+	TEST_CHECK(statistics.Received == 3 * FRAME_MAX_PAYLOAD);
+	TEST_CHECK((statistics.CRCErrors == 1) && (statistics.Overflows == 0) && (statistics.Dropped == 0));
+	USART_RegisterReceiveHook(USART1, NULL);
+}
+
+/*
+ * @name	Test_IdleTimeout
+ * @brief	One byte closes a frame after the timeout, also when the timeout is 256 and 512 ticks of Timer2
+ */
+static void Test_IdleTimeout(void)
+{
+	USART_StructureType config = { 115200, NOPARITY, ONESTOPBIT, EIGHT, ASYNCHRONOUS, BOTH };
+	static const uint16_t timeouts[3] = { 1000, 2040, 4088 };	// us: 126, 256 and 512 ticks before the extra tick
+	uint8_t buffer0[4], buffer1[4], status, byte = 0x5A;
+	const uint8_t *received;
+	uint16_t length;
+	uint64_t start;
+	uint8_t i;
+
+	HostUSART_Reset(USART1);
+	USARTInit(USART1, config);
+	USART_EnableInterrupt(RECEIVE);
+	sei();
+
+	for(i = 0; i < 3; i++)
+	{
+		USART_EnableIdleFrames(USART1, buffer0, buffer1, sizeof(buffer0), timeouts[i], Test_FrameReady);
+		gTest_FramesReady = 0;
+		HostUSART_Receive(USART1, &byte, 1);
+		Host_ServiceInterrupts();
+
+		start = HostTimer_Cycles();
+		while((gTest_FramesReady == 0) && (HostTimer_Cycles() - start < 4UL * timeouts[i] * (F_CPU / 1000000UL)))
+			Host_ServiceInterrupts();
+		TEST_CHECK(gTest_FramesReady == 1);
+		TEST_CHECK(HostTimer_Cycles() - start >= (uint64_t)timeouts[i] * (F_CPU / 1000000UL) - 128);	// one tick of the arming
+
+		received = USART_ReceiveIdleFrame(USART1, &length, &status);
+		TEST_CHECK((received != NULL) && (length == 1) && (received[0] == byte) && (status == 0));
+		USART_ReleaseIdleFrame(USART1);
+		USART_DisableIdleFrames(USART1);
+	}
+}
+
+/*
+ * @name	Test_ModbusRequest
+ * @brief	Sends a request with its CRC, lets t3.5 and the response pass, returns the response length
+ */
+static uint16_t Test_ModbusRequest(const uint8_t *request, uint8_t length, uint8_t *response, uint16_t size)
+{
+	uint8_t adu[MODBUS_RTU_MAX_ADU];
+	uint16_t crc;
+	uint64_t start;
+
+	memcpy(adu, request, length);
+	crc = CRC16_ModbusCompute(CRC16_MODBUS_INIT, adu, length);
+	adu[length] = crc & 0xFF;
+	adu[length + 1] = crc >> 8;
+	HostUSART_Receive(USART0, adu, length + MODBUS_CRC_SIZE);
+
+	start = HostTimer_Cycles();
+	while(HostTimer_Cycles() - start < TEST_MODBUS_WAIT)
+		Host_ServiceInterrupts();
+	return HostUSART_Transmitted(USART0, response, size);
+}
+
+/*
+ * @name	Test_ModbusRoundTrip
+ * @brief	Read/write of the map, an exception, another slave and a broadcast
+ */
+static void Test_ModbusRoundTrip(void)
+{
+	USART_StructureType config = { 9600, EVENPARITY, ONESTOPBIT, EIGHT, ASYNCHRONOUS, BOTH };
+	static const Modbus_MapType map = { NULL, 0, gTest_Coils, 8, gTest_Input, 2, gTest_Holding, 4, Test_ModbusWritten };
+	static const uint8_t readHolding[] = { TEST_MODBUS_ADDRESS, MODBUS_READ_HOLDING_REGISTERS, 0, 1, 0, 2 };
+	static const uint8_t readInput[] = { TEST_MODBUS_ADDRESS, MODBUS_READ_INPUT_REGISTERS, 0, 0, 0, 2 };
+	static const uint8_t writeRegister[] = { TEST_MODBUS_ADDRESS, MODBUS_WRITE_SINGLE_REGISTER, 0, 3, 0x12, 0x34 };
+	static const uint8_t readCoils[] = { TEST_MODBUS_ADDRESS, MODBUS_READ_COILS, 0, 0, 0, 8 };
+	static const uint8_t outOfMap[] = { TEST_MODBUS_ADDRESS, MODBUS_READ_HOLDING_REGISTERS, 0, 3, 0, 2 };
+	static const uint8_t otherSlave[] = { TEST_MODBUS_ADDRESS + 1, MODBUS_READ_HOLDING_REGISTERS, 0, 0, 0, 1 };
+	static const uint8_t broadcast[] = { MODBUS_BROADCAST_ADDRESS, MODBUS_WRITE_SINGLE_REGISTER, 0, 0, 0, 0x55 };
+	Modbus_StatisticsType statistics;
+	uint8_t response[MODBUS_RTU_MAX_ADU];
+	uint16_t length;
+
+	HostUSART_Reset(USART0);
+	USARTInit(USART0, config);
+	USART_EnableInterrupt(RECEIVE);
+	sei();
+	TEST_CHECK(Modbus_Init(USART0, TEST_MODBUS_ADDRESS, &map) == 0x00);
+	gTest_Written = 0;
+
+	length = Test_ModbusRequest(readHolding, sizeof(readHolding), response, sizeof(response));
+	TEST_CHECK((length == 9) && (CRC16_ModbusCompute(CRC16_MODBUS_INIT, response, length) == 0));
+	TEST_CHECK((response[0] == TEST_MODBUS_ADDRESS) && (response[1] == MODBUS_READ_HOLDING_REGISTERS) && (response[2] == 4));
+	TEST_CHECK((response[3] == 0) && (response[4] == 101) && (response[5] == 0) && (response[6] == 102));
+
+	length = Test_ModbusRequest(readInput, sizeof(readInput), response, sizeof(response));
+	TEST_CHECK((length == 9) && (response[4] == 7) && (response[6] == 8));
+
+	length = Test_ModbusRequest(writeRegister, sizeof(writeRegister), response, sizeof(response));
+	TEST_CHECK((length == 8) && (memcmp(response, writeRegister, sizeof(writeRegister)) == 0));
+	TEST_CHECK((gTest_Holding[3] == 0x1234) && (gTest_Written == 1));
+
+	length = Test_ModbusRequest(readCoils, sizeof(readCoils), response, sizeof(response));
+	TEST_CHECK((length == 6) && (response[2] == 1) && (response[3] == 0xA5));
+
+	length = Test_ModbusRequest(outOfMap, sizeof(outOfMap), response, sizeof(response));
+	TEST_CHECK((length == 5) && (CRC16_ModbusCompute(CRC16_MODBUS_INIT, response, length) == 0));
+	TEST_CHECK((response[1] == (MODBUS_EXCEPTION | MODBUS_READ_HOLDING_REGISTERS)) && (response[2] == MODBUS_ILLEGAL_DATA_ADDRESS));
+
+	TEST_CHECK(Test_ModbusRequest(otherSlave, sizeof(otherSlave), response, sizeof(response)) == 0);
+	TEST_CHECK(Test_ModbusRequest(broadcast, sizeof(broadcast), response, sizeof(response)) == 0);
+	TEST_CHECK((gTest_Holding[0] == 0x55) && (gTest_Written == 2));
+
+	Modbus_GetStatistics(&statistics);
+	TEST_CHECK((statistics.Requests == 6) && (statistics.Exceptions == 1));
+	TEST_CHECK((statistics.CRCErrors == 0) && (statistics.Overruns == 0));
+}
+
+/*
+ * @name	Test_SchedulerRange
+ * @brief	Post/PostDelayed/Cancel/AddTask with priority SCHEDULER_MAX_TASKS return 0x01 and change nothing
+ */
+static void Test_SchedulerRange(void)
+{
+	Scheduler_Init();
+	gTest_TaskRuns = 0;
+	TEST_CHECK(Scheduler_AddTask(0, Test_Task) == 0x00);
+	TEST_CHECK(Scheduler_AddTask(SCHEDULER_MAX_TASKS, Test_Task) == 0x01);
+
+	TEST_CHECK(Scheduler_Post(SCHEDULER_MAX_TASKS) == 0x01);
+	TEST_CHECK(Scheduler_PostDelayed(SCHEDULER_MAX_TASKS, SCHEDULER_NO_DELAY) == 0x01);
+	TEST_CHECK(Scheduler_RunOnce() == 0x00);
+
+	TEST_CHECK(Scheduler_Post(0) == 0x00);
+	TEST_CHECK(Scheduler_Cancel(SCHEDULER_MAX_TASKS) == 0x01);
+	TEST_CHECK((Scheduler_RunOnce() == 0x01) && (gTest_TaskRuns == 1));
+
+	TEST_CHECK(Scheduler_PostDelayed(0, SCHEDULER_NO_DELAY) == 0x00);
+	TEST_CHECK(Scheduler_Cancel(0) == 0x00);
+	TEST_CHECK((Scheduler_RunOnce() == 0x00) && (gTest_TaskRuns == 1));
+}
+
+/*
+ * @name	Test_MemoryUsage
+ * @brief	Heap and stack now and at their peak, after both have grown and shrunk again
+ */
+static void Test_MemoryUsage(void)
+{
+	Memory_UsageType usage;
+
+	HostSRAM_Use(100, 200);
+	Memory_Init(NULL);
+	Memory_GetUsage(&usage);
+	TEST_CHECK(usage.Break == (uint16_t)(uintptr_t)HostSRAM_Break());
+	TEST_CHECK((usage.HeapUsed == 100) && (usage.HeapPeak == 100));
+	TEST_CHECK((usage.StackUsed == 200) && (usage.StackPeak == 200));
+	TEST_CHECK((usage.Free == HOST_SRAM_SIZE - 300) && (usage.Untouched == HOST_SRAM_SIZE - 300));
+	TEST_CHECK(usage.Collided == 0);
+
+	//The given back bytes keep what the heap and the pushes wrote
+	HostSRAM_Use(150, 300);
+	HostSRAM_Use(100, 200);
+	Memory_GetUsage(&usage);
+	TEST_CHECK((usage.HeapUsed == 100) && (usage.HeapPeak == 150));
+	TEST_CHECK((usage.StackUsed == 200) && (usage.StackPeak == 300));
+	TEST_CHECK((usage.Free == HOST_SRAM_SIZE - 300) && (usage.Untouched == HOST_SRAM_SIZE - 450));
+}
+
+/*
+ * @name	Test_MemoryCheck
+ * @brief	The guard above the heap: intact upto the stack, an overwritten byte is reported once
+ */
+static void Test_MemoryCheck(void)
+{
+	uint16_t stack = HOST_SRAM_SIZE - 100 - MEMORY_GUARD_SIZE - 8;	// 8 bytes between the guard and SP
+	Memory_UsageType usage;
+
+	HostSRAM_Use(100, 200);
+	Memory_Init(Test_Collision);
+	gTest_Collisions = 0;
+	TEST_CHECK(Memory_Check() == 0x00);
+	HostSRAM_Use(100, stack);
+	TEST_CHECK(Memory_Check() == 0x00);
+	TEST_CHECK(gTest_Collisions == 0);
+
+	HostSRAM_HeapStart()[100 + MEMORY_GUARD_SIZE / 2] = 0x00;
+	TEST_CHECK(Memory_Check() == 0x01);
+	TEST_CHECK((gTest_Collisions == 1) && (gTest_FreeLeft == MEMORY_GUARD_SIZE + 8));
+	TEST_CHECK(Memory_Check() == 0x01);
+	TEST_CHECK(gTest_Collisions == 1);
+	Memory_GetUsage(&usage);
+	TEST_CHECK(usage.Collided == 1);
+	HostSRAM_Use(0, 0);
+}
+
+int main(void)
+{
+	Test_CalculateBaud();
+	Test_ReceiveErrors();
+	Test_TWIMaster();
+	Test_I2CStream();
+	Test_TWIDiscovery();
+	Test_FrameRoundTrip();
+	Test_IdleTimeout();
+	Test_ModbusRoundTrip();
+	Test_SchedulerRange();
+	Test_MemoryUsage();
+	Test_MemoryCheck();
+
+	return TEST_RESULT("model_test");
+}
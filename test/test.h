@@ -0,0 +1,39 @@
+/**
+  ******************************************************************************
+  * @file    test.h
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Checks of the host tests of test/, one test program per source file
+  * @note	 A failed check is printed with its file, line and condition, the test goes on.
+  *			 TEST_RESULT() prints the totals and gives the exit code of main().
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TEST_H
+#define __TEST_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+/* Global Variables ----------------------------------------------------------*/
+static unsigned gTest_Checks;
+static unsigned gTest_Failures;
+
+/* Exported macro ------------------------------------------------------------*/
+#define TEST_CHECK(condition)																\
+	do																						\
+	{																						\
+		gTest_Checks++;																		\
+		if(!(condition))																	\
+		{																					\
+			gTest_Failures++;																\
+			printf("%s:%d: %s: check failed: %s\n", __FILE__, __LINE__, __func__, #condition);	\
+		}																					\
+	}while(0)
+
+//Last statement of main(): return TEST_RESULT("fifo_test");
+#define TEST_RESULT(name)		(printf("%s: %u checks, %u failed\n", (name), gTest_Checks, gTest_Failures), (gTest_Failures > 0) ? 1 : 0)
+
+#endif // __TEST_H
@@ -0,0 +1,190 @@
+/**
+  ******************************************************************************
+  * @file    mux_demux.c
+  * @author  Basavaraju B V
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Host side demultiplexer of the logical channels of mux.c
+  *			 Splits the byte stream of the debug USART at the 0x00 delimiters, decodes the
+  *			 COBS blocks, checks the CRC16/CCITT (common/crc16.c) and hands the data to its channel.
+  * @note	 Usage: mux_demux [-c channel] [file]
+  *			 + without -c: the text of every channel, one line per output line with the
+  *			   channel in front, non printable bytes as \xHH
+  *			 + -c channel: the raw bytes of one channel only (e.g. binary telemetry to a parser)
+  *			 file is a capture or the serial device (configured with stty), stdin without it.
+  *			 Frames and CRC errors are counted on stderr at the end.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "crc16.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define DEMUX_MAX_FRAME			256			// decoded bytes: channel, data and CRC
+#define DEMUX_MAX_CHANNELS		256
+#define DEMUX_MAX_LINE			256
+#define DEMUX_CRC_SIZE			2			// CRC high byte, low byte
+#define DEMUX_ALL_CHANNELS		-1
+
+/* Typedefs and structure ----------------------------------------------------*/
+typedef struct
+{
+	char		Line[DEMUX_MAX_LINE];
+	uint16_t	Length;
+	uint32_t	Frames;
+}Demux_ChannelType;
+
+/* Global Variables ----------------------------------------------------------*/
+static Demux_ChannelType gDemux_Channel[DEMUX_MAX_CHANNELS];
+static uint32_t gDemux_Errors;
+
+/* Functions -----------------------------------------------------------------*/
+
+/*
+ * @name	Demux_FlushLine
+ * @brief	Prints the pending line of a channel
+ */
+static void Demux_FlushLine(int channel)
+{
+	Demux_ChannelType *demux = &gDemux_Channel[channel];
+
+	if(demux->Length == 0)
+		return;
+	printf("ch%d| %.*s\n", channel, demux->Length, demux->Line);
+	demux->Length = 0;
+}
+
+/*
+ * @name	Demux_Text
+ * @brief	Adds the data of a frame to the line of its channel
+ */
+static void Demux_Text(int channel, const uint8_t *data, int length)
+{
+	Demux_ChannelType *demux = &gDemux_Channel[channel];
+	int i;
+
+	for(i = 0; i < length; i++)
+	{
+		if(demux->Length > DEMUX_MAX_LINE - 4)
+			Demux_FlushLine(channel);
+
+		if(data[i] == '\n')
+			Demux_FlushLine(channel);
+		else if(data[i] == '\r')
+			;
+		else if((data[i] >= 0x20) && (data[i] < 0x7F))
+			demux->Line[demux->Length++] = data[i];
+		else
+			demux->Length += sprintf(&demux->Line[demux->Length], "\\x%02X", data[i]);
+	}
+}
+
+/*
+ * @name	Demux_Frame
+ * @brief	Checks a decoded frame and gives its data to the output
+ */
+static void Demux_Frame(const uint8_t *frame, int length, int selected)
+{
+	if(length < 1 + 1 + DEMUX_CRC_SIZE || CRC16_Compute(CRC16_CCITT_INIT, frame, length) != CRC16_CCITT_RESIDUE)
+	{
+		gDemux_Errors++;
+		return;
+	}
+	length -= DEMUX_CRC_SIZE;
+	gDemux_Channel[frame[0]].Frames++;
+
+	if(selected == DEMUX_ALL_CHANNELS)
+		Demux_Text(frame[0], &frame[1], length - 1);
+	else if(selected == frame[0])
+		fwrite(&frame[1], 1, length - 1, stdout);
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *input = stdin;
+	uint8_t frame[DEMUX_MAX_FRAME];
+	int length = 0, remaining = 0, code = 0xFF, broken = 0;
+	int selected = DEMUX_ALL_CHANNELS;
+	int i, data;
+
+	for(i = 1; i < argc; i++)
+	{
+		if((strcmp(argv[i], "-c") == 0) && (i + 1 < argc))
+		{
+			selected = atoi(argv[++i]);
+		}
+		else if(input == stdin)
+		{
+			input = fopen(argv[i], "rb");
+			if(input == NULL)
+			{
+				perror(argv[i]);
+				return 1;
+			}
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [-c channel] [file]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	//COBS decoding as Frame_ReceiveHook() of frame.c
+	while((data = fgetc(input)) != EOF)
+	{
+		if(data == 0x00)
+		{
+			if(length != 0)
+			{
+				if(broken || (remaining != 0))
+					gDemux_Errors++;
+				else
+					Demux_Frame(frame, length, selected);
+			}
+			length = 0;
+			remaining = 0;
+			code = 0xFF;
+			broken = 0;
+			if(selected != DEMUX_ALL_CHANNELS)
+				fflush(stdout);
+			continue;
+		}
+		if(length >= DEMUX_MAX_FRAME - 1)
+		{
+			broken = 1;
+			continue;
+		}
+		if(remaining == 0)
+		{
+			if(code != 0xFF)
+				frame[length++] = 0x00;
+			code = data;
+			remaining = code - 1;
+		}
+		else
+		{
+			frame[length++] = data;
+			remaining--;
+		}
+	}
+
+	if(selected == DEMUX_ALL_CHANNELS)
+	{
+		for(i = 0; i < DEMUX_MAX_CHANNELS; i++)
+			Demux_FlushLine(i);
+	}
+	for(i = 0; i < DEMUX_MAX_CHANNELS; i++)
+	{
+		if(gDemux_Channel[i].Frames)
+			fprintf(stderr, "channel %d: %u frames\n", i, gDemux_Channel[i].Frames);
+	}
+	fprintf(stderr, "errors: %u frames\n", gDemux_Errors);
+
+	if(input != stdin)
+		fclose(input);
+	return 0;
+}